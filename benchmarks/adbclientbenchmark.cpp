@@ -0,0 +1,208 @@
+#include "adbclientbenchmark.h"
+#include "adbclient.h"
+#include "adbreply.h"
+#include "adbshellsession.h"
+#include "fakeadbserver.h"
+#include <QTest>
+#include <QSignalSpy>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+constexpr int PACKAGES = 2000;
+constexpr int SHELL_COMMANDS = 50;
+constexpr int TIMEOUT_MS = 10000;
+const char *const SERIAL = "fake-0001";
+
+struct Result {
+    bool finished = false;
+    AdbReply::Error error = AdbReply::NoError;
+    QString errorString;
+    QByteArray output;
+    bool usedFallback = false;
+};
+
+// Waits for the reply, then deletes it
+Result collect(AdbReply *reply)
+{
+    Result result;
+    QSignalSpy finished(reply, &AdbReply::finished);
+    result.finished = reply->isFinished() || finished.wait(TIMEOUT_MS);
+    result.error = reply->error();
+    result.errorString = reply->errorString();
+    result.output = reply->output();
+    result.usedFallback = reply->usedFallback();
+    delete reply;
+    return result;
+}
+
+bool waitForCount(QSignalSpy &spy, int count)
+{
+    while (spy.count() < count) {
+        if (!spy.wait(TIMEOUT_MS)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasFakeAdb()
+{
+#ifdef FAKE_ADB_PATH
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+void AdbClientBenchmark::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    // No latency, so the rows measure the transport and not the scenario
+    QString path = dir.filePath("adbclient.json");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(QJsonObject {
+        { "devices", 1 },
+        { "packages", PACKAGES },
+        { "latencyMs", 0 },
+        { "jitterMs", 0 }
+    }).toJson());
+    file.close();
+    // fake-adb reads the same scenario
+    qputenv("SCRCPY_GUI_FAKE_SCENARIO", path.toLocal8Bit());
+
+    Scenario scenario;
+    QString error;
+    QVERIFY2(scenario.load(path, &error), qPrintable(error));
+    server = new FakeAdbServer(scenario, this);
+    QVERIFY2(server->listen(), qPrintable(server->errorString()));
+}
+
+void AdbClientBenchmark::configure(AdbClient &client, bool useServer) const
+{
+    client.setServerAddress("127.0.0.1", server->port());
+    client.setServerEnabled(useServer);
+#ifdef FAKE_ADB_PATH
+    client.setProgram(FAKE_ADB_PATH);
+#endif
+}
+
+void AdbClientBenchmark::protocol()
+{
+    QCOMPARE(AdbClient::encodeRequest("host:version"), QByteArray("000chost:version"));
+
+    AdbClient client;
+    configure(client, true);
+
+    Result version = collect(client.hostQuery("host:version", { "version" }));
+    QVERIFY(version.finished);
+    QCOMPARE(version.error, AdbReply::NoError);
+    QVERIFY(!version.usedFallback);
+    QCOMPARE(version.output, QByteArray("0029"));
+
+    Result devices = collect(client.hostQuery("host:devices-l", { "devices", "-l" }));
+    QCOMPARE(devices.error, AdbReply::NoError);
+    QVERIFY(devices.output.startsWith("List of devices attached\n" + QByteArray(SERIAL)));
+
+    // FAIL<len><message> from host:transport and from an unknown service
+    Result missing = collect(client.shell("missing-device", "id"));
+    QVERIFY(missing.finished);
+    QCOMPARE(missing.error, AdbReply::ServiceError);
+    QCOMPARE(missing.errorString, QString("device 'missing-device' not found"));
+
+    Result unknown = collect(client.hostQuery("host:bogus", { "bogus" }));
+    QCOMPARE(unknown.error, AdbReply::ServiceError);
+    QCOMPARE(unknown.errorString, QString("unknown host service"));
+
+    // Output is read until the device side closes the stream
+    Result packages = collect(client.exec(SERIAL, "pm list packages -3"));
+    QCOMPARE(packages.error, AdbReply::NoError);
+    QCOMPARE(int(packages.output.count("package:")), PACKAGES);
+
+    Result any = collect(client.shell(QString(), "pm list packages -3"));
+    QCOMPARE(any.error, AdbReply::NoError);
+    QCOMPARE(any.output, packages.output);
+}
+
+void AdbClientBenchmark::query_data()
+{
+    QTest::addColumn<bool>("useServer");
+    QTest::addColumn<QString>("query");
+    for (const char *query : { "devices", "shell", "exec" }) {
+        QTest::addRow("%s/server", query) << true << QString(query);
+        QTest::addRow("%s/process", query) << false << QString(query);
+    }
+}
+
+void AdbClientBenchmark::query()
+{
+    QFETCH(bool, useServer);
+    QFETCH(QString, query);
+    if (!useServer && !hasFakeAdb()) {
+        QSKIP("fake-adb not built; configure with -DSCRCPY_GUI_BUILD_FAKE_TOOLS=ON");
+    }
+
+    AdbClient client;
+    configure(client, useServer);
+    QByteArray expected = query == "devices" ? QByteArray(SERIAL) : QByteArray("package:com.fake.app01999");
+    QBENCHMARK {
+        AdbReply *reply = nullptr;
+        if (query == "devices") {
+            reply = client.hostQuery("host:devices-l", { "devices", "-l" });
+        } else if (query == "shell") {
+            reply = client.shell(SERIAL, "pm list packages -3");
+        } else {
+            reply = client.exec(SERIAL, "pm list packages -3");
+        }
+        Result result = collect(reply);
+        QVERIFY(result.finished);
+        QCOMPARE(result.error, AdbReply::NoError);
+        QCOMPARE(result.usedFallback, !useServer);
+        QVERIFY(result.output.contains(expected));
+    }
+}
+
+void AdbClientBenchmark::shellSession_data()
+{
+    QTest::addColumn<bool>("useServer");
+    QTest::newRow("server") << true;
+    QTest::newRow("process") << false;
+}
+
+void AdbClientBenchmark::shellSession()
+{
+    QFETCH(bool, useServer);
+    if (!useServer && !hasFakeAdb()) {
+        QSKIP("fake-adb not built; configure with -DSCRCPY_GUI_BUILD_FAKE_TOOLS=ON");
+    }
+
+    AdbClient client;
+    configure(client, useServer);
+    AdbShellSession session(&client, SERIAL);
+    QSignalSpy finished(&session, &AdbShellSession::commandFinished);
+    QSignalSpy failed(&session, &AdbShellSession::commandFailed);
+
+    // The shell is opened outside the measurement
+    session.execute("ps -A -o NAME");
+    QVERIFY(waitForCount(finished, 1));
+    int connections = server->connectionCount();
+
+    QBENCHMARK {
+        finished.clear();
+        for (int i = 0; i < SHELL_COMMANDS; ++i) {
+            session.execute("ps -A -o NAME");
+        }
+        QVERIFY(waitForCount(finished, SHELL_COMMANDS));
+    }
+    QCOMPARE(failed.count(), 0);
+    QVERIFY(finished.last().at(1).toByteArray().startsWith("NAME\n"));
+    QCOMPARE(finished.last().at(2).toInt(), 0);
+    // Every command went over the one connection
+    QCOMPARE(server->connectionCount(), connections);
+}
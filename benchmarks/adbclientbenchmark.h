@@ -0,0 +1,32 @@
+#ifndef ADBCLIENTBENCHMARK_H
+#define ADBCLIENTBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class AdbClient;
+class FakeAdbServer;
+
+// AdbClient against FakeAdbServer: the smart-socket protocol itself, then
+// the same queries over the socket and over the process fallback. The
+// process rows run fake-adb, so they need SCRCPY_GUI_BUILD_FAKE_TOOLS=ON.
+class AdbClientBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void protocol();
+    void query_data();
+    void query();
+    void shellSession_data();
+    void shellSession();
+
+private:
+    void configure(AdbClient &client, bool useServer) const;
+
+    QTemporaryDir dir;
+    FakeAdbServer *server = nullptr;
+};
+
+#endif // ADBCLIENTBENCHMARK_H
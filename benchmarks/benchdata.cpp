@@ -0,0 +1,127 @@
+#include "benchdata.h"
+#include "packageparser.h"
+
+namespace {
+
+// Real package names share a few vendor prefixes
+const char *const VENDORS[] = { "com.google.android", "com.samsung", "org.mozilla", "com.example", "net.corp.tools" };
+const char *const WORDS[] = { "mail", "camera", "maps", "notes", "player", "scanner", "wallet", "launcher", "weather",
+                              "fitness" };
+const char *const SUFFIXES[] = { "", "Pro", "Lite", "Go" };
+
+} // namespace
+
+QString BenchData::packageName(int index)
+{
+    return QString("%1.%2.%3%4%5")
+        .arg(QLatin1String(VENDORS[index % 5]), QLatin1String(WORDS[(index / 5) % 10]),
+             QLatin1String(WORDS[(index * 7) % 10]), QLatin1String(SUFFIXES[(index / 3) % 4]))
+        .arg(index);
+}
+
+QByteArray BenchData::pmOutput(int packages)
+{
+    QByteArray out = "serial:bench-0001\nfingerprint:bench/bench:14/UP1A/1:user/release-keys\n";
+    out.reserve(packages * 56);
+    for (int i = 0; i < packages; ++i) {
+        out += "package:" + packageName(i).toLatin1() + " versionCode:" + QByteArray::number(1000 + i) + '\n';
+    }
+    return out;
+}
+
+QByteArray BenchData::psOutput(int processes, int packages, int stride)
+{
+    QByteArray out = "NAME\n";
+    out.reserve(processes * 40);
+    int package = 0;
+    for (int i = 0; i < processes; ++i) {
+        if (i % stride == 0 && package < packages) {
+            out += packageName(package).toLatin1();
+            // Secondary processes count for their package
+            out += (i % (stride * 3) == 0) ? ":remote\n" : "\n";
+            package += stride;
+        } else if (i % 3 == 0) {
+            out += "[kworker/" + QByteArray::number(i % 8) + ":" + QByteArray::number(i) + "]\n";
+        } else {
+            out += "/vendor/bin/hw/android.hardware.service" + QByteArray::number(i) + '\n';
+        }
+    }
+    return out;
+}
+
+QByteArray BenchData::devicesOutput(int devices)
+{
+    QByteArray out = "List of devices attached\n";
+    for (int i = 0; i < devices; ++i) {
+        QByteArray n = QByteArray::number(i + 1);
+        out += "bench-" + n + "           device usb:1-" + n + " product:bench model:Pixel_" + n
+               + " device:bench transport_id:" + n + '\n';
+    }
+    return out;
+}
+
+QByteArray BenchData::scrcpyLog(int lines)
+{
+    QByteArray out = "scrcpy 2.4 <https://github.com/Genymobile/scrcpy>\n"
+                     "/usr/share/scrcpy/scrcpy-server: 1 file pushed, 0 skipped.\n"
+                     "INFO: ADB device found:\n"
+                     "INFO:     -->   (usb)  bench-0001  device  Pixel_7\n"
+                     "[server] INFO: Device: [Google] google Pixel 7 (Android 14)\n"
+                     "[server] INFO: Using video encoder: 'c2.android.avc.encoder'\n"
+                     "[server] INFO: New display: 1080x2400/420 (id=5)\n"
+                     "INFO: Renderer: opengl\n"
+                     "INFO: Texture: 1080x2400\n";
+    out.reserve(lines * 40);
+    for (int i = 9; i < lines; ++i) {
+        // Now and then a line mangled by an interleaved write
+        if (i % 1000 == 999) {
+            out += "INFO: Texture: 10800000000000000000000x2400\n";
+            continue;
+        }
+        switch (i % 10) {
+        case 0:
+            out += "WARN: Device disconnected? retrying\n";
+            break;
+        case 1:
+            out += "[server] DEBUG: frame " + QByteArray::number(i) + " queued\n";
+            break;
+        default:
+            out += "INFO: " + QByteArray::number(55 + i % 6) + " fps (+" + QByteArray::number(i % 3) + " frames skipped)\n";
+            break;
+        }
+    }
+    return out;
+}
+
+QStringList BenchData::packages(int count)
+{
+    QStringList result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result << packageName(i);
+    }
+    return result;
+}
+
+QList<AppInfo> BenchData::apps(int count)
+{
+    QList<AppInfo> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        AppInfo app;
+        app.packageName = packageName(i);
+        app.name = PackageParser::packageToName(app.packageName);
+        app.versionCode = 1000 + i;
+        result << app;
+    }
+    return result;
+}
+
+QSet<QString> BenchData::running(int count, int stride)
+{
+    QSet<QString> result;
+    for (int i = 0; i < count; i += stride) {
+        result.insert(packageName(i));
+    }
+    return result;
+}
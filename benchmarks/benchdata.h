@@ -0,0 +1,30 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QSet>
+#include "appmanager.h"
+
+// Synthetic inputs shaped like what a device farm sends back. Everything is
+// derived from the index, so runs are repeatable without a fixed seed.
+class BenchData
+{
+public:
+    static QString packageName(int index);
+
+    // `pm list packages -3 --show-versioncode` plus AppManager's prefix lines
+    static QByteArray pmOutput(int packages);
+    // `ps -A -o NAME`; every stride-th package is running, rest is system
+    static QByteArray psOutput(int processes, int packages, int stride);
+    static QByteArray devicesOutput(int devices);
+    // A scrcpy session: start-up lines, then FPS reports and warnings
+    static QByteArray scrcpyLog(int lines);
+
+    static QStringList packages(int count);
+    static QList<AppInfo> apps(int count);
+    static QSet<QString> running(int count, int stride);
+};
+
+#endif // BENCHDATA_H
@@ -0,0 +1,81 @@
+// scrcpy-gui-bench: every benchmark suite in one binary.
+//
+//   scrcpy-gui-bench [--json FILE] [--suite NAME] [QTest options]
+//
+// QTest options (e.g. -iterations 10, -median 5) are passed to every
+// suite, or only to the one picked with --suite, which also allows naming
+// test functions. --json writes the results for benchmarks/compare.py.
+
+#include "parserbenchmark.h"
+#include "modelbenchmark.h"
+#include "logbenchmark.h"
+#include "storagebenchmark.h"
+#include "controlbenchmark.h"
+#include "refreshbenchmark.h"
+#include "adbclientbenchmark.h"
+#include "benchreport.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace {
+
+QString takeOption(QStringList &arguments, const QString &name)
+{
+    int index = arguments.indexOf(name);
+    if (index < 0 || index + 1 >= arguments.size()) {
+        return QString();
+    }
+    QString value = arguments.at(index + 1);
+    arguments.remove(index, 2);
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Settings, caches and config files go to throwaway test locations
+    QStandardPaths::setTestModeEnabled(true);
+
+    QStringList arguments = app.arguments();
+    QString jsonPath = takeOption(arguments, "--json");
+    QString onlySuite = takeOption(arguments, "--suite");
+
+    const QList<QObject *> suites = {
+        new ParserBenchmark,
+        new ModelBenchmark,
+        new LogBenchmark,
+        new StorageBenchmark,
+        new ControlBenchmark,
+        new RefreshBenchmark,
+        new AdbClientBenchmark
+    };
+
+    QTemporaryDir xmlDir;
+    QStringList xmlFiles;
+    int failures = 0;
+    for (QObject *suite : suites) {
+        QString name = QString::fromLatin1(suite->metaObject()->className());
+        if (!onlySuite.isEmpty() && name != onlySuite) {
+            continue;
+        }
+
+        QStringList suiteArguments = arguments;
+        if (!jsonPath.isEmpty()) {
+            QString xmlFile = xmlDir.filePath(name + ".xml");
+            suiteArguments << "-o" << xmlFile + ",xml" << "-o" << "-,txt";
+            xmlFiles << xmlFile;
+        }
+        failures += QTest::qExec(suite, suiteArguments);
+    }
+
+    qDeleteAll(suites);
+
+    if (!jsonPath.isEmpty() && !BenchReport::writeJson(xmlFiles, jsonPath)) {
+        return 1;
+    }
+    return failures > 0 ? 1 : 0;
+}
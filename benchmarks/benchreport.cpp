@@ -0,0 +1,63 @@
+#include "benchreport.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <cstdio>
+
+bool BenchReport::writeJson(const QStringList &xmlFiles, const QString &path)
+{
+    QJsonArray benchmarks;
+    for (const QString &xmlFile : xmlFiles) {
+        QFile file(xmlFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        QString testCase;
+        QString function;
+        QXmlStreamReader xml(&file);
+        while (!xml.atEnd()) {
+            if (xml.readNext() != QXmlStreamReader::StartElement) {
+                continue;
+            }
+            QXmlStreamAttributes attributes = xml.attributes();
+            if (xml.name() == QLatin1String("TestCase")) {
+                testCase = attributes.value("name").toString();
+            } else if (xml.name() == QLatin1String("TestFunction")) {
+                function = attributes.value("name").toString();
+            } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+                QString name = testCase + "::" + function;
+                QString tag = attributes.value("tag").toString();
+                if (!tag.isEmpty()) {
+                    name += "/" + tag;
+                }
+                benchmarks.append(QJsonObject {
+                    { "name", name },
+                    { "metric", attributes.value("metric").toString() },
+                    { "value", attributes.value("value").toDouble() },
+                    { "iterations", attributes.value("iterations").toInt() }
+                });
+            }
+        }
+        if (xml.hasError()) {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(xmlFile), qPrintable(xml.errorString()));
+        }
+    }
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        std::fprintf(stderr, "Cannot write %s: %s\n", qPrintable(path), qPrintable(out.errorString()));
+        return false;
+    }
+    out.write(QJsonDocument(QJsonObject {
+        { "version", 1 },
+        { "qt", QString::fromLatin1(qVersion()) },
+        { "date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+        { "benchmarks", benchmarks }
+    }).toJson());
+    return out.commit();
+}
@@ -0,0 +1,19 @@
+#ifndef BENCHREPORT_H
+#define BENCHREPORT_H
+
+#include <QString>
+#include <QStringList>
+
+// Folds the QTest XML logs of every suite into one JSON file that
+// benchmarks/compare.py can diff against a baseline:
+//   {"version":1, "qt":"6.x", "benchmarks":[
+//       {"name":"ParserBenchmark::parsePackageList/50000",
+//        "metric":"WalltimeMilliseconds", "value":3.2, "iterations":16}, ...]}
+// Values are per iteration.
+class BenchReport
+{
+public:
+    static bool writeJson(const QStringList &xmlFiles, const QString &path);
+};
+
+#endif // BENCHREPORT_H
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""Compare two scrcpy-gui-bench --json result files.
+
+    compare.py baseline.json current.json [--threshold PERCENT]
+
+Prints every benchmark that is in both files with its relative change.
+Exits with 1 if any of them got slower by more than the threshold
+(default 10%), so a release script can stop on it.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    return {(b["name"], b["metric"]): b["value"] for b in data.get("benchmarks", [])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default: 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    width = max((len(name) for name, _ in set(baseline) | set(current)), default=0)
+    for key in sorted(current):
+        name, metric = key
+        if key not in baseline:
+            print(f"{name:<{width}}  {current[key]:>12.4f}  (new)")
+            continue
+        old, new = baseline[key], current[key]
+        change = (new - old) / old * 100.0 if old > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<{width}}  {old:>12.4f} -> {new:>12.4f} {metric}  {change:+7.1f}%{flag}")
+
+    for name, metric in sorted(set(baseline) - set(current)):
+        print(f"{name:<{width}}  (missing from {args.current})")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) slower than {args.threshold:g}%", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
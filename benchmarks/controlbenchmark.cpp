@@ -0,0 +1,107 @@
+#include "controlbenchmark.h"
+#include "controlserver.h"
+#include "controlclient.h"
+#include "sessionmanager.h"
+#include <QTest>
+#include <QThread>
+#include <QEventLoop>
+#include <atomic>
+
+namespace {
+
+constexpr int ROUND_TRIPS = 1000;
+constexpr int STRESS_CLIENTS = 8;
+constexpr int STRESS_COMMANDS = 5000;
+
+} // namespace
+
+void ControlBenchmark::initTestCase()
+{
+    sessions = new SessionManager(this);
+    server = new ControlServer(sessions, this);
+    if (!server->listen()) {
+        QSKIP("Another scrcpy-gui instance owns the control socket");
+    }
+}
+
+void ControlBenchmark::cleanupTestCase()
+{
+    delete server;
+    server = nullptr;
+}
+
+bool ControlBenchmark::runClients(int count, const std::function<bool(int)> &client)
+{
+    std::atomic<int> failed { 0 };
+    std::atomic<int> running { count };
+    QEventLoop loop;
+    QList<QThread *> threads;
+    for (int i = 0; i < count; ++i) {
+        QThread *thread = QThread::create([&client, &failed, i]() {
+            if (!client(i)) {
+                failed++;
+            }
+        });
+        connect(thread, &QThread::finished, &loop, [&loop, &running]() {
+            if (--running == 0) {
+                loop.quit();
+            }
+        });
+        threads << thread;
+        thread->start();
+    }
+    loop.exec();
+    qDeleteAll(threads);
+    return failed == 0;
+}
+
+void ControlBenchmark::handle()
+{
+    QByteArray reply;
+    QBENCHMARK {
+        reply = server->handle("sessions");
+    }
+    QVERIFY(reply.contains("\"ok\":true"));
+}
+
+void ControlBenchmark::roundTrip()
+{
+    // What one `--control` call costs: connect, send, answer, close
+    QBENCHMARK {
+        QVERIFY(runClients(1, [](int) {
+            for (int i = 0; i < ROUND_TRIPS; ++i) {
+                QByteArray reply;
+                if (!ControlClient::send("ping", &reply) || !reply.contains("\"ok\":true")) {
+                    return false;
+                }
+            }
+            return true;
+        }));
+    }
+}
+
+void ControlBenchmark::stress()
+{
+    // Every client pipelines its commands on one connection; each must get
+    // exactly its own replies back, in order
+    const QList<QByteArray> mix = { "ping", "sessions", "stop all", "launch com.example.bench", "bogus" };
+    QBENCHMARK_ONCE {
+        QVERIFY(runClients(STRESS_CLIENTS, [&mix](int) {
+            QList<QByteArray> commands;
+            for (int i = 0; i < STRESS_COMMANDS; ++i) {
+                commands << mix.at(i % mix.size());
+            }
+            QList<QByteArray> replies;
+            if (!ControlClient::send(commands, &replies, 30000) || replies.size() != commands.size()) {
+                return false;
+            }
+            for (int i = 0; i < replies.size(); ++i) {
+                bool expectOk = commands.at(i) != "bogus";
+                if (replies.at(i).contains("\"ok\":true") != expectOk) {
+                    return false;
+                }
+            }
+            return true;
+        }));
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef CONTROLBENCHMARK_H
+#define CONTROLBENCHMARK_H
+
+#include <QObject>
+#include <functional>
+
+class SessionManager;
+class ControlServer;
+
+// Control socket dispatch, round trip and a many-client stress run. Skipped
+// when a running scrcpy-gui owns the socket.
+class ControlBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void handle();
+    void roundTrip();
+    void stress();
+
+private:
+    // Clients block, so they run on threads while this one serves
+    bool runClients(int count, const std::function<bool(int)> &client);
+
+    SessionManager *sessions = nullptr;
+    ControlServer *server = nullptr;
+};
+
+#endif // CONTROLBENCHMARK_H
@@ -0,0 +1,140 @@
+#include "logbenchmark.h"
+#include "logmodel.h"
+#include "logger.h"
+#include "tracer.h"
+#include <QTest>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+
+namespace {
+
+QString legacyLogPath;
+
+// The message handler main.cpp had before Logger, kept as the baseline:
+// opens, formats into and closes the log file on the calling thread
+void legacyMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &msg)
+{
+    QString txt;
+    switch (type) {
+    case QtDebugMsg:
+        txt = QString("Debug: %1").arg(msg);
+        break;
+    case QtInfoMsg:
+        txt = QString("Info: %1").arg(msg);
+        break;
+    case QtWarningMsg:
+        txt = QString("Warning: %1").arg(msg);
+        break;
+    case QtCriticalMsg:
+        txt = QString("Critical: %1").arg(msg);
+        break;
+    case QtFatalMsg:
+        txt = QString("Fatal: %1").arg(msg);
+        break;
+    }
+
+    QFile outFile(legacyLogPath);
+    if (outFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        QTextStream ts(&outFile);
+        ts << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ") << txt << Qt::endl;
+    }
+}
+
+} // namespace
+
+void LogBenchmark::initTestCase()
+{
+    QVERIFY(dir.isValid());
+}
+
+void LogBenchmark::appendLog_data()
+{
+    QTest::addColumn<int>("lineCap");
+    QTest::newRow("5000") << LogModel::DEFAULT_LINE_CAP;
+    QTest::newRow("100000") << 100000;
+}
+
+void LogBenchmark::appendLog()
+{
+    QFETCH(int, lineCap);
+    LogModel model;
+    model.setLineCap(lineCap);
+
+    // 10k lines per frame, the way a flood from scrcpy arrives
+    const QString line = "INFO: 58 fps (+2 frames skipped)";
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i) {
+            model.append(line, LogSeverity::Muted);
+        }
+        model.flushPending();
+    }
+    QVERIFY(model.rowCount() > 0 && model.rowCount() <= lineCap);
+}
+
+void LogBenchmark::fileLoggerOpenPerMessage()
+{
+    // Same calls as fileLogger, through the old handler
+    legacyLogPath = dir.filePath("legacy.log");
+    QtMessageHandler previous = qInstallMessageHandler(legacyMessageHandler);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            qCInfo(lcAdb) << "Shell command" << i << "finished with exit code" << 0;
+        }
+    }
+
+    qInstallMessageHandler(previous);
+    QVERIFY(QFile(legacyLogPath).size() > 0);
+}
+
+void LogBenchmark::fileLogger()
+{
+    Logger *logger = Logger::instance();
+    logger->start(dir.filePath("bench.log"));
+    QtMessageHandler previous = qInstallMessageHandler(Logger::messageHandler);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            qCInfo(lcAdb) << "Shell command" << i << "finished with exit code" << 0;
+        }
+    }
+
+    qInstallMessageHandler(previous);
+    logger->stop();
+}
+
+void LogBenchmark::fileLoggerFiltered()
+{
+    // A disabled level must cost no formatting at the call site
+    Logger *logger = Logger::instance();
+    logger->setCategoryLevel("scrcpygui.adb", QtInfoMsg);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            qCDebug(lcAdb) << "Shell command" << i << "finished with exit code" << 0;
+        }
+    }
+
+    logger->setCategoryLevel("scrcpygui.adb", QtDebugMsg);
+}
+
+void LogBenchmark::traceSpanDisabled()
+{
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            TRACE_SPAN("LogBenchmark::traceSpanDisabled");
+        }
+    }
+}
+
+void LogBenchmark::traceSpanEnabled()
+{
+    // Enabling cannot be undone, so this runs last
+    Tracer::instance()->enable();
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            TRACE_SPAN("LogBenchmark::traceSpanEnabled");
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef LOGBENCHMARK_H
+#define LOGBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Cost on the calling thread of the log pane, the file logger and trace
+// spans; the work they hand off is not measured
+class LogBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void appendLog_data();
+    void appendLog();
+    void fileLoggerOpenPerMessage();
+    void fileLogger();
+    void fileLoggerFiltered();
+    void traceSpanDisabled();
+    void traceSpanEnabled();
+
+private:
+    QTemporaryDir dir;
+};
+
+#endif // LOGBENCHMARK_H
@@ -0,0 +1,135 @@
+#include "modelbenchmark.h"
+#include "benchdata.h"
+#include "applistmodel.h"
+#include "appfilterproxymodel.h"
+#include "appsearchindex.h"
+#include <QTest>
+
+namespace {
+
+void addSizes()
+{
+    QTest::addColumn<int>("apps");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+} // namespace
+
+void ModelBenchmark::setApps_data()
+{
+    addSizes();
+}
+
+void ModelBenchmark::setApps()
+{
+    QFETCH(int, apps);
+    AppListModel model;
+    AppFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    // A refresh where 1% of the packages were removed and 1% installed
+    QList<AppInfo> before = BenchData::apps(apps + apps / 100);
+    QList<AppInfo> after = before.mid(apps / 100);
+    before.resize(apps);
+    model.setApps(before);
+
+    bool flip = false;
+    QBENCHMARK {
+        model.setApps(flip ? before : after);
+        flip = !flip;
+    }
+}
+
+void ModelBenchmark::setAppsScattered_data()
+{
+    addSizes();
+}
+
+void ModelBenchmark::setAppsScattered()
+{
+    QFETCH(int, apps);
+    AppListModel model;
+    AppFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    // Every tenth package comes and goes, so each refresh inserts many
+    // one-row runs spread over the whole list
+    QList<AppInfo> after = BenchData::apps(apps);
+    QList<AppInfo> before;
+    for (int i = 0; i < after.size(); ++i) {
+        if (i % 10 != 0) {
+            before.append(after.at(i));
+        }
+    }
+    model.setApps(before);
+
+    bool flip = false;
+    QBENCHMARK {
+        model.setApps(flip ? before : after);
+        flip = !flip;
+    }
+}
+
+void ModelBenchmark::applyFilter_data()
+{
+    addSizes();
+}
+
+void ModelBenchmark::applyFilter()
+{
+    QFETCH(int, apps);
+    AppListModel model;
+    AppFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    model.setApps(BenchData::apps(apps));
+    model.setRunningPackages(BenchData::running(apps, 50));
+
+    // The running-only toggle, both ways
+    int running = 0;
+    QBENCHMARK {
+        proxy.setRunningOnly(true);
+        running = proxy.rowCount();
+        proxy.setRunningOnly(false);
+        proxy.rowCount();
+    }
+    QCOMPARE(running, (apps + 49) / 50);
+}
+
+void ModelBenchmark::typeAhead_data()
+{
+    addSizes();
+}
+
+void ModelBenchmark::typeAhead()
+{
+    QFETCH(int, apps);
+    AppListModel model;
+    AppFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    model.setApps(BenchData::apps(apps));
+
+    // One keystroke per step, including a typo, then clearing the field
+    const QStringList keystrokes = { "c", "ca", "cam", "came", "camw", "camer", "camera", "camera p", "" };
+    QBENCHMARK {
+        for (const QString &text : keystrokes) {
+            proxy.setFilterText(text);
+            proxy.rowCount();
+        }
+    }
+}
+
+void ModelBenchmark::searchIndex()
+{
+    AppSearchIndex index;
+    for (const AppInfo &app : BenchData::apps(100000)) {
+        index.insert(app.packageName, app.name);
+    }
+
+    QHash<QString, int> results;
+    QBENCHMARK {
+        results = index.search("scanner pro");
+    }
+    QVERIFY(!results.isEmpty());
+}
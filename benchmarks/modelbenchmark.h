@@ -0,0 +1,24 @@
+#ifndef MODELBENCHMARK_H
+#define MODELBENCHMARK_H
+
+#include <QObject>
+
+// The app list model and its filter proxy, which carry the work behind
+// MainWindow::applyFilter, a refresh and the search field
+class ModelBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void setApps_data();
+    void setApps();
+    void setAppsScattered_data();
+    void setAppsScattered();
+    void applyFilter_data();
+    void applyFilter();
+    void typeAhead_data();
+    void typeAhead();
+    void searchIndex();
+};
+
+#endif // MODELBENCHMARK_H
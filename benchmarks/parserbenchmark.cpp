@@ -0,0 +1,160 @@
+#include "parserbenchmark.h"
+#include "benchdata.h"
+#include "packageparser.h"
+#include "devicemanager.h"
+#include "scrcpyoutputparser.h"
+#include "qualitycontroller.h"
+#include <QTest>
+
+void ParserBenchmark::packageToName()
+{
+    const QStringList packages = BenchData::packages(1000);
+    QBENCHMARK {
+        for (const QString &package : packages) {
+            PackageParser::packageToName(package);
+        }
+    }
+}
+
+void ParserBenchmark::parsePackageList_data()
+{
+    QTest::addColumn<int>("packages");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("50000") << 50000;
+}
+
+void ParserBenchmark::parsePackageList()
+{
+    QFETCH(int, packages);
+    const QByteArray output = BenchData::pmOutput(packages);
+
+    PackageListing listing;
+    QBENCHMARK {
+        listing = PackageParser::parsePackageList(output);
+    }
+    QCOMPARE(listing.packages.size(), packages);
+}
+
+void ParserBenchmark::parseRunningPackages_data()
+{
+    QTest::addColumn<int>("processes");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("50000") << 50000;
+}
+
+void ParserBenchmark::parseRunningPackages()
+{
+    QFETCH(int, processes);
+    const QByteArray output = BenchData::psOutput(processes, processes, 10);
+
+    QSet<QString> running;
+    QBENCHMARK {
+        running = PackageParser::parseRunningPackages(output);
+    }
+    QVERIFY(!running.isEmpty());
+}
+
+void ParserBenchmark::buildAppList_data()
+{
+    QTest::addColumn<int>("packages");
+    QTest::addColumn<int>("customApps");
+    QTest::newRow("1000") << 1000 << 100;
+    QTest::newRow("50000") << 50000 << 1000;
+}
+
+void ParserBenchmark::buildAppList()
+{
+    QFETCH(int, packages);
+    QFETCH(int, customApps);
+    PackageListing listing = PackageParser::parsePackageList(BenchData::pmOutput(packages));
+
+    // Every other custom app duplicates a device package
+    QList<AppInfo> custom;
+    for (int i = 0; i < customApps; ++i) {
+        AppInfo app;
+        app.packageName = i % 2 ? BenchData::packageName(i * 7) : QString("org.custom.app%1").arg(i);
+        app.name = QString("Custom %1").arg(i);
+        app.isCustom = true;
+        custom << app;
+    }
+
+    QList<AppInfo> apps;
+    QBENCHMARK {
+        apps = PackageParser::buildAppList(listing.packages, custom, listing.versionCodes);
+    }
+    QCOMPARE(apps.size(), packages + customApps / 2);
+}
+
+void ParserBenchmark::parseDeviceList()
+{
+    const QByteArray output = BenchData::devicesOutput(30);
+
+    QList<DeviceInfo> devices;
+    QBENCHMARK {
+        devices = DeviceManager::parseDeviceList(output);
+    }
+    QCOMPARE(devices.size(), 30);
+}
+
+void ParserBenchmark::scrcpyOutput_data()
+{
+    // About 40 bytes a line: 400 KB, 4 MB and 16 MB of output
+    QTest::addColumn<int>("lines");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("400k") << 400000;
+}
+
+void ParserBenchmark::scrcpyOutput()
+{
+    QFETCH(int, lines);
+    const QByteArray log = BenchData::scrcpyLog(lines);
+    ScrcpyOutputParser parser;
+    int events = 0;
+    connect(&parser, &ScrcpyOutputParser::eventParsed, this, [&events]() { events++; });
+
+    // Pipe-sized reads that split lines anywhere
+    QBENCHMARK {
+        events = 0;
+        for (qsizetype pos = 0; pos < log.size(); pos += 4096) {
+            parser.feed(QByteArrayView(log).sliced(pos, qMin<qsizetype>(4096, log.size() - pos)));
+        }
+        parser.finish();
+    }
+    QCOMPARE(events, lines);
+}
+
+void ParserBenchmark::fpsReports_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<bool>("bad");
+    const QStringList capped = { "--max-fps", "30" };
+    QTest::newRow("clean") << QByteArray("INFO: 59 fps") << QStringList() << false;
+    QTest::newRow("drops") << QByteArray("INFO: 48 fps (+12 frames skipped)") << QStringList() << true;
+    QTest::newRow("starved") << QByteArray("INFO: 18 fps") << QStringList() << true;
+    QTest::newRow("capped") << QByteArray("INFO: 18 fps") << capped << false;
+    QTest::newRow("capped-starved") << QByteArray("INFO: 12 fps") << capped << true;
+}
+
+void ParserBenchmark::fpsReports()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QStringList, arguments);
+    QFETCH(bool, bad);
+
+    ScrcpyOutputParser parser;
+    ScrcpyEvent report;
+    connect(&parser, &ScrcpyOutputParser::eventParsed, this, [&report](const ScrcpyEvent &event) {
+        report = event;
+    });
+    parser.feed(line + "\n");
+    QCOMPARE(report.type, ScrcpyEvent::Fps);
+
+    const int target = QualityController::targetFps(arguments);
+    bool result = false;
+    QBENCHMARK {
+        result = QualityController::isBadReport(report, target);
+    }
+    QCOMPARE(result, bad);
+}
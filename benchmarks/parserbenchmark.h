@@ -0,0 +1,28 @@
+#ifndef PARSERBENCHMARK_H
+#define PARSERBENCHMARK_H
+
+#include <QObject>
+
+// pm/ps/devices parsing, display names, list building and the scrcpy log
+// parser, fed with synthetic output at device-farm sizes, and how the
+// adaptive quality controller grades the FPS reports
+class ParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void packageToName();
+    void parsePackageList_data();
+    void parsePackageList();
+    void parseRunningPackages_data();
+    void parseRunningPackages();
+    void buildAppList_data();
+    void buildAppList();
+    void parseDeviceList();
+    void scrcpyOutput_data();
+    void scrcpyOutput();
+    void fpsReports_data();
+    void fpsReports();
+};
+
+#endif // PARSERBENCHMARK_H
@@ -0,0 +1,74 @@
+#include "refreshbenchmark.h"
+#include "devicemanager.h"
+#include "fakeadbserver.h"
+#include <QTest>
+#include <QSignalSpy>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+void RefreshBenchmark::initTestCase()
+{
+    QVERIFY(dir.isValid());
+#ifdef FAKE_ADB_PATH
+    // Read by ToolPaths when each DeviceManager is created
+    qputenv("SCRCPY_GUI_ADB", FAKE_ADB_PATH);
+#endif
+}
+
+void RefreshBenchmark::cleanupTestCase()
+{
+    qunsetenv("ANDROID_ADB_SERVER_PORT");
+}
+
+void RefreshBenchmark::refresh_data()
+{
+    QTest::addColumn<int>("devices");
+    QTest::addColumn<bool>("useServer");
+    for (int devices : { 10, 30 }) {
+        QTest::addRow("%d/server", devices) << devices << true;
+        QTest::addRow("%d/process", devices) << devices << false;
+    }
+}
+
+void RefreshBenchmark::refresh()
+{
+    QFETCH(int, devices);
+    QFETCH(bool, useServer);
+#ifndef FAKE_ADB_PATH
+    if (!useServer) {
+        QSKIP("fake-adb not built; configure with -DSCRCPY_GUI_BUILD_FAKE_TOOLS=ON");
+    }
+#endif
+
+    QString scenarioPath = dir.filePath(QString("farm-%1.json").arg(devices));
+    QFile scenarioFile(scenarioPath);
+    QVERIFY(scenarioFile.open(QIODevice::WriteOnly));
+    scenarioFile.write(QJsonDocument(QJsonObject {
+        { "devices", devices },
+        { "packages", 2000 },
+        { "latencyMs", 50 },
+        { "jitterMs", 20 }
+    }).toJson());
+    scenarioFile.close();
+    qputenv("SCRCPY_GUI_FAKE_SCENARIO", scenarioPath.toLocal8Bit());
+
+    Scenario scenario;
+    QVERIFY(scenario.load(scenarioPath));
+    FakeAdbServer server(scenario);
+    if (useServer) {
+        QVERIFY2(server.listen(), qPrintable(server.errorString()));
+        qputenv("ANDROID_ADB_SERVER_PORT", QByteArray::number(server.port()));
+    } else {
+        qunsetenv("ANDROID_ADB_SERVER_PORT");
+    }
+
+    DeviceManager manager;
+    QSignalSpy finished(&manager, &DeviceManager::refreshFinished);
+    QBENCHMARK {
+        manager.refresh();
+        QVERIFY(finished.wait(60000));
+    }
+    QCOMPARE(finished.last().at(0).toInt(), devices);
+    QCOMPARE(server.connectionCount() > 0, useServer);
+}
@@ -0,0 +1,24 @@
+#ifndef REFRESHBENCHMARK_H
+#define REFRESHBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Wall-clock of a full DeviceManager refresh against a fake device farm,
+// through FakeAdbServer and through fake-adb processes. The process rows
+// need a build with SCRCPY_GUI_BUILD_FAKE_TOOLS=ON.
+class RefreshBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void refresh_data();
+    void refresh();
+
+private:
+    QTemporaryDir dir;
+};
+
+#endif // REFRESHBENCHMARK_H
@@ -0,0 +1,76 @@
+#include "storagebenchmark.h"
+#include "customappstore.h"
+#include <QTest>
+#include <QFile>
+
+namespace {
+
+constexpr int CUSTOM_APPS = 10000;
+
+AppInfo customApp(int index)
+{
+    AppInfo app;
+    app.packageName = QString("org.custom.app%1").arg(index);
+    app.name = QString("Custom App %1").arg(index);
+    app.isCustom = true;
+    return app;
+}
+
+} // namespace
+
+void StorageBenchmark::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    CustomAppStore *store = CustomAppStore::instance();
+    store->setDirectory(dir.path());
+    store->load();
+    for (; nextApp < CUSTOM_APPS; ++nextApp) {
+        store->add(customApp(nextApp));
+    }
+    store->sync();
+    QVERIFY(QFile::exists(dir.filePath("config.json")));
+    QVERIFY(QFile::exists(dir.filePath("config.cbor")));
+}
+
+void StorageBenchmark::cleanupTestCase()
+{
+    CustomAppStore::instance()->sync();
+}
+
+void StorageBenchmark::loadSnapshot()
+{
+    CustomAppStore *store = CustomAppStore::instance();
+    QBENCHMARK {
+        store->load();
+    }
+    QCOMPARE(store->apps().size(), CUSTOM_APPS);
+}
+
+void StorageBenchmark::loadJson()
+{
+    CustomAppStore *store = CustomAppStore::instance();
+    QFile::remove(dir.filePath("config.cbor"));
+    QBENCHMARK {
+        store->load();
+    }
+    QCOMPARE(store->apps().size(), CUSTOM_APPS);
+}
+
+void StorageBenchmark::save()
+{
+    // One change, then the flush that rewrites both files
+    CustomAppStore *store = CustomAppStore::instance();
+    QBENCHMARK {
+        store->add(customApp(nextApp++));
+        store->sync();
+    }
+    QVERIFY(QFile::exists(dir.filePath("config.cbor")));
+}
+
+void StorageBenchmark::journalAppend()
+{
+    CustomAppStore *store = CustomAppStore::instance();
+    QBENCHMARK {
+        store->add(customApp(nextApp++));
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef STORAGEBENCHMARK_H
+#define STORAGEBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Custom app persistence at 10k entries: config.json and config.cbor loads,
+// a full flush and the journal append behind each add
+class StorageBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void loadSnapshot();
+    void loadJson();
+    void save();
+    void journalAppend();
+
+private:
+    QTemporaryDir dir;
+    int nextApp = 0;
+};
+
+#endif // STORAGEBENCHMARK_H
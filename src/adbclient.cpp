@@ -0,0 +1,81 @@
+#include "adbclient.h"
+#include <QTimer>
+
+AdbClient::AdbClient(QObject *parent)
+    : QObject(parent)
+    , serverHost("127.0.0.1")
+    , serverPort(DEFAULT_PORT)
+    , serverEnabled(true)
+    , adbProgram("adb")
+{
+}
+
+AdbReply *AdbClient::shell(const QString &serial, const QString &command)
+{
+    return startReply(AdbReply::Output, serial, "shell:" + command.toUtf8(),
+                      QStringList() << "shell" << command);
+}
+
+AdbReply *AdbClient::exec(const QString &serial, const QString &command)
+{
+    return startReply(AdbReply::Output, serial, "exec:" + command.toUtf8(),
+                      QStringList() << "exec-out" << command);
+}
+
+AdbReply *AdbClient::openStream(const QString &serial, const QString &service,
+                                const QStringList &fallbackArguments)
+{
+    return startReply(AdbReply::Stream, serial, service.toUtf8(), fallbackArguments);
+}
+
+AdbReply *AdbClient::hostQuery(const QString &request, const QStringList &fallbackArguments)
+{
+    return startReply(AdbReply::HostQuery, QString(), request.toUtf8(), fallbackArguments);
+}
+
+void AdbClient::setServerAddress(const QString &host, quint16 port)
+{
+    serverHost = host;
+    serverPort = port;
+}
+
+void AdbClient::setServerEnabled(bool enabled)
+{
+    serverEnabled = enabled;
+}
+
+void AdbClient::setProgram(const QString &program)
+{
+    adbProgram = program;
+}
+
+QString AdbClient::program() const
+{
+    return adbProgram;
+}
+
+QByteArray AdbClient::encodeRequest(const QByteArray &payload)
+{
+    // Smart-socket requests are prefixed with their length as 4 hex digits
+    return QByteArray::number(payload.size(), 16).rightJustified(4, '0') + payload;
+}
+
+AdbReply *AdbClient::startReply(AdbReply::Mode mode, const QString &serial, const QByteArray &service,
+                                const QStringList &fallbackArguments)
+{
+    AdbReply *reply = new AdbReply(mode, serial, service, fallbackArguments, this);
+    reply->fallbackEnabled = true;
+    reply->fallbackProgram = adbProgram;
+
+    // Start from the event loop so callers can connect to the reply first
+    if (serverEnabled) {
+        QString host = serverHost;
+        quint16 port = serverPort;
+        QTimer::singleShot(0, reply, [reply, host, port]() { reply->startSocket(host, port); });
+    } else {
+        QString program = adbProgram;
+        QTimer::singleShot(0, reply, [reply, program]() { reply->startProcess(program); });
+    }
+
+    return reply;
+}
@@ -0,0 +1,52 @@
+#ifndef ADBCLIENT_H
+#define ADBCLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include "adbreply.h"
+
+// In-process client for the adb server's smart-socket protocol.
+//
+// Requests are sent straight to the server on localhost:5037 from the event
+// loop, so a query costs one local TCP connection instead of an adb process.
+// When the server is not running, requests fall back to spawning adb (which
+// also starts the server for the requests that follow).
+class AdbClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint16 DEFAULT_PORT = 5037;
+
+    explicit AdbClient(QObject *parent = nullptr);
+
+    // "shell:<command>" on the device; output is stdout and stderr
+    AdbReply *shell(const QString &serial, const QString &command);
+    // "exec:<command>" on the device; raw, binary-safe stdout
+    AdbReply *exec(const QString &serial, const QString &command);
+    // Long-lived two-way stream to a device service, e.g. "shell:"
+    AdbReply *openStream(const QString &serial, const QString &service,
+                         const QStringList &fallbackArguments);
+    // "host:<request>" answered by the server itself, e.g. "host:devices-l"
+    AdbReply *hostQuery(const QString &request, const QStringList &fallbackArguments);
+
+    void setServerAddress(const QString &host, quint16 port);
+    void setServerEnabled(bool enabled);
+    void setProgram(const QString &program);
+    QString program() const;
+
+    static QByteArray encodeRequest(const QByteArray &payload);
+
+private:
+    AdbReply *startReply(AdbReply::Mode mode, const QString &serial, const QByteArray &service,
+                         const QStringList &fallbackArguments);
+
+    QString serverHost;
+    quint16 serverPort;
+    bool serverEnabled;
+    QString adbProgram;
+};
+
+#endif // ADBCLIENT_H
@@ -0,0 +1,374 @@
+#include "adbreply.h"
+#include "adbclient.h"
+#include "logger.h"
+#include "metrics.h"
+#include <QTcpSocket>
+
+AdbReply::AdbReply(Mode mode, const QString &serial, const QByteArray &service,
+                   const QStringList &fallbackArguments, QObject *parent)
+    : QObject(parent)
+    , replyMode(mode)
+    , deviceSerial(serial)
+    , service(service)
+    , fallbackArguments(fallbackArguments)
+    , fallbackEnabled(false)
+    , state(Connecting)
+    , socket(nullptr)
+    , process(nullptr)
+    , payloadLength(0)
+    , replyError(NoError)
+    , elapsedMs(0)
+{
+    timer.start();
+}
+
+AdbReply::~AdbReply()
+{
+    abort();
+}
+
+AdbReply::Mode AdbReply::mode() const
+{
+    return replyMode;
+}
+
+QString AdbReply::serial() const
+{
+    return deviceSerial;
+}
+
+bool AdbReply::isFinished() const
+{
+    return state == Done;
+}
+
+bool AdbReply::usedFallback() const
+{
+    return process != nullptr;
+}
+
+qint64 AdbReply::elapsed() const
+{
+    return state == Done ? elapsedMs : timer.elapsed();
+}
+
+AdbReply::Error AdbReply::error() const
+{
+    return replyError;
+}
+
+QString AdbReply::errorString() const
+{
+    return replyErrorString;
+}
+
+QByteArray AdbReply::output() const
+{
+    return collected;
+}
+
+QByteArray AdbReply::readAll()
+{
+    QByteArray data;
+    data.swap(collected);
+    return data;
+}
+
+void AdbReply::write(const QByteArray &data)
+{
+    if (socket && state == Streaming) {
+        socket->write(data);
+    } else if (process && process->state() != QProcess::NotRunning) {
+        process->write(data);
+    }
+}
+
+void AdbReply::abort()
+{
+    if (socket) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+        socket = nullptr;
+    }
+    if (process) {
+        process->disconnect(this);
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+        process->deleteLater();
+        process = nullptr;
+    }
+    if (state != Done) {
+        state = Done;
+        elapsedMs = timer.elapsed();
+    }
+}
+
+void AdbReply::startSocket(const QString &host, quint16 port)
+{
+    socket = new QTcpSocket(this);
+    connect(socket, &QTcpSocket::connected, this, &AdbReply::onSocketConnected);
+    connect(socket, &QTcpSocket::readyRead, this, &AdbReply::onSocketReadyRead);
+    connect(socket, &QTcpSocket::disconnected, this, &AdbReply::onSocketDisconnected);
+    connect(socket, &QTcpSocket::errorOccurred, this, &AdbReply::onSocketError);
+    socket->connectToHost(host, port);
+}
+
+void AdbReply::startProcess(const QString &program)
+{
+    QStringList arguments;
+    if (!deviceSerial.isEmpty()) {
+        arguments << "-s" << deviceSerial;
+    }
+    arguments << fallbackArguments;
+
+    process = new QProcess(this);
+    connect(process, &QProcess::started, this, &AdbReply::onProcessStarted);
+    connect(process, &QProcess::readyReadStandardOutput, this, &AdbReply::onProcessReadyRead);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &AdbReply::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, &AdbReply::onProcessError);
+
+    qCDebug(lcAdb) << "Running ADB command:" << arguments;
+    state = replyMode == Stream ? Streaming : ReadingOutput;
+    process->start(program, arguments);
+}
+
+void AdbReply::sendRequest(const QByteArray &payload)
+{
+    socket->write(AdbClient::encodeRequest(payload));
+}
+
+// Consumes "OKAY" or "FAIL<len><message>" from the buffer. Returns false if
+// more data is needed.
+bool AdbReply::readStatus(bool *okay)
+{
+    if (buffer.size() < 4) {
+        return false;
+    }
+
+    if (buffer.startsWith("OKAY")) {
+        buffer.remove(0, 4);
+        *okay = true;
+        return true;
+    }
+
+    if (buffer.startsWith("FAIL")) {
+        if (buffer.size() < 8) {
+            return false;
+        }
+        bool ok;
+        int length = buffer.mid(4, 4).toInt(&ok, 16);
+        if (!ok) {
+            finish(ProtocolError, "Malformed FAIL response from adb server");
+            return false;
+        }
+        if (buffer.size() < 8 + length) {
+            return false;
+        }
+        QString message = QString::fromUtf8(buffer.mid(8, length));
+        buffer.clear();
+        *okay = false;
+        finish(ServiceError, message);
+        return true;
+    }
+
+    finish(ProtocolError, "Unexpected response from adb server: " + QString::fromLatin1(buffer.left(4)));
+    return false;
+}
+
+void AdbReply::processBuffer()
+{
+    bool okay = false;
+
+    while (state != Done) {
+        switch (state) {
+        case AwaitingTransport:
+            if (!readStatus(&okay) || !okay) {
+                return;
+            }
+            sendRequest(service);
+            state = AwaitingService;
+            break;
+
+        case AwaitingService:
+            if (!readStatus(&okay) || !okay) {
+                return;
+            }
+            if (replyMode == HostQuery) {
+                state = AwaitingLength;
+            } else if (replyMode == Stream) {
+                state = Streaming;
+                emit connected();
+            } else {
+                state = ReadingOutput;
+            }
+            break;
+
+        case AwaitingLength: {
+            if (buffer.size() < 4) {
+                return;
+            }
+            bool ok;
+            payloadLength = buffer.left(4).toInt(&ok, 16);
+            if (!ok) {
+                finish(ProtocolError, "Malformed length prefix from adb server");
+                return;
+            }
+            buffer.remove(0, 4);
+            state = ReadingPayload;
+            break;
+        }
+
+        case ReadingPayload:
+            if (buffer.size() < payloadLength) {
+                return;
+            }
+            collected = buffer.left(payloadLength);
+            buffer.clear();
+            finish(NoError);
+            return;
+
+        case ReadingOutput:
+            collected += buffer;
+            buffer.clear();
+            return;
+
+        case Streaming:
+            if (!buffer.isEmpty()) {
+                collected += buffer;
+                buffer.clear();
+                emit readyRead();
+            }
+            return;
+
+        case Connecting:
+        case Done:
+            return;
+        }
+    }
+}
+
+void AdbReply::finish(Error error, const QString &message)
+{
+    if (state == Done) {
+        return;
+    }
+
+    state = Done;
+    elapsedMs = timer.elapsed();
+    replyError = error;
+    replyErrorString = message;
+    // Streams live as long as their owner; only one-shot requests have a latency
+    if (replyMode != Stream) {
+        Metrics::instance()->observeAdbQuery(Metrics::AdbRequest, elapsedMs, error != NoError);
+    }
+
+    if (socket) {
+        socket->disconnect(this);
+        socket->abort();
+    }
+
+    if (error != NoError) {
+        qCDebug(lcAdb) << "ADB request" << service << "failed:" << message;
+    }
+
+    emit finished();
+}
+
+void AdbReply::onSocketConnected()
+{
+    if (replyMode == HostQuery) {
+        sendRequest(service);
+        state = AwaitingService;
+    } else {
+        QByteArray transport = deviceSerial.isEmpty()
+                ? QByteArray("host:transport-any")
+                : "host:transport:" + deviceSerial.toUtf8();
+        sendRequest(transport);
+        state = AwaitingTransport;
+    }
+}
+
+void AdbReply::onSocketReadyRead()
+{
+    buffer += socket->readAll();
+    processBuffer();
+}
+
+void AdbReply::onSocketDisconnected()
+{
+    if (state == ReadingOutput || state == Streaming) {
+        buffer += socket->readAll();
+        processBuffer();
+        finish(NoError);
+    } else {
+        finish(ProtocolError, "adb server closed the connection");
+    }
+}
+
+void AdbReply::onSocketError(QAbstractSocket::SocketError socketError)
+{
+    if (state == Connecting && fallbackEnabled
+            && (socketError == QAbstractSocket::ConnectionRefusedError
+                || socketError == QAbstractSocket::HostNotFoundError
+                || socketError == QAbstractSocket::SocketTimeoutError)) {
+        qCDebug(lcAdb) << "ADB server not reachable, falling back to adb process";
+        socket->disconnect(this);
+        socket->deleteLater();
+        socket = nullptr;
+        startProcess(fallbackProgram);
+        return;
+    }
+
+    // Remote close is reported through disconnected()
+    if (socketError == QAbstractSocket::RemoteHostClosedError) {
+        return;
+    }
+
+    finish(ConnectionError, socket->errorString());
+}
+
+void AdbReply::onProcessStarted()
+{
+    if (replyMode == Stream) {
+        emit connected();
+    }
+}
+
+void AdbReply::onProcessReadyRead()
+{
+    collected += process->readAllStandardOutput();
+    if (replyMode == Stream) {
+        emit readyRead();
+    }
+}
+
+void AdbReply::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    collected += process->readAllStandardOutput();
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        QString message = "ADB command failed with exit code: " + QString::number(exitCode);
+        QString errorOutput = QString::fromLocal8Bit(process->readAllStandardError()).trimmed();
+        if (!errorOutput.isEmpty()) {
+            message += "\n" + errorOutput;
+        }
+        finish(ProcessFailed, message);
+    } else {
+        finish(NoError);
+    }
+}
+
+void AdbReply::onProcessError(QProcess::ProcessError processError)
+{
+    if (processError == QProcess::FailedToStart) {
+        finish(FailedToStart, QString("Failed to start ADB (%1).\n\n"
+                                      "Check the adb program in Settings > Advanced, or that ADB is\n"
+                                      "installed and in your PATH. It is part of Android SDK Platform Tools.")
+                                  .arg(fallbackProgram));
+    } else if (processError != QProcess::Crashed) {
+        finish(ProcessFailed, "ADB error: " + process->errorString());
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef ADBREPLY_H
+#define ADBREPLY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QAbstractSocket>
+#include <QProcess>
+
+class QTcpSocket;
+
+// One request to the adb server, created by AdbClient.
+//
+// The reply speaks the smart-socket protocol directly: it switches the
+// connection to the device transport, opens the service and then either
+// collects the output until the device closes the stream (Output), reads a
+// single length-prefixed payload (HostQuery), or keeps the stream open for
+// two-way traffic (Stream). If the server cannot be reached, the same
+// request is carried out by an adb process instead.
+class AdbReply : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        HostQuery,
+        Output,
+        Stream
+    };
+
+    enum Error {
+        NoError,
+        ConnectionError,
+        ServiceError,
+        ProtocolError,
+        FailedToStart,
+        ProcessFailed
+    };
+
+    ~AdbReply();
+
+    Mode mode() const;
+    QString serial() const;
+    bool isFinished() const;
+    bool usedFallback() const;
+    qint64 elapsed() const;
+
+    Error error() const;
+    QString errorString() const;
+
+    // Collected output for HostQuery and Output replies
+    QByteArray output() const;
+
+    // Stream replies
+    QByteArray readAll();
+    void write(const QByteArray &data);
+
+    void abort();
+
+signals:
+    void connected();
+    void readyRead();
+    void finished();
+
+private slots:
+    void onSocketConnected();
+    void onSocketReadyRead();
+    void onSocketDisconnected();
+    void onSocketError(QAbstractSocket::SocketError socketError);
+    void onProcessStarted();
+    void onProcessReadyRead();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessError(QProcess::ProcessError processError);
+
+private:
+    friend class AdbClient;
+
+    enum State {
+        Connecting,
+        AwaitingTransport,
+        AwaitingService,
+        AwaitingLength,
+        ReadingPayload,
+        ReadingOutput,
+        Streaming,
+        Done
+    };
+
+    AdbReply(Mode mode, const QString &serial, const QByteArray &service,
+             const QStringList &fallbackArguments, QObject *parent = nullptr);
+
+    void startSocket(const QString &host, quint16 port);
+    void startProcess(const QString &program);
+    void sendRequest(const QByteArray &payload);
+    bool readStatus(bool *okay);
+    void processBuffer();
+    void finish(Error error, const QString &message = QString());
+
+    Mode replyMode;
+    QString deviceSerial;
+    QByteArray service;
+    QStringList fallbackArguments;
+    QString fallbackProgram;
+    bool fallbackEnabled;
+
+    State state;
+    QTcpSocket *socket;
+    QProcess *process;
+    QByteArray buffer;
+    QByteArray collected;
+    int payloadLength;
+
+    Error replyError;
+    QString replyErrorString;
+    QElapsedTimer timer;
+    qint64 elapsedMs;
+};
+
+#endif // ADBREPLY_H
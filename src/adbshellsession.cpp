@@ -0,0 +1,215 @@
+#include "adbshellsession.h"
+#include "adbclient.h"
+#include "logger.h"
+#include <QTimer>
+#include <QRandomGenerator>
+
+AdbShellSession::AdbShellSession(AdbClient *client, const QString &serial, QObject *parent)
+    : QObject(parent)
+    , client(client)
+    , deviceSerial(serial)
+    , stream(nullptr)
+    , connected(false)
+    , nextId(1)
+    , reconnectCount(0)
+    , reconnectTimer(new QTimer(this))
+{
+    // Random per session so command output cannot fake a sentinel by accident
+    marker = "__SGUI_" + QByteArray::number(QRandomGenerator::global()->generate64(), 16) + "__";
+
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, &QTimer::timeout, this, &AdbShellSession::reconnect);
+}
+
+AdbShellSession::~AdbShellSession()
+{
+    pending.clear();
+    close();
+}
+
+QString AdbShellSession::serial() const
+{
+    return deviceSerial;
+}
+
+bool AdbShellSession::isConnected() const
+{
+    return connected;
+}
+
+int AdbShellSession::execute(const QString &command)
+{
+    Command entry;
+    entry.id = nextId++;
+    entry.attempts = 0;
+    // stdin is the command stream itself, so commands must not read from it
+    entry.script = "{ " + command.toUtf8() + "\n} </dev/null 2>&1; printf '\\n"
+                   + marker + " %d %d\\n' " + QByteArray::number(entry.id) + " $?\n";
+
+    pending.append(entry);
+
+    if (connected) {
+        pending.last().attempts++;
+        writeCommand(pending.last());
+    } else if (!stream && !reconnectTimer->isActive()) {
+        openStream();
+    }
+
+    return entry.id;
+}
+
+void AdbShellSession::close()
+{
+    reconnectTimer->stop();
+
+    if (stream) {
+        stream->disconnect(this);
+        stream->abort();
+        stream->deleteLater();
+        stream = nullptr;
+    }
+    connected = false;
+    buffer.clear();
+
+    failAll("ADB shell session closed");
+}
+
+void AdbShellSession::openStream()
+{
+    qCDebug(lcAdb) << "Opening ADB shell session" << (deviceSerial.isEmpty() ? "(default device)" : deviceSerial);
+
+    stream = client->openStream(deviceSerial, "shell:sh", QStringList() << "shell" << "sh");
+    connect(stream, &AdbReply::connected, this, &AdbShellSession::onStreamConnected);
+    connect(stream, &AdbReply::readyRead, this, &AdbShellSession::onStreamReadyRead);
+    connect(stream, &AdbReply::finished, this, &AdbShellSession::onStreamFinished);
+}
+
+void AdbShellSession::writeCommand(const Command &command)
+{
+    stream->write(command.script);
+}
+
+void AdbShellSession::onStreamConnected()
+{
+    connected = true;
+    buffer.clear();
+
+    // Replay everything queued while the shell was starting or reconnecting
+    for (Command &command : pending) {
+        command.attempts++;
+        writeCommand(command);
+    }
+}
+
+void AdbShellSession::onStreamReadyRead()
+{
+    buffer += stream->readAll();
+    parseBuffer();
+}
+
+void AdbShellSession::parseBuffer()
+{
+    const QByteArray needle = "\n" + marker + " ";
+
+    while (!pending.isEmpty()) {
+        int pos = buffer.indexOf(needle);
+        if (pos < 0) {
+            return;
+        }
+        int fieldsStart = pos + needle.size();
+        int lineEnd = buffer.indexOf('\n', fieldsStart);
+        if (lineEnd < 0) {
+            return;
+        }
+
+        QList<QByteArray> fields = buffer.mid(fieldsStart, lineEnd - fieldsStart).trimmed().split(' ');
+        int id = fields.value(0).toInt();
+        int exitCode = fields.value(1).toInt();
+        QByteArray output = buffer.left(pos);
+        buffer.remove(0, lineEnd + 1);
+
+        // Responses come back in submission order; anything skipped is lost
+        while (!pending.isEmpty() && pending.first().id != id) {
+            Command lost = pending.takeFirst();
+            emit commandFailed(lost.id, "ADB shell response was lost");
+        }
+        if (pending.isEmpty()) {
+            return;
+        }
+
+        pending.removeFirst();
+        reconnectCount = 0;
+        emit commandFinished(id, output, exitCode);
+    }
+}
+
+void AdbShellSession::onStreamFinished()
+{
+    AdbReply::Error error = stream->error();
+    QString errorString = stream->errorString();
+
+    buffer += stream->readAll();
+    parseBuffer();
+
+    stream->deleteLater();
+    stream = nullptr;
+    connected = false;
+    buffer.clear();
+
+    if (pending.isEmpty()) {
+        // Idle shell went away; the next command reopens it
+        return;
+    }
+
+    if (errorString.isEmpty()) {
+        errorString = "ADB shell closed unexpectedly";
+    }
+
+    // The server refused the device (not found, unauthorized, offline) or
+    // adb is missing: retrying will not help
+    if (error == AdbReply::ServiceError || error == AdbReply::FailedToStart) {
+        failAll(errorString);
+        return;
+    }
+
+    QList<Command> exhausted;
+    for (int i = pending.size() - 1; i >= 0; --i) {
+        if (pending.at(i).attempts >= MAX_ATTEMPTS) {
+            exhausted.prepend(pending.takeAt(i));
+        }
+    }
+    for (const Command &command : exhausted) {
+        emit commandFailed(command.id, errorString);
+    }
+
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    if (reconnectCount >= MAX_RECONNECTS) {
+        reconnectCount = 0;
+        failAll(errorString);
+        return;
+    }
+
+    int delay = qMin(5000, 100 << reconnectCount);
+    reconnectCount++;
+    qCDebug(lcAdb) << "ADB shell session lost, reconnecting in" << delay << "ms:" << errorString;
+    reconnectTimer->start(delay);
+}
+
+void AdbShellSession::reconnect()
+{
+    if (!stream) {
+        openStream();
+    }
+}
+
+void AdbShellSession::failAll(const QString &error)
+{
+    QList<Command> failed;
+    failed.swap(pending);
+    for (const Command &command : failed) {
+        emit commandFailed(command.id, error);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef ADBSHELLSESSION_H
+#define ADBSHELLSESSION_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+
+class AdbClient;
+class AdbReply;
+class QTimer;
+
+// Long-lived shell on one device that many queries share.
+//
+// Each command is written to the same `sh` followed by a sentinel line that
+// carries the command id and its exit status, so commands can be pipelined
+// and their output matched back to the caller. If the shell dies, unanswered
+// commands are replayed on a fresh shell.
+class AdbShellSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AdbShellSession(AdbClient *client, const QString &serial, QObject *parent = nullptr);
+    ~AdbShellSession();
+
+    QString serial() const;
+    bool isConnected() const;
+
+    // Queues a command and returns its id; the result arrives through
+    // commandFinished() or commandFailed() with the same id.
+    int execute(const QString &command);
+    void close();
+
+signals:
+    void commandFinished(int id, const QByteArray &output, int exitCode);
+    void commandFailed(int id, const QString &error);
+
+private slots:
+    void onStreamConnected();
+    void onStreamReadyRead();
+    void onStreamFinished();
+    void reconnect();
+
+private:
+    struct Command {
+        int id;
+        QByteArray script;
+        int attempts;
+    };
+
+    void openStream();
+    void writeCommand(const Command &command);
+    void parseBuffer();
+    void failAll(const QString &error);
+
+    static const int MAX_ATTEMPTS = 3;
+    static const int MAX_RECONNECTS = 5;
+
+    AdbClient *client;
+    QString deviceSerial;
+    AdbReply *stream;
+    bool connected;
+    QByteArray marker;
+    QByteArray buffer;
+    QList<Command> pending;
+    int nextId;
+    int reconnectCount;
+    QTimer *reconnectTimer;
+};
+
+#endif // ADBSHELLSESSION_H
@@ -0,0 +1,162 @@
+#include "appfilterproxymodel.h"
+#include "applistmodel.h"
+
+AppFilterProxyModel::AppFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , showRunningOnly(false)
+    , refreshTimer(new QTimer(this))
+{
+    // Re-check only the rows whose data changed (e.g. running state)
+    setDynamicSortFilter(true);
+
+    // A refresh arrives as several insert/remove ranges; re-run the search once
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(0);
+    connect(refreshTimer, &QTimer::timeout, this, &AppFilterProxyModel::refreshSearch);
+}
+
+void AppFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    for (const QMetaObject::Connection &connection : std::as_const(sourceConnections)) {
+        disconnect(connection);
+    }
+    sourceConnections.clear();
+
+    QSortFilterProxyModel::setSourceModel(model);
+
+    searchIndex.clear();
+    if (!model) {
+        return;
+    }
+
+    sourceConnections << connect(model, &QAbstractItemModel::rowsInserted,
+                                 this, &AppFilterProxyModel::onSourceRowsInserted)
+                      << connect(model, &QAbstractItemModel::rowsAboutToBeRemoved,
+                                 this, &AppFilterProxyModel::onSourceRowsAboutToBeRemoved)
+                      << connect(model, &QAbstractItemModel::dataChanged,
+                                 this, &AppFilterProxyModel::onSourceDataChanged)
+                      << connect(model, &QAbstractItemModel::modelReset,
+                                 this, &AppFilterProxyModel::onSourceModelReset);
+    indexRows(0, model->rowCount() - 1);
+}
+
+bool AppFilterProxyModel::runningOnly() const
+{
+    return showRunningOnly;
+}
+
+void AppFilterProxyModel::setRunningOnly(bool enabled)
+{
+    if (showRunningOnly == enabled)
+        return;
+
+    showRunningOnly = enabled;
+    invalidateFilter();
+}
+
+QString AppFilterProxyModel::filterText() const
+{
+    return text;
+}
+
+void AppFilterProxyModel::setFilterText(const QString &filter)
+{
+    QString trimmed = filter.trimmed();
+    if (text == trimmed)
+        return;
+
+    text = trimmed;
+    applySearch();
+    invalidateFilter();
+
+    // Rank while searching, source order otherwise
+    sort(text.isEmpty() ? -1 : 0);
+}
+
+bool AppFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+
+    if (showRunningOnly && !index.data(AppListModel::IsRunningRole).toBool())
+        return false;
+
+    if (!text.isEmpty())
+        return searchScores.contains(index.data(AppListModel::PackageNameRole).toString());
+
+    return true;
+}
+
+bool AppFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    int leftScore = searchScores.value(left.data(AppListModel::PackageNameRole).toString());
+    int rightScore = searchScores.value(right.data(AppListModel::PackageNameRole).toString());
+    if (leftScore != rightScore)
+        return leftScore > rightScore;
+
+    return left.row() < right.row();
+}
+
+void AppFilterProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    indexRows(first, last);
+    if (!text.isEmpty())
+        refreshTimer->start();
+}
+
+void AppFilterProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; ++row) {
+        searchIndex.remove(sourceModel()->index(row, 0).data(AppListModel::PackageNameRole).toString());
+    }
+    if (!text.isEmpty())
+        refreshTimer->start();
+}
+
+void AppFilterProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                              const QList<int> &roles)
+{
+    // Running-state updates don't touch the searchable text
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole))
+        return;
+
+    indexRows(topLeft.row(), bottomRight.row());
+    if (!text.isEmpty())
+        refreshTimer->start();
+}
+
+void AppFilterProxyModel::onSourceModelReset()
+{
+    searchIndex.clear();
+    indexRows(0, sourceModel()->rowCount() - 1);
+    if (!text.isEmpty())
+        refreshTimer->start();
+}
+
+void AppFilterProxyModel::refreshSearch()
+{
+    if (text.isEmpty())
+        return;
+
+    applySearch();
+    invalidate();
+}
+
+void AppFilterProxyModel::indexRows(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        QModelIndex index = sourceModel()->index(row, 0);
+        searchIndex.insert(index.data(AppListModel::PackageNameRole).toString(),
+                           index.data(Qt::DisplayRole).toString());
+    }
+}
+
+void AppFilterProxyModel::applySearch()
+{
+    searchScores = text.isEmpty() ? QHash<QString, int>() : searchIndex.search(text);
+}
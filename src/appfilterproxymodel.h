@@ -0,0 +1,55 @@
+#ifndef APPFILTERPROXYMODEL_H
+#define APPFILTERPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <QHash>
+#include <QTimer>
+#include "appsearchindex.h"
+
+// Running-only filtering and ranked search on top of AppListModel.
+//
+// Without a search the source order is kept (AppManager already sorts by
+// name); with one, rows are ordered by AppSearchIndex score. The index
+// follows the source model's insert/remove/change signals, so a refresh
+// only re-indexes the rows that changed.
+class AppFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit AppFilterProxyModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *model) override;
+
+    bool runningOnly() const;
+    void setRunningOnly(bool enabled);
+
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private slots:
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QList<int> &roles);
+    void onSourceModelReset();
+    void refreshSearch();
+
+private:
+    void indexRows(int first, int last);
+    void applySearch();
+
+    bool showRunningOnly;
+    QString text;
+    AppSearchIndex searchIndex;
+    QHash<QString, int> searchScores;
+    QTimer *refreshTimer;
+    QList<QMetaObject::Connection> sourceConnections;
+};
+
+#endif // APPFILTERPROXYMODEL_H
@@ -0,0 +1,213 @@
+#include "applistmodel.h"
+#include "iconloader.h"
+#include <QFont>
+#include <algorithm>
+
+namespace {
+
+int countRuns(const QList<bool> &flags, bool value)
+{
+    int runs = 0;
+    for (int i = 0; i < flags.size(); ++i) {
+        if (flags.at(i) == value && (i == 0 || flags.at(i - 1) != value)) {
+            ++runs;
+        }
+    }
+    return runs;
+}
+
+} // namespace
+
+AppListModel::AppListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , icons(nullptr)
+{
+}
+
+void AppListModel::setIconLoader(IconLoader *loader)
+{
+    icons = loader;
+    connect(loader, &IconLoader::iconReady, this, [this](const QString &packageName) {
+        int row = rowOf(packageName);
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), { Qt::DecorationRole });
+        }
+    });
+}
+
+int AppListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+QVariant AppListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size())
+        return QVariant();
+
+    const AppInfo &app = entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return app.name;
+    case Qt::DecorationRole:
+        return icons ? QVariant(icons->icon(app)) : QVariant();
+    case Qt::ToolTipRole:
+    case PackageNameRole:
+        return app.packageName;
+    case IsCustomRole:
+        return app.isCustom;
+    case IsRunningRole:
+        return runningPackages.contains(app.packageName);
+    case Qt::FontRole:
+        if (runningPackages.contains(app.packageName)) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+void AppListModel::setApps(const QList<AppInfo> &apps)
+{
+    QHash<QString, int> newIndex;
+    newIndex.reserve(apps.size());
+    for (int i = 0; i < apps.size(); ++i) {
+        newIndex.insert(apps.at(i).packageName, i);
+    }
+
+    // Drop rows that are gone, and rows that would now sit out of order
+    // relative to the rows we keep (e.g. after a rename)
+    QList<bool> drop(entries.size(), false);
+    QList<bool> kept(apps.size(), false);
+    int lastIndex = -1;
+    for (int row = 0; row < entries.size(); ++row) {
+        int newRow = newIndex.value(entries.at(row).packageName, -1);
+        if (newRow <= lastIndex) {
+            drop[row] = true;
+        } else {
+            lastIndex = newRow;
+            kept[newRow] = true;
+        }
+    }
+
+    // Already the final rows, so rowOf() is right when the last signal lands
+    rowByPackage = std::move(newIndex);
+
+    // Each range makes the proxy remap; past a few dozen, one reset is cheaper
+    if (countRuns(drop, true) + countRuns(kept, false) > MAX_DIFF_RANGES) {
+        beginResetModel();
+        entries = apps;
+        endResetModel();
+        return;
+    }
+
+    int row = entries.size() - 1;
+    while (row >= 0) {
+        if (!drop.at(row)) {
+            --row;
+            continue;
+        }
+        int last = row;
+        while (row >= 0 && drop.at(row)) {
+            --row;
+        }
+        int first = row + 1;
+        beginRemoveRows(QModelIndex(), first, last);
+        entries.erase(entries.begin() + first, entries.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    // Kept rows are now a subsequence of the new list; insert the gaps
+    row = 0;
+    int next = 0;
+    while (next < apps.size()) {
+        const AppInfo &app = apps.at(next);
+
+        if (kept.at(next)) {
+            AppInfo &current = entries[row];
+            if (current.name != app.name || current.isCustom != app.isCustom
+                    || current.versionCode != app.versionCode) {
+                current = app;
+                emit dataChanged(index(row), index(row));
+            }
+            ++row;
+            ++next;
+            continue;
+        }
+
+        int runStart = next;
+        while (next < apps.size() && !kept.at(next)) {
+            ++next;
+        }
+
+        int count = next - runStart;
+        beginInsertRows(QModelIndex(), row, row + count - 1);
+        // One shift of the tail per run, not per row
+        entries.insert(row, count, AppInfo());
+        std::copy(apps.cbegin() + runStart, apps.cbegin() + next, entries.begin() + row);
+        endInsertRows();
+        row += count;
+    }
+}
+
+void AppListModel::addApp(const AppInfo &app)
+{
+    if (rowByPackage.contains(app.packageName))
+        return;
+
+    int row = entries.size();
+    beginInsertRows(QModelIndex(), row, row);
+    entries.append(app);
+    rowByPackage.insert(app.packageName, row);
+    endInsertRows();
+}
+
+void AppListModel::setRunningPackages(const QSet<QString> &packages)
+{
+    QSet<QString> changed = (runningPackages - packages) + (packages - runningPackages);
+    runningPackages = packages;
+    emitRunningChanged(changed);
+}
+
+void AppListModel::addRunningPackages(const QSet<QString> &packages)
+{
+    runningPackages.unite(packages);
+    emitRunningChanged(packages);
+}
+
+void AppListModel::removeRunningPackages(const QSet<QString> &packages)
+{
+    runningPackages.subtract(packages);
+    emitRunningChanged(packages);
+}
+
+void AppListModel::emitRunningChanged(const QSet<QString> &packages)
+{
+    const QList<int> roles = { IsRunningRole, Qt::FontRole };
+    for (const QString &packageName : packages) {
+        int row = rowOf(packageName);
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), roles);
+        }
+    }
+}
+
+AppInfo AppListModel::appAt(int row) const
+{
+    return entries.value(row);
+}
+
+int AppListModel::rowOf(const QString &packageName) const
+{
+    // In the middle of setApps() some rows have not reached their place yet
+    int row = rowByPackage.value(packageName, -1);
+    return row >= 0 && row < entries.size() && entries.at(row).packageName == packageName ? row : -1;
+}
+
+const QList<AppInfo> &AppListModel::apps() const
+{
+    return entries;
+}
@@ -0,0 +1,59 @@
+#ifndef APPLISTMODEL_H
+#define APPLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include "appmanager.h"
+
+class IconLoader;
+
+// App catalog shown in the main list.
+//
+// setApps() diffs the new list against the current rows by package name and
+// emits only the remove/insert/change ranges that are needed, so a refresh
+// that changes a handful of packages touches a handful of rows. A diff of
+// more than MAX_DIFF_RANGES ranges is applied as one model reset instead.
+// Icons come from the IconLoader's memory cache and are never fetched from
+// data().
+class AppListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        PackageNameRole = Qt::UserRole,
+        IsCustomRole,
+        IsRunningRole
+    };
+
+    static constexpr int MAX_DIFF_RANGES = 64;
+
+    explicit AppListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setIconLoader(IconLoader *loader);
+
+    void setApps(const QList<AppInfo> &apps);
+    void addApp(const AppInfo &app);
+    void setRunningPackages(const QSet<QString> &packages);
+    void addRunningPackages(const QSet<QString> &packages);
+    void removeRunningPackages(const QSet<QString> &packages);
+
+    AppInfo appAt(int row) const;
+    int rowOf(const QString &packageName) const;
+    const QList<AppInfo> &apps() const;
+
+private:
+    void emitRunningChanged(const QSet<QString> &packages);
+
+    QList<AppInfo> entries;
+    QHash<QString, int> rowByPackage;
+    QSet<QString> runningPackages;
+    IconLoader *icons;
+};
+
+#endif // APPLISTMODEL_H
@@ -1,294 +1,192 @@
 #include "appmanager.h"
-#include <QStandardPaths>
-#include <QDir>
-#include <QFile>
-#include <QDebug>
-
-AppManager::AppManager(QObject *parent)
+#include <QSettings>
+#include "customappstore.h"
+#include "logger.h"
+#include "metrics.h"
+#include "packagecatalog.h"
+#include "packageparser.h"
+#include "tracer.h"
+
+AppManager::AppManager(AdbClient *client, const QString &serial, QObject *parent)
     : QObject(parent)
-    , adbProcess(nullptr)
-    , runningAppsProcess(nullptr)
+    , adbClient(client)
+    , deviceSerial(serial)
+    , shellSession(new AdbShellSession(client, serial, this))
+    , appsCommandId(0)
+    , runningMonitor(new RunningAppsMonitor(shellSession, this))
+    , runningAppsRequested(false)
+    , catalogShown(false)
 {
-    loadCustomApps();
+    connect(shellSession, &AdbShellSession::commandFinished, this, &AppManager::onShellCommandFinished);
+    connect(shellSession, &AdbShellSession::commandFailed, this, &AppManager::onShellCommandFailed);
+    connect(runningMonitor, &RunningAppsMonitor::pollFinished, this, &AppManager::onRunningAppsPolled);
+    connect(runningMonitor, &RunningAppsMonitor::pollFailed, this, &AppManager::onRunningAppsPolled);
+
+    CustomAppStore *store = CustomAppStore::instance();
+    if (!store->isLoaded()) {
+        store->load();
+    }
+    customApps = store->apps();
 }
 
 AppManager::~AppManager()
 {
-    saveCustomApps();
 }
 
-void AppManager::loadApps()
+QString AppManager::serial() const
 {
-    allApps.clear();
-
-    // First, add custom apps
-    allApps.append(customApps);
-
-    // Then query ADB for installed apps
-    if (adbProcess) {
-        delete adbProcess;
-    }
-
-    adbProcess = new QProcess(this);
-
-    connect(adbProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &AppManager::onAdbFinished);
-    connect(adbProcess, &QProcess::errorOccurred, this, &AppManager::onAdbError);
-
-    QStringList arguments;
-    arguments << "shell" << "pm" << "list" << "packages" << "-3";
-
-    qDebug() << "Running ADB command:" << arguments;
-    adbProcess->start("adb", arguments);
+    return deviceSerial;
 }
 
-void AppManager::onAdbFinished(int exitCode, QProcess::ExitStatus exitStatus)
+QList<AppInfo> AppManager::apps() const
 {
-    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
-        emit loadError("ADB command failed with exit code: " + QString::number(exitCode));
-        return;
-    }
-
-    QString output = adbProcess->readAllStandardOutput();
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-
-    qDebug() << "ADB returned" << lines.size() << "packages";
-
-    for (const QString &line : lines) {
-        // Format: "package:com.example.app"
-        if (line.startsWith("package:")) {
-            QString packageName = line.mid(8).trimmed();
-
-            // Skip if already in custom apps
-            bool isCustom = false;
-            for (const AppInfo &customApp : customApps) {
-                if (customApp.packageName == packageName) {
-                    isCustom = true;
-                    break;
-                }
-            }
-
-            if (!isCustom) {
-                AppInfo app;
-                app.packageName = packageName;
-                app.name = packageToName(packageName);
-                app.isCustom = false;
-                allApps.append(app);
-            }
-        }
-    }
-
-    // Sort alphabetically by name
-    std::sort(allApps.begin(), allApps.end(), 
-              [](const AppInfo &a, const AppInfo &b) {
-                  return a.name.toLower() < b.name.toLower();
-              });
-
-    emit appsLoaded(allApps);
+    return allApps;
 }
 
-void AppManager::onAdbError(QProcess::ProcessError error)
+bool AppManager::isLoading() const
 {
-    QString errorMsg;
-
-    if (error == QProcess::FailedToStart) {
-        errorMsg = "Failed to start ADB.\n\n"
-                  "Make sure ADB is installed and in your PATH.\n"
-                  "You can install it as part of Android SDK Platform Tools.";
-    } else {
-        errorMsg = "ADB error: " + adbProcess->errorString();
-    }
-
-    qDebug() << "ADB error:" << errorMsg;
-
-    // Still emit what we have (custom apps)
-    if (!customApps.isEmpty()) {
-        allApps = customApps;
-        emit appsLoaded(allApps);
-    } else {
-        emit loadError(errorMsg);
-    }
+    return appsCommandId != 0;
 }
 
-QString AppManager::packageToName(const QString &packageName)
+void AppManager::loadApps()
 {
-    // Simple conversion: com.example.myapp -> My App
-    QStringList parts = packageName.split('.');
-    if (parts.isEmpty()) {
-        return packageName;
-    }
+    // Other devices' managers may have added custom apps since
+    customApps = CustomAppStore::instance()->apps();
+
+    allApps.clear();
 
-    QString appName = parts.last();
+    // First, add custom apps
+    allApps.append(customApps);
 
-    // Capitalize first letter and add spaces before capitals
-    QString result;
-    for (int i = 0; i < appName.length(); ++i) {
-        QChar c = appName[i];
-        if (i == 0) {
-            result += c.toUpper();
-        } else if (c.isUpper()) {
-            result += ' ' + c;
-        } else {
-            result += c;
+    // Paint the last known package list while adb is queried
+    if (!catalogShown) {
+        catalogShown = true;
+        PackageCatalog catalog(deviceSerial.isEmpty() ? PackageCatalog::lastSerial() : deviceSerial);
+        if (catalog.load() && !catalog.isEmpty()) {
+            qCDebug(lcApp) << "Using cached package catalog for" << catalog.serial()
+                           << "from" << catalog.updatedAt().toString(Qt::ISODate);
+            emit cachedAppsLoaded(PackageParser::buildAppList(catalog.packages(), customApps,
+                                                              catalog.versionCodes()));
         }
     }
 
-    return result;
+    // Then query ADB for installed apps over the shared shell session
+    // --show-versioncode needs Android 9; older pm lists without it
+    qCDebug(lcAdb) << "Running ADB command: pm list packages -3 --show-versioncode";
+    appsTimer.start();
+    appsCommandId = shellSession->execute("echo serial:$(getprop ro.serialno); "
+                                          "echo fingerprint:$(getprop ro.build.fingerprint); "
+                                          "pm list packages -3 --show-versioncode 2>/dev/null | grep '^package:' "
+                                          "|| pm list packages -3");
 }
 
-void AppManager::saveCustomApp(const AppInfo &app)
+void AppManager::onShellCommandFinished(int id, const QByteArray &output, int exitCode)
 {
-    // Check if already exists
-    for (const AppInfo &existing : customApps) {
-        if (existing.packageName == app.packageName) {
-            return; // Already exists
+    if (id == appsCommandId) {
+        appsCommandId = 0;
+        qCDebug(lcAdb) << "pm list packages took" << appsTimer.elapsed() << "ms";
+        Metrics::instance()->observeAdbQuery(Metrics::PackageList, appsTimer.elapsed(), exitCode != 0);
+
+        if (exitCode != 0) {
+            emit loadError("ADB command failed with exit code: " + QString::number(exitCode));
+            return;
         }
+        onAdbFinished(output);
     }
-
-    customApps.append(app);
-    saveCustomApps();
 }
 
-QList<AppInfo> AppManager::getCustomApps()
+void AppManager::onShellCommandFailed(int id, const QString &error)
 {
-    return customApps;
-}
-
-QString AppManager::getConfigFilePath()
-{
-    QString configDir = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
-    QDir dir(configDir);
-    if (!dir.exists()) {
-        dir.mkpath(".");
+    if (id == appsCommandId) {
+        appsCommandId = 0;
+        Metrics::instance()->observeAdbQuery(Metrics::PackageList, appsTimer.elapsed(), true);
+        onAdbError(error);
     }
-    return configDir + "/config.json";
 }
 
-void AppManager::loadCustomApps()
+void AppManager::onAdbFinished(const QByteArray &adbOutput)
 {
-    QString configPath = getConfigFilePath();
-    QFile file(configPath);
+    TRACE_SPAN("AppManager::onAdbFinished");
+    PackageListing listing = PackageParser::parsePackageList(adbOutput);
 
-    if (!file.exists()) {
-        qDebug() << "No config file found at:" << configPath;
-        return;
-    }
+    qCDebug(lcAdb) << "ADB returned" << listing.packages.size() << "packages";
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Failed to open config file:" << configPath;
-        return;
-    }
+    allApps = PackageParser::buildAppList(listing.packages, customApps, listing.versionCodes);
+    // Catalogs are keyed by adb serial; ro.serialno only when no device was picked
+    updateCatalog(deviceSerial.isEmpty() ? listing.serial : deviceSerial, listing);
 
-    QByteArray data = file.readAll();
-    file.close();
+    emit appsLoaded(allApps);
+}
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isObject()) {
-        qDebug() << "Invalid JSON in config file";
+void AppManager::updateCatalog(const QString &serial, const PackageListing &listing)
+{
+    if (serial.isEmpty()) {
         return;
     }
 
-    QJsonObject root = doc.object();
-    QJsonArray appsArray = root["customApps"].toArray();
-
-    for (const QJsonValue &value : appsArray) {
-        QJsonObject appObj = value.toObject();
-        AppInfo app;
-        app.name = appObj["name"].toString();
-        app.packageName = appObj["package"].toString();
-        app.isCustom = true;
-        customApps.append(app);
+    PackageCatalog catalog(serial);
+    catalog.load();
+    if (catalog.fingerprint() != listing.fingerprint || catalog.packages() != listing.packages
+            || catalog.versionCodes() != listing.versionCodes) {
+        catalog.setFingerprint(listing.fingerprint);
+        catalog.setPackages(listing.packages);
+        catalog.setVersionCodes(listing.versionCodes);
+        if (catalog.save()) {
+            qCDebug(lcApp) << "Saved package catalog for" << serial << "with" << listing.packages.size() << "packages";
+        }
     }
 
-    qDebug() << "Loaded" << customApps.size() << "custom apps from config";
+    if (PackageCatalog::lastSerial() != serial) {
+        PackageCatalog::setLastSerial(serial);
+    }
 }
 
-void AppManager::saveCustomApps()
+void AppManager::onAdbError(const QString &errorMsg)
 {
-    QJsonArray appsArray;
-
-    for (const AppInfo &app : customApps) {
-        QJsonObject appObj;
-        appObj["name"] = app.name;
-        appObj["package"] = app.packageName;
-        appsArray.append(appObj);
-    }
-
-    QJsonObject root;
-    root["version"] = "1.0";
-    root["customApps"] = appsArray;
-
-    QJsonDocument doc(root);
-
-    QString configPath = getConfigFilePath();
-    QFile file(configPath);
+    qCDebug(lcAdb) << "ADB error:" << errorMsg;
 
-    if (!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "Failed to save config file:" << configPath;
-        return;
+    // Still emit what we have (custom apps)
+    if (!customApps.isEmpty()) {
+        allApps = customApps;
+        emit appsLoaded(allApps);
+    } else {
+        emit loadError(errorMsg);
     }
+}
 
-    file.write(doc.toJson());
-    file.close();
+void AppManager::saveCustomApp(const AppInfo &app)
+{
+    // Shared with every other device's manager; ignored if already there
+    CustomAppStore::instance()->add(app);
+    customApps = CustomAppStore::instance()->apps();
+}
 
-    qDebug() << "Saved config to:" << configPath;
+QList<AppInfo> AppManager::getCustomApps()
+{
+    return customApps;
 }
 
 void AppManager::loadRunningApps()
 {
-    runningPackages.clear();
-    
-    if (runningAppsProcess) {
-        delete runningAppsProcess;
-    }
-
-    runningAppsProcess = new QProcess(this);
-
-    connect(runningAppsProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &AppManager::onRunningAppsFinished);
-
-    // Use ps command to get running processes
-    // Filter for user apps (u0_) to exclude system processes
-    QStringList arguments;
-    arguments << "shell" << "ps";
-
-    qDebug() << "Running ADB command to get running apps:" << arguments;
-    runningAppsProcess->start("adb", arguments);
+    // Answered by the monitor's next poll, which this pulls forward
+    runningAppsRequested = true;
+    runningMonitor->pollNow();
 }
 
-void AppManager::onRunningAppsFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void AppManager::onRunningAppsPolled()
 {
-    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
-        qDebug() << "Failed to get running apps, exit code:" << exitCode;
-        emit runningAppsLoaded(runningPackages);
-        return;
+    if (runningAppsRequested) {
+        runningAppsRequested = false;
+        emit runningAppsLoaded(runningMonitor->runningPackages());
     }
-
-    QString output = runningAppsProcess->readAllStandardOutput();
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-
-    qDebug() << "Parsing running processes...";
-
-    for (const QString &line : lines) {
-        // Look for package names in process list
-        // Format varies but package names are in the last column
-        QStringList parts = line.simplified().split(' ', Qt::SkipEmptyParts);
-        
-        if (parts.size() > 0) {
-            QString lastPart = parts.last();
-            
-            // Check if it looks like a package name (contains dots)
-            if (lastPart.contains('.') && !lastPart.startsWith('[')) {
-                runningPackages.insert(lastPart);
-            }
-        }
-    }
-
-    qDebug() << "Found" << runningPackages.size() << "running packages";
-    emit runningAppsLoaded(runningPackages);
 }
 
 QSet<QString> AppManager::getRunningPackages() const
 {
-    return runningPackages;
+    return runningMonitor->runningPackages();
+}
+
+RunningAppsMonitor *AppManager::runningAppsMonitor() const
+{
+    return runningMonitor;
 }
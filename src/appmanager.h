@@ -5,52 +5,70 @@
 #include <QString>
 #include <QList>
 #include <QSet>
-#include <QProcess>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QElapsedTimer>
+#include "adbclient.h"
+#include "adbshellsession.h"
+#include "runningappsmonitor.h"
+
+struct PackageListing;
 
 struct AppInfo {
     QString packageName;
     QString name;
     bool isCustom = false;
+    qint64 versionCode = 0;  // 0 when unknown
 };
+Q_DECLARE_TYPEINFO(AppInfo, Q_RELOCATABLE_TYPE);
 
 class AppManager : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AppManager(QObject *parent = nullptr);
+    // serial may be empty to use whichever single device is attached
+    AppManager(AdbClient *client, const QString &serial, QObject *parent = nullptr);
     ~AppManager();
 
+    QString serial() const;
+    QList<AppInfo> apps() const;
+    bool isLoading() const;
+
     void loadApps();
     void loadRunningApps();
     void saveCustomApp(const AppInfo &app);
     QList<AppInfo> getCustomApps();
     QSet<QString> getRunningPackages() const;
+    RunningAppsMonitor *runningAppsMonitor() const;
 
 signals:
     void appsLoaded(const QList<AppInfo> &apps);
+    void cachedAppsLoaded(const QList<AppInfo> &apps);
     void loadError(const QString &error);
     void runningAppsLoaded(const QSet<QString> &packages);
 
 private slots:
-    void onAdbFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onAdbError(QProcess::ProcessError error);
-    void onRunningAppsFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onShellCommandFinished(int id, const QByteArray &output, int exitCode);
+    void onShellCommandFailed(int id, const QString &error);
+    void onRunningAppsPolled();
 
 private:
-    void loadCustomApps();
-    void saveCustomApps();
-    QString getConfigFilePath();
-    QString packageToName(const QString &packageName);
+    void onAdbFinished(const QByteArray &adbOutput);
+    void onAdbError(const QString &errorMsg);
+    void updateCatalog(const QString &serial, const PackageListing &listing);
 
-    QProcess *adbProcess;
-    QProcess *runningAppsProcess;
+    AdbClient *adbClient;
+    QString deviceSerial;
+    AdbShellSession *shellSession;
+    int appsCommandId;
+    RunningAppsMonitor *runningMonitor;
+    bool runningAppsRequested;
+    QElapsedTimer appsTimer;
+    bool catalogShown;
     QList<AppInfo> customApps;
     QList<AppInfo> allApps;
-    QSet<QString> runningPackages;
 };
 
 #endif // APPMANAGER_H
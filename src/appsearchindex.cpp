@@ -0,0 +1,258 @@
+#include "appsearchindex.h"
+#include <algorithm>
+
+namespace {
+const int COMPACT_MIN_DEAD = 1024;
+
+inline quint64 trigramKey(const QChar *c)
+{
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | c[2].unicode();
+}
+
+bool isWordStart(const QString &text, int pos)
+{
+    return pos == 0 || !text.at(pos - 1).isLetterOrNumber();
+}
+}
+
+AppSearchIndex::AppSearchIndex()
+    : deadCount(0)
+{
+}
+
+void AppSearchIndex::insert(const QString &packageName, const QString &name)
+{
+    if (idByPackage.contains(packageName)) {
+        remove(packageName);
+    }
+
+    Document doc;
+    doc.packageName = packageName;
+    doc.name = name.toLower();
+    doc.package = packageName.toLower();
+    doc.trigrams = trigramsOf(doc.name) + trigramsOf(doc.package);
+    std::sort(doc.trigrams.begin(), doc.trigrams.end());
+    doc.trigrams.erase(std::unique(doc.trigrams.begin(), doc.trigrams.end()), doc.trigrams.end());
+
+    // Ids only grow, so appending keeps every posting list sorted
+    int id = docs.size();
+    for (quint64 trigram : doc.trigrams) {
+        postings[trigram].append(id);
+    }
+    docs.append(doc);
+    idByPackage.insert(packageName, id);
+    lastQuery.clear();
+}
+
+void AppSearchIndex::remove(const QString &packageName)
+{
+    auto it = idByPackage.find(packageName);
+    if (it == idByPackage.end()) {
+        return;
+    }
+
+    int id = it.value();
+    idByPackage.erase(it);
+
+    Document &doc = docs[id];
+    for (quint64 trigram : doc.trigrams) {
+        auto posting = postings.find(trigram);
+        if (posting == postings.end()) {
+            continue;
+        }
+        QList<int> &ids = posting.value();
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        if (pos != ids.end() && *pos == id) {
+            ids.erase(pos);
+        }
+        if (ids.isEmpty()) {
+            postings.erase(posting);
+        }
+    }
+    doc = Document();
+    doc.alive = false;
+    ++deadCount;
+    lastQuery.clear();
+
+    if (deadCount >= COMPACT_MIN_DEAD && deadCount * 2 > docs.size()) {
+        compact();
+    }
+}
+
+void AppSearchIndex::clear()
+{
+    docs.clear();
+    idByPackage.clear();
+    postings.clear();
+    deadCount = 0;
+    lastQuery.clear();
+    lastMatches.clear();
+}
+
+int AppSearchIndex::size() const
+{
+    return idByPackage.size();
+}
+
+QHash<QString, int> AppSearchIndex::search(const QString &query)
+{
+    QHash<QString, int> result;
+    QString q = query.trimmed().toLower();
+    if (q.isEmpty()) {
+        lastQuery.clear();
+        lastMatches.clear();
+        return result;
+    }
+
+    // Exact tier: a match for q is also a match for any prefix of q
+    QList<int> candidates;
+    bool narrowing = !lastQuery.isEmpty() && q.startsWith(lastQuery);
+    QList<quint64> queryTrigrams = trigramsOf(q);
+    std::sort(queryTrigrams.begin(), queryTrigrams.end());
+    queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+    if (narrowing) {
+        candidates = lastMatches;
+    } else if (!queryTrigrams.isEmpty()) {
+        // Intersect posting lists, rarest first
+        QList<const QList<int> *> lists;
+        for (quint64 trigram : queryTrigrams) {
+            auto posting = postings.constFind(trigram);
+            if (posting == postings.constEnd()) {
+                lists.clear();
+                break;
+            }
+            lists.append(&posting.value());
+        }
+        std::sort(lists.begin(), lists.end(), [](const QList<int> *a, const QList<int> *b) {
+            return a->size() < b->size();
+        });
+        if (!lists.isEmpty()) {
+            candidates = *lists.first();
+            for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+                QList<int> narrowed;
+                std::set_intersection(candidates.cbegin(), candidates.cend(),
+                                      lists.at(i)->cbegin(), lists.at(i)->cend(),
+                                      std::back_inserter(narrowed));
+                candidates.swap(narrowed);
+            }
+        }
+    } else {
+        candidates.reserve(docs.size());
+        for (int id = 0; id < docs.size(); ++id) {
+            candidates.append(id);
+        }
+    }
+
+    QList<int> matches;
+    for (int id : std::as_const(candidates)) {
+        const Document &doc = docs.at(id);
+        if (!doc.alive) {
+            continue;
+        }
+        int score = matchScore(doc, q);
+        if (score > 0) {
+            matches.append(id);
+            result.insert(doc.packageName, score);
+        }
+    }
+    lastQuery = q;
+    lastMatches = matches;
+
+    // Fuzzy tier: enough shared trigrams to survive a typo or two
+    int queryCount = queryTrigrams.size();
+    if (queryCount >= 3) {
+        QList<quint8> shared(docs.size(), 0);
+        QList<int> touched;
+        for (quint64 trigram : std::as_const(queryTrigrams)) {
+            auto posting = postings.constFind(trigram);
+            if (posting == postings.constEnd()) {
+                continue;
+            }
+            for (int id : posting.value()) {
+                quint8 &count = shared[id];
+                if (count == 0) {
+                    touched.append(id);
+                }
+                if (count < 255) {
+                    ++count;
+                }
+            }
+        }
+
+        for (int id : std::as_const(touched)) {
+            int count = qMin<int>(shared.at(id), queryCount);
+            if (count < 2 || count * 2 < queryCount) {
+                continue;
+            }
+            const Document &doc = docs.at(id);
+            if (result.contains(doc.packageName)) {
+                continue;
+            }
+            int score = (100 + count * 200 / queryCount) * 100 - qMin<int>(doc.name.size(), 99);
+            result.insert(doc.packageName, score);
+        }
+    }
+
+    return result;
+}
+
+QList<quint64> AppSearchIndex::trigramsOf(const QString &text)
+{
+    QList<quint64> trigrams;
+    if (text.size() < 3) {
+        return trigrams;
+    }
+
+    trigrams.reserve(text.size() - 2);
+    const QChar *data = text.constData();
+    for (int i = 0; i + 2 < text.size(); ++i) {
+        trigrams.append(trigramKey(data + i));
+    }
+    return trigrams;
+}
+
+// Prefix > word start > anywhere in the name > package segment > anywhere in
+// the package; shorter names win ties.
+int AppSearchIndex::matchScore(const Document &doc, const QString &query)
+{
+    int score = 0;
+    int pos = doc.name.indexOf(query);
+    if (pos == 0) {
+        score = 1000;
+    } else if (pos > 0) {
+        score = isWordStart(doc.name, pos) ? 800 : 600;
+    } else {
+        pos = doc.package.indexOf(query);
+        if (pos < 0) {
+            return 0;
+        }
+        score = (pos == 0 || doc.package.at(pos - 1) == '.') ? 500 : 400;
+    }
+    return score * 100 - qMin<int>(doc.name.size(), 99);
+}
+
+void AppSearchIndex::compact()
+{
+    QList<Document> alive;
+    alive.reserve(idByPackage.size());
+    for (Document &doc : docs) {
+        if (doc.alive) {
+            alive.append(std::move(doc));
+        }
+    }
+
+    docs.clear();
+    idByPackage.clear();
+    postings.clear();
+    deadCount = 0;
+
+    for (int id = 0; id < alive.size(); ++id) {
+        for (quint64 trigram : alive.at(id).trigrams) {
+            postings[trigram].append(id);
+        }
+        idByPackage.insert(alive.at(id).packageName, id);
+    }
+    docs = std::move(alive);
+    lastQuery.clear();
+}
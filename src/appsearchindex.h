@@ -0,0 +1,51 @@
+#ifndef APPSEARCHINDEX_H
+#define APPSEARCHINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+
+// Trigram index over app display names and package names.
+//
+// Queries of three or more characters are answered from the posting lists:
+// documents holding every query trigram are verified as substring matches,
+// and documents holding at least half of them (and two or more) are kept as
+// typo-tolerant fuzzy matches. Shorter queries scan the documents, narrowing
+// from the previous result set when the query only grew.
+class AppSearchIndex
+{
+public:
+    AppSearchIndex();
+
+    void insert(const QString &packageName, const QString &name);
+    void remove(const QString &packageName);
+    void clear();
+    int size() const;
+
+    // Package name -> score; higher ranks first
+    QHash<QString, int> search(const QString &query);
+
+private:
+    struct Document {
+        QString packageName;
+        QString name;     // lowercased
+        QString package;  // lowercased
+        QList<quint64> trigrams;
+        bool alive = true;
+    };
+
+    static QList<quint64> trigramsOf(const QString &text);
+    static int matchScore(const Document &doc, const QString &query);
+    void compact();
+
+    QList<Document> docs;
+    QHash<QString, int> idByPackage;
+    QHash<quint64, QList<int>> postings;
+    int deadCount;
+
+    // Incremental narrowing for the scan path
+    QString lastQuery;
+    QList<int> lastMatches;
+};
+
+#endif // APPSEARCHINDEX_H
@@ -0,0 +1,48 @@
+#include "controlclient.h"
+#include "controlserver.h"
+#include <QLocalSocket>
+#include <QDeadlineTimer>
+
+bool ControlClient::send(const QList<QByteArray> &commands, QList<QByteArray> *replies, int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+
+    QLocalSocket socket;
+    socket.connectToServer(ControlServer::serverName());
+    if (!socket.waitForConnected(int(deadline.remainingTime()))) {
+        return false;
+    }
+
+    QByteArray out;
+    for (const QByteArray &command : commands) {
+        out += command.trimmed();
+        out += '\n';
+    }
+    socket.write(out);
+    if (!socket.waitForBytesWritten(int(deadline.remainingTime()))) {
+        return false;
+    }
+
+    while (replies->size() < commands.size()) {
+        while (socket.canReadLine() && replies->size() < commands.size()) {
+            replies->append(socket.readLine().trimmed());
+        }
+        if (replies->size() < commands.size()
+                && (deadline.hasExpired() || !socket.waitForReadyRead(int(deadline.remainingTime())))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ControlClient::send(const QByteArray &command, QByteArray *reply, int timeoutMs)
+{
+    QList<QByteArray> replies;
+    if (!send(QList<QByteArray> { command }, &replies, timeoutMs)) {
+        return false;
+    }
+    if (reply) {
+        *reply = replies.value(0);
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#ifndef CONTROLCLIENT_H
+#define CONTROLCLIENT_H
+
+#include <QByteArray>
+#include <QList>
+
+// Thin, blocking client for ControlServer, used by `--control` and by a
+// second start of the GUI. Needs no event loop.
+class ControlClient
+{
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 1000;
+
+    // Sends the commands on one connection and collects one reply line per
+    // command. Returns false if no instance is running or it stops answering.
+    static bool send(const QList<QByteArray> &commands, QList<QByteArray> *replies,
+                     int timeoutMs = DEFAULT_TIMEOUT_MS);
+    static bool send(const QByteArray &command, QByteArray *reply = nullptr,
+                     int timeoutMs = DEFAULT_TIMEOUT_MS);
+};
+
+#endif // CONTROLCLIENT_H
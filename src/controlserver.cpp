@@ -0,0 +1,181 @@
+#include "controlserver.h"
+#include "sessionmanager.h"
+#include "profilestore.h"
+#include "logger.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace {
+
+const char *stateName(ScrcpySession::State state)
+{
+    switch (state) {
+    case ScrcpySession::Starting: return "starting";
+    case ScrcpySession::Running: return "running";
+    case ScrcpySession::Stopping: return "stopping";
+    case ScrcpySession::Finished: return "finished";
+    case ScrcpySession::Failed: return "failed";
+    }
+    return "unknown";
+}
+
+QByteArray reply(QJsonObject object)
+{
+    object["ok"] = true;
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+QByteArray error(const QString &message)
+{
+    return QJsonDocument(QJsonObject { { "ok", false }, { "error", message } }).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+ControlServer::ControlServer(SessionManager *sessions, QObject *parent)
+    : QObject(parent)
+    , server(new QLocalServer(this))
+    , sessionManager(sessions)
+{
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &ControlServer::onNewConnection);
+}
+
+QString ControlServer::serverName()
+{
+    QString user = qEnvironmentVariable("USER", qEnvironmentVariable("USERNAME"));
+    return "scrcpy-gui-" + user;
+}
+
+QString ControlServer::instanceLockPath()
+{
+    return QDir::tempPath() + "/" + serverName() + ".lock";
+}
+
+bool ControlServer::listen()
+{
+    QString name = serverName();
+    if (server->listen(name)) {
+        qCDebug(lcApp) << "Control socket listening on" << server->fullServerName();
+        return true;
+    }
+
+    // Either another instance, or a socket file left behind by a crash
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(100)) {
+        qCWarning(lcApp) << "Another instance owns the control socket" << name;
+        return false;
+    }
+    QLocalServer::removeServer(name);
+    if (!server->listen(name)) {
+        qCWarning(lcApp) << "Control socket unavailable:" << server->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ControlServer::isListening() const
+{
+    return server->isListening();
+}
+
+void ControlServer::onNewConnection()
+{
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, &ControlServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void ControlServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    // Pipelined commands are answered in one write
+    QByteArray out;
+    while (socket->canReadLine()) {
+        out += handle(socket->readLine().trimmed());
+        out += '\n';
+    }
+    if (!out.isEmpty()) {
+        socket->write(out);
+    }
+}
+
+QByteArray ControlServer::handle(const QByteArray &line)
+{
+    QList<QByteArray> words = line.simplified().split(' ');
+    QByteArray command = words.value(0);
+    // Profile names may contain spaces; they are always the last argument
+    auto rest = [&words](int from) {
+        return QString::fromUtf8(words.mid(from).join(' '));
+    };
+
+    if (command == "ping") {
+        return reply({});
+    }
+    if (command == "show") {
+        emit showRequested();
+        return reply({});
+    }
+    if (command == "refresh") {
+        emit refreshRequested();
+        return reply({});
+    }
+
+    if (command == "sessions") {
+        QJsonArray array;
+        for (ScrcpySession *session : sessionManager->sessions()) {
+            array.append(QJsonObject {
+                { "id", session->id() },
+                { "serial", session->serial() },
+                { "package", session->packageName() },
+                { "state", QLatin1String(stateName(session->state())) },
+                { "pid", session->processId() },
+                { "uptimeMs", session->uptimeMs() }
+            });
+        }
+        return reply({ { "sessions", array } });
+    }
+
+    if (command == "launch" && words.size() >= 2) {
+        QString profileName = rest(2);
+        if (!profileName.isEmpty() && !ProfileStore::instance()->profileNames().contains(profileName)) {
+            return error("Unknown profile: " + profileName);
+        }
+        emit launchRequested(QString::fromUtf8(words.at(1)), profileName);
+        return reply({});
+    }
+
+    if (command == "stop" && words.size() == 2) {
+        if (words.at(1) == "all") {
+            sessionManager->stopAll();
+            return reply({});
+        }
+        bool ok = false;
+        int id = words.at(1).toInt(&ok);
+        if (!ok || !sessionManager->stopSession(id)) {
+            return error("No active session " + QString::fromUtf8(words.at(1)));
+        }
+        return reply({});
+    }
+
+    if (command == "profile" && words.size() >= 2) {
+        QString profileName = rest(2);
+        if (!profileName.isEmpty() && !ProfileStore::instance()->profileNames().contains(profileName)) {
+            return error("Unknown profile: " + profileName);
+        }
+        ProfileStore::instance()->setOverride(QString::fromUtf8(words.at(1)), profileName);
+        return reply({});
+    }
+
+    return error("Unknown command: " + QString::fromUtf8(line));
+}
@@ -0,0 +1,56 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+class QLocalServer;
+class QLocalSocket;
+class SessionManager;
+
+// Local control socket of the running GUI. The GUI that holds
+// instanceLockPath() owns it; a second start forwards to it and exits.
+//
+// One command per line, one compact JSON reply per line, in order:
+//   ping | show | refresh | sessions
+//   launch PACKAGE [PROFILE]
+//   stop ID|all
+//   profile PACKAGE [PROFILE]     (per-app override; no profile removes it)
+// Replies are {"ok":true,...} or {"ok":false,"error":"..."}. Launch, show and
+// refresh are handed to the window through signals and acknowledged as
+// accepted.
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControlServer(SessionManager *sessions, QObject *parent = nullptr);
+
+    // Per user, so two accounts on one machine don't see each other
+    static QString serverName();
+    // Held by the GUI for its whole run
+    static QString instanceLockPath();
+
+    // False if another instance already listens
+    bool listen();
+    bool isListening() const;
+
+    // Answers one command line; usable without a socket
+    QByteArray handle(const QByteArray &line);
+
+signals:
+    void showRequested();
+    void refreshRequested();
+    void launchRequested(const QString &packageName, const QString &profileName);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    QLocalServer *server;
+    SessionManager *sessionManager;
+};
+
+#endif // CONTROLSERVER_H
@@ -0,0 +1,417 @@
+#include "customappstore.h"
+#include "logger.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCborMap>
+#include <QCborArray>
+#include <QCborValue>
+#include <QCborStreamReader>
+
+namespace {
+
+constexpr int SNAPSHOT_VERSION = 1;
+
+} // namespace
+
+CustomAppStore *CustomAppStore::instance()
+{
+    static CustomAppStore *store = new CustomAppStore();
+    return store;
+}
+
+CustomAppStore::CustomAppStore(QObject *parent)
+    : QObject(parent)
+    , dir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation))
+    , loaded(false)
+    , flushTimer(new QTimer(this))
+    , dirty(false)
+    , flushing(false)
+{
+    flushPool.setMaxThreadCount(1);
+    flushTimer->setSingleShot(true);
+    connect(flushTimer, &QTimer::timeout, this, &CustomAppStore::flush);
+}
+
+void CustomAppStore::setDirectory(const QString &path)
+{
+    dir = path;
+    loaded = false;
+}
+
+QString CustomAppStore::directory() const
+{
+    return dir;
+}
+
+QString CustomAppStore::jsonPath() const
+{
+    return dir + "/config.json";
+}
+
+QString CustomAppStore::cborPath() const
+{
+    return dir + "/config.cbor";
+}
+
+QString CustomAppStore::journalPath() const
+{
+    return dir + "/config.journal";
+}
+
+QString CustomAppStore::rotatedJournalPath() const
+{
+    return dir + "/config.journal.old";
+}
+
+bool CustomAppStore::isLoaded() const
+{
+    return loaded;
+}
+
+void CustomAppStore::load()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    customApps.clear();
+    indexByPackage.clear();
+
+    const char *source = "cbor";
+    if (!loadSnapshot()) {
+        source = loadJson() ? "json" : "none";
+    }
+
+    // Changes made after the last completed flush
+    int before = customApps.size();
+    replayJournal(rotatedJournalPath());
+    replayJournal(journalPath());
+    if (QFile::exists(rotatedJournalPath()) || QFileInfo(journalPath()).size() > 0) {
+        dirty = true;
+        scheduleFlush();
+    }
+
+    loaded = true;
+    qCDebug(lcApp) << "Loaded" << customApps.size() << "custom apps from" << source
+                   << "(" << customApps.size() - before << "from journal ) in" << timer.elapsed() << "ms";
+}
+
+bool CustomAppStore::loadSnapshot()
+{
+    QFile file(cborPath());
+    QFileInfo json(jsonPath());
+    if (!json.exists() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QCborMap root = QCborValue::fromCbor(file.readAll()).toMap();
+    // Only valid for the exact config.json it was written with
+    if (root.value(QStringLiteral("version")).toInteger() != SNAPSHOT_VERSION
+            || root.value(QStringLiteral("jsonSize")).toInteger() != json.size()
+            || root.value(QStringLiteral("jsonModified")).toInteger() != json.lastModified().toMSecsSinceEpoch()) {
+        qCDebug(lcApp) << "Custom app snapshot is stale, reading config.json";
+        return false;
+    }
+
+    const QCborArray apps = root.value(QStringLiteral("apps")).toArray();
+    customApps.reserve(apps.size());
+    for (const QCborValue &entry : apps) {
+        QCborArray fields = entry.toArray();
+        AppInfo app;
+        app.packageName = fields.at(0).toString();
+        app.name = fields.at(1).toString();
+        app.isCustom = true;
+        apply(Add, app);
+    }
+    return true;
+}
+
+bool CustomAppStore::loadJson()
+{
+    QFile file(jsonPath());
+    if (!file.exists()) {
+        qCDebug(lcApp) << "No config file found at:" << jsonPath();
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(lcApp) << "Failed to open config file:" << jsonPath();
+        return false;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        qCDebug(lcApp) << "Invalid JSON in config file";
+        return false;
+    }
+
+    const QJsonArray appsArray = doc.object()["customApps"].toArray();
+    customApps.reserve(appsArray.size());
+    for (const QJsonValue &value : appsArray) {
+        QJsonObject appObj = value.toObject();
+        AppInfo app;
+        app.name = appObj["name"].toString();
+        app.packageName = appObj["package"].toString();
+        app.isCustom = true;
+        apply(Add, app);
+    }
+
+    // Next flush writes a snapshot matching this file
+    if (!QFile::exists(cborPath()) || !appsArray.isEmpty()) {
+        dirty = true;
+        scheduleFlush();
+    }
+    return true;
+}
+
+void CustomAppStore::replayJournal(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // A crash mid-append leaves a torn last record; stop there
+    QCborStreamReader reader(file.readAll());
+    while (reader.lastError() == QCborError::NoError && reader.isValid()) {
+        QCborArray record = QCborValue::fromCbor(reader).toArray();
+        if (reader.lastError() != QCborError::NoError) {
+            qCDebug(lcApp) << "Ignoring torn record at the end of" << path;
+            break;
+        }
+        AppInfo app;
+        app.packageName = record.at(1).toString();
+        app.name = record.at(2).toString();
+        app.isCustom = true;
+        apply(Op(record.at(0).toInteger()), app);
+    }
+}
+
+void CustomAppStore::apply(Op op, const AppInfo &app)
+{
+    if (app.packageName.isEmpty()) {
+        return;
+    }
+
+    // Idempotent, so replaying a journal twice is harmless
+    if (op == Add) {
+        if (!indexByPackage.contains(app.packageName)) {
+            indexByPackage.insert(app.packageName, customApps.size());
+            customApps.append(app);
+        }
+    } else if (op == Remove) {
+        auto it = indexByPackage.find(app.packageName);
+        if (it == indexByPackage.end()) {
+            return;
+        }
+        int row = it.value();
+        indexByPackage.erase(it);
+        customApps.removeAt(row);
+        for (int i = row; i < customApps.size(); ++i) {
+            indexByPackage[customApps.at(i).packageName] = i;
+        }
+    }
+}
+
+QList<AppInfo> CustomAppStore::apps() const
+{
+    return customApps;
+}
+
+bool CustomAppStore::contains(const QString &packageName) const
+{
+    return indexByPackage.contains(packageName);
+}
+
+bool CustomAppStore::add(const AppInfo &app)
+{
+    if (!loaded) {
+        load();
+    }
+    if (app.packageName.isEmpty() || contains(app.packageName)) {
+        return false;
+    }
+
+    AppInfo custom = app;
+    custom.isCustom = true;
+    apply(Add, custom);
+    appendJournal(Add, custom);
+    scheduleFlush();
+    emit appsChanged();
+    return true;
+}
+
+bool CustomAppStore::remove(const QString &packageName)
+{
+    if (!loaded) {
+        load();
+    }
+    if (!contains(packageName)) {
+        return false;
+    }
+
+    AppInfo app;
+    app.packageName = packageName;
+    apply(Remove, app);
+    appendJournal(Remove, app);
+    scheduleFlush();
+    emit appsChanged();
+    return true;
+}
+
+void CustomAppStore::appendJournal(Op op, const AppInfo &app)
+{
+    QDir().mkpath(dir);
+    QFile file(journalPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(lcApp) << "Failed to append to" << journalPath() << ":" << file.errorString();
+        return;
+    }
+    file.write(QCborArray { int(op), app.packageName, app.name }.toCborValue().toCbor());
+    dirty = true;
+}
+
+void CustomAppStore::scheduleFlush()
+{
+    // Debounced, but a steady stream of changes still flushes every MAX_FLUSH_DELAY_MS
+    if (!flushTimer->isActive()) {
+        firstPendingChange.start();
+    }
+    qint64 remaining = MAX_FLUSH_DELAY_MS - firstPendingChange.elapsed();
+    flushTimer->start(int(qBound<qint64>(0, remaining, FLUSH_DELAY_MS)));
+}
+
+bool CustomAppStore::rotateJournal()
+{
+    // Appends from here on go to a fresh journal; the rotated one is deleted
+    // once the snapshot that contains it is on disk
+    if (!QFile::exists(journalPath())) {
+        return true;
+    }
+    if (!QFile::exists(rotatedJournalPath())) {
+        return QFile::rename(journalPath(), rotatedJournalPath());
+    }
+
+    // An earlier flush failed; keep both sets of records
+    QFile rotated(rotatedJournalPath());
+    QFile current(journalPath());
+    if (!rotated.open(QIODevice::WriteOnly | QIODevice::Append) || !current.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    rotated.write(current.readAll());
+    current.close();
+    return current.remove();
+}
+
+void CustomAppStore::flush()
+{
+    if (!dirty) {
+        return;
+    }
+    if (flushing) {
+        // Picked up again when the running flush reports back
+        return;
+    }
+    if (!rotateJournal()) {
+        qCWarning(lcApp) << "Could not rotate" << journalPath() << ", retrying later";
+        scheduleFlush();
+        return;
+    }
+
+    dirty = false;
+    flushing = true;
+
+    QString json = jsonPath();
+    QString cbor = cborPath();
+    QList<AppInfo> snapshot = customApps;
+    flushPool.start([this, json, cbor, snapshot]() {
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = writeFiles(json, cbor, snapshot);
+        qint64 ms = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, ok, ms]() { onFlushDone(ok, ms); }, Qt::QueuedConnection);
+    });
+}
+
+void CustomAppStore::onFlushDone(bool ok, qint64 ms)
+{
+    flushing = false;
+    if (ok) {
+        QFile::remove(rotatedJournalPath());
+        qCDebug(lcApp) << "Flushed" << customApps.size() << "custom apps in" << ms << "ms";
+        emit flushed(ms);
+    } else {
+        // The rotated journal still holds the changes; retry after a pause,
+        // and sync() retries at exit
+        qCWarning(lcApp) << "Failed to save custom apps to" << jsonPath() << ", retrying later";
+        dirty = true;
+        flushTimer->start(FLUSH_RETRY_MS);
+        return;
+    }
+
+    if (dirty) {
+        scheduleFlush();
+    }
+}
+
+void CustomAppStore::sync()
+{
+    flushTimer->stop();
+    flushPool.waitForDone();
+    if (!dirty && !flushing) {
+        return;
+    }
+
+    if (rotateJournal() && writeFiles(jsonPath(), cborPath(), customApps)) {
+        QFile::remove(rotatedJournalPath());
+        dirty = false;
+    }
+}
+
+bool CustomAppStore::writeFiles(const QString &jsonPath, const QString &cborPath, const QList<AppInfo> &apps)
+{
+    QDir().mkpath(QFileInfo(jsonPath).absolutePath());
+
+    QJsonArray appsArray;
+    for (const AppInfo &app : apps) {
+        QJsonObject appObj;
+        appObj["name"] = app.name;
+        appObj["package"] = app.packageName;
+        appsArray.append(appObj);
+    }
+    QJsonObject root;
+    root["version"] = "1.0";
+    root["customApps"] = appsArray;
+
+    QSaveFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    json.write(QJsonDocument(root).toJson());
+    if (!json.commit()) {
+        return false;
+    }
+
+    // Tie the snapshot to the JSON just written
+    QFileInfo written(jsonPath);
+    QCborArray cborApps;
+    for (const AppInfo &app : apps) {
+        cborApps.append(QCborArray { app.packageName, app.name });
+    }
+    QCborMap snapshot;
+    snapshot[QStringLiteral("version")] = SNAPSHOT_VERSION;
+    snapshot[QStringLiteral("jsonSize")] = written.size();
+    snapshot[QStringLiteral("jsonModified")] = written.lastModified().toMSecsSinceEpoch();
+    snapshot[QStringLiteral("apps")] = cborApps;
+
+    QSaveFile cbor(cborPath);
+    if (!cbor.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    cbor.write(snapshot.toCborValue().toCbor());
+    return cbor.commit();
+}
@@ -0,0 +1,88 @@
+#ifndef CUSTOMAPPSTORE_H
+#define CUSTOMAPPSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include "appmanager.h"
+
+// The user's manually added apps, shared by every device's AppManager.
+//
+// config.json stays the readable source of truth; config.cbor is a snapshot
+// of it that loads without JSON parsing while config.json is unchanged.
+// Changes are appended to config.journal as they happen and folded into both
+// files by a debounced flush on a pool thread, written with QSaveFile so a
+// crash leaves either the old or the new file. A journal that outlived its
+// flush is replayed on the next load.
+class CustomAppStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FLUSH_DELAY_MS = 2000;
+    static constexpr int MAX_FLUSH_DELAY_MS = 10000;
+    static constexpr int FLUSH_RETRY_MS = 10000;
+
+    static CustomAppStore *instance();
+
+    // Directory of the files; defaults to AppConfigLocation
+    void setDirectory(const QString &path);
+    QString directory() const;
+
+    void load();
+    bool isLoaded() const;
+
+    QList<AppInfo> apps() const;
+    bool contains(const QString &packageName) const;
+    // Returns false if the package is already there
+    bool add(const AppInfo &app);
+    bool remove(const QString &packageName);
+
+    // Writes pending changes now and waits for them; for exit
+    void sync();
+
+signals:
+    void appsChanged();
+    void flushed(qint64 ms);
+
+private slots:
+    void flush();
+
+private:
+    enum Op { Add = 1, Remove = 2 };
+
+    explicit CustomAppStore(QObject *parent = nullptr);
+
+    QString jsonPath() const;
+    QString cborPath() const;
+    QString journalPath() const;
+    QString rotatedJournalPath() const;
+
+    bool loadSnapshot();
+    bool loadJson();
+    void replayJournal(const QString &path);
+    void appendJournal(Op op, const AppInfo &app);
+    void apply(Op op, const AppInfo &app);
+    void scheduleFlush();
+    bool rotateJournal();
+    void onFlushDone(bool ok, qint64 ms);
+
+    static bool writeFiles(const QString &jsonPath, const QString &cborPath, const QList<AppInfo> &apps);
+
+    QString dir;
+    bool loaded;
+    QList<AppInfo> customApps;
+    QHash<QString, int> indexByPackage;
+
+    QTimer *flushTimer;
+    QThreadPool flushPool;
+    QElapsedTimer firstPendingChange;
+    bool dirty;
+    bool flushing;
+};
+
+#endif // CUSTOMAPPSTORE_H
@@ -0,0 +1,215 @@
+#include "devicemanager.h"
+#include <QSettings>
+#include "adbclient.h"
+#include "adbreply.h"
+#include "logger.h"
+#include "toolpaths.h"
+
+QString DeviceInfo::displayName() const
+{
+    if (model.isEmpty()) {
+        return serial;
+    }
+    return QString(model).replace('_', ' ') + " (" + serial + ")";
+}
+
+DeviceManager::DeviceManager(QObject *parent)
+    : QObject(parent)
+    , adbClient(new AdbClient(this))
+    , devicesReply(nullptr)
+    , appsAfterDevices(false)
+    , parallelLimit(DEFAULT_MAX_PARALLEL)
+    , refreshCount(0)
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    adbClient->setProgram(ToolPaths::adb());
+    adbClient->setServerAddress("127.0.0.1", ToolPaths::adbServerPort());
+    adbClient->setServerEnabled(ToolPaths::adbServerEnabled());
+    setMaxParallel(settings.value("adb-max-parallel", DEFAULT_MAX_PARALLEL).toInt());
+}
+
+AdbClient *DeviceManager::client() const
+{
+    return adbClient;
+}
+
+QList<DeviceInfo> DeviceManager::devices() const
+{
+    return deviceList;
+}
+
+DeviceInfo DeviceManager::device(const QString &serial) const
+{
+    for (const DeviceInfo &info : deviceList) {
+        if (info.serial == serial) {
+            return info;
+        }
+    }
+    return DeviceInfo();
+}
+
+AppManager *DeviceManager::appManager(const QString &serial)
+{
+    AppManager *manager = managers.value(serial);
+    if (manager) {
+        return manager;
+    }
+
+    manager = new AppManager(adbClient, serial, this);
+    connect(manager, &AppManager::appsLoaded, this, [this, serial](const QList<AppInfo> &apps) {
+        emit deviceAppsLoaded(serial, apps);
+        onDeviceDone(serial);
+    });
+    connect(manager, &AppManager::loadError, this, [this, serial](const QString &error) {
+        emit deviceAppsFailed(serial, error);
+        onDeviceDone(serial);
+    });
+    managers.insert(serial, manager);
+    return manager;
+}
+
+int DeviceManager::maxParallel() const
+{
+    return parallelLimit;
+}
+
+void DeviceManager::setMaxParallel(int count)
+{
+    parallelLimit = qMax(1, count);
+    startQueued();
+}
+
+void DeviceManager::refresh()
+{
+    appsAfterDevices = true;
+    refreshDevices();
+}
+
+void DeviceManager::refreshDevices()
+{
+    if (devicesReply) {
+        return;
+    }
+
+    devicesReply = adbClient->hostQuery("host:devices-l", {"devices", "-l"});
+    connect(devicesReply, &AdbReply::finished, this, &DeviceManager::onDevicesReplyFinished);
+}
+
+void DeviceManager::refreshApps()
+{
+    for (const DeviceInfo &info : std::as_const(deviceList)) {
+        if (info.isReady() && !inFlight.contains(info.serial) && !queue.contains(info.serial)) {
+            queue.append(info.serial);
+        }
+    }
+
+    refreshCount = queue.size() + inFlight.size();
+    refreshTimer.start();
+    if (refreshCount == 0) {
+        emit refreshFinished(0, 0);
+        return;
+    }
+    startQueued();
+}
+
+void DeviceManager::onDevicesReplyFinished()
+{
+    AdbReply *reply = devicesReply;
+    devicesReply = nullptr;
+    reply->deleteLater();
+
+    bool loadApps = appsAfterDevices;
+    appsAfterDevices = false;
+
+    if (reply->error() != AdbReply::NoError) {
+        qCDebug(lcAdb) << "Listing devices failed:" << reply->errorString();
+        emit deviceError(reply->errorString());
+        return;
+    }
+
+    deviceList = parseDeviceList(reply->output());
+    qCDebug(lcAdb) << "Found" << deviceList.size() << "devices in" << reply->elapsed() << "ms";
+
+    // Forget managers for devices that went away
+    QSet<QString> present;
+    for (const DeviceInfo &info : std::as_const(deviceList)) {
+        present.insert(info.serial);
+    }
+    for (auto it = managers.begin(); it != managers.end();) {
+        if (!it.key().isEmpty() && !present.contains(it.key())) {
+            queue.removeAll(it.key());
+            inFlight.remove(it.key());
+            it.value()->deleteLater();
+            it = managers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    emit devicesChanged(deviceList);
+
+    if (loadApps) {
+        refreshApps();
+    }
+}
+
+void DeviceManager::startQueued()
+{
+    while (inFlight.size() < parallelLimit && !queue.isEmpty()) {
+        QString serial = queue.takeFirst();
+        inFlight.insert(serial);
+        appManager(serial)->loadApps();
+    }
+}
+
+void DeviceManager::onDeviceDone(const QString &serial)
+{
+    // Loads started outside a refresh are not tracked
+    if (!inFlight.remove(serial)) {
+        return;
+    }
+
+    startQueued();
+
+    if (inFlight.isEmpty() && queue.isEmpty()) {
+        qint64 elapsed = refreshTimer.elapsed();
+        qCInfo(lcAdb) << "Refreshed" << refreshCount << "devices in" << elapsed << "ms,"
+                      << "up to" << parallelLimit << "in parallel";
+        emit refreshFinished(refreshCount, elapsed);
+    }
+}
+
+QList<DeviceInfo> DeviceManager::parseDeviceList(QByteArrayView output)
+{
+    QList<DeviceInfo> devices;
+
+    // "<serial> <state> usb:1-1 product:x model:Pixel_7 device:y transport_id:3"
+    const QStringList lines = QString::fromUtf8(output).split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        QStringList parts = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (parts.size() < 2 || line.startsWith("List of devices") || line.startsWith('*')) {
+            continue;
+        }
+
+        DeviceInfo info;
+        info.serial = parts.at(0);
+        info.state = parts.at(1);
+        if (info.state == "no" && parts.size() > 2 && parts.at(2) == "permissions") {
+            info.state = "no permissions";
+        }
+
+        for (int i = 2; i < parts.size(); ++i) {
+            const QString &part = parts.at(i);
+            if (part.startsWith("model:")) {
+                info.model = part.mid(6);
+            } else if (part.startsWith("product:")) {
+                info.product = part.mid(8);
+            } else if (part.startsWith("transport_id:")) {
+                info.transportId = part.mid(13);
+            }
+        }
+        devices.append(info);
+    }
+
+    return devices;
+}
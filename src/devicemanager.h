@@ -0,0 +1,86 @@
+#ifndef DEVICEMANAGER_H
+#define DEVICEMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include "appmanager.h"
+
+class AdbClient;
+class AdbReply;
+
+struct DeviceInfo {
+    QString serial;
+    QString state;      // "device", "unauthorized", "offline", ...
+    QString model;
+    QString product;
+    QString transportId;
+
+    bool isReady() const { return state == "device"; }
+    QString displayName() const;
+};
+
+// Attached devices and one AppManager per device.
+//
+// refresh() lists devices through `host:devices-l` (or `adb devices -l`) and
+// then reloads every ready device's app list. Loads run in parallel up to
+// maxParallel() at a time; each device's result is reported as soon as it
+// arrives.
+class DeviceManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_MAX_PARALLEL = 4;
+
+    explicit DeviceManager(QObject *parent = nullptr);
+
+    AdbClient *client() const;
+    QList<DeviceInfo> devices() const;
+    DeviceInfo device(const QString &serial) const;
+
+    // Created on first use; an empty serial means "the only attached device"
+    AppManager *appManager(const QString &serial);
+
+    int maxParallel() const;
+    void setMaxParallel(int count);
+
+    void refresh();
+    void refreshDevices();
+    void refreshApps();
+
+    static QList<DeviceInfo> parseDeviceList(QByteArrayView output);
+
+signals:
+    void devicesChanged(const QList<DeviceInfo> &devices);
+    void deviceError(const QString &error);
+    void deviceAppsLoaded(const QString &serial, const QList<AppInfo> &apps);
+    void deviceAppsFailed(const QString &serial, const QString &error);
+    void refreshFinished(int deviceCount, qint64 elapsedMs);
+
+private slots:
+    void onDevicesReplyFinished();
+
+private:
+    void startQueued();
+    void onDeviceDone(const QString &serial);
+
+    AdbClient *adbClient;
+    AdbReply *devicesReply;
+    bool appsAfterDevices;
+    QList<DeviceInfo> deviceList;
+    QHash<QString, AppManager *> managers;
+
+    // Refresh scheduling
+    int parallelLimit;
+    QList<QString> queue;
+    QSet<QString> inFlight;
+    int refreshCount;
+    QElapsedTimer refreshTimer;
+};
+
+#endif // DEVICEMANAGER_H
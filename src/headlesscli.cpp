@@ -0,0 +1,237 @@
+#include "headlesscli.h"
+#include "devicemanager.h"
+#include "sessionmanager.h"
+#include "profilestore.h"
+#include "packageparser.h"
+#include "customappstore.h"
+#include "logger.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <cstdio>
+#include <cstring>
+
+HeadlessCli::HeadlessCli(const QElapsedTimer &startup, QObject *parent)
+    : QObject(parent)
+    , startup(startup)
+    , startupMs(0)
+    , deviceManager(nullptr)
+    , sessionManager(nullptr)
+    , finished(false)
+{
+}
+
+bool HeadlessCli::isRequested(int argc, char *argv[])
+{
+    // Checked before any QCoreApplication exists
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int HeadlessCli::exec(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless mode: devices | list | launch PACKAGE");
+    parser.addHelpOption();
+    parser.addOption({ "headless", "Run a command without the GUI." });
+    parser.addOption({ "device", "Device serial; defaults to the only attached device.", "serial" });
+    parser.addOption({ "profile", "Launch profile; defaults to the app's own.", "name" });
+    parser.addOption({ "name", "Window title for launch; defaults to the app name.", "name" });
+    parser.addOption({ "cached", "list: answer from the package catalog when there is one." });
+    parser.addOption({ "trace", "Write a Chrome trace of this run to file.", "file" });
+    parser.addPositionalArgument("command", "devices, list or launch");
+    parser.addPositionalArgument("package", "Package to launch");
+
+    if (!parser.parse(arguments)) {
+        fail(UsageError, parser.errorText());
+        return UsageError;
+    }
+    if (parser.isSet("help")) {
+        fputs(qPrintable(parser.helpText()), stdout);
+        return Success;
+    }
+
+    const QStringList positional = parser.positionalArguments();
+    QString command = positional.value(0);
+    serial = parser.value("device");
+
+    deviceManager = new DeviceManager(this);
+    startupMs = startup.elapsed();
+
+    if (command == "devices" && positional.size() == 1) {
+        listDevices();
+    } else if (command == "list" && positional.size() == 1) {
+        listApps(parser.isSet("cached"));
+    } else if (command == "launch" && positional.size() == 2) {
+        launch(positional.at(1), parser.value("profile"), parser.value("name"));
+    } else {
+        fail(UsageError, command.isEmpty() ? QString("No command given")
+                                           : "Unknown command or arguments: " + positional.join(' '));
+        return UsageError;
+    }
+
+    return QCoreApplication::exec();
+}
+
+void HeadlessCli::listDevices()
+{
+    connect(deviceManager, &DeviceManager::devicesChanged, this, [this](const QList<DeviceInfo> &devices) {
+        QJsonArray array;
+        for (const DeviceInfo &info : devices) {
+            array.append(QJsonObject {
+                { "serial", info.serial },
+                { "state", info.state },
+                { "model", info.model },
+                { "product", info.product },
+                { "ready", info.isReady() }
+            });
+        }
+        print({ { "devices", array } });
+        finish(Success);
+    });
+    connect(deviceManager, &DeviceManager::deviceError, this, [this](const QString &error) {
+        fail(AdbError, error);
+    });
+    deviceManager->refreshDevices();
+}
+
+void HeadlessCli::listApps(bool cachedOk)
+{
+    AppManager *manager = deviceManager->appManager(serial);
+
+    // With --cached both the catalog and adb answer; only the first counts
+    auto report = [this](const QList<AppInfo> &apps, const char *source) {
+        if (finished) {
+            return;
+        }
+        QJsonArray array;
+        for (const AppInfo &app : apps) {
+            array.append(appToJson(app));
+        }
+        print({ { "serial", serial }, { "source", QLatin1String(source) }, { "apps", array } });
+        finish(Success);
+    };
+
+    if (cachedOk) {
+        connect(manager, &AppManager::cachedAppsLoaded, this, [report](const QList<AppInfo> &apps) {
+            report(apps, "cache");
+        });
+    }
+    connect(manager, &AppManager::appsLoaded, this, [report](const QList<AppInfo> &apps) {
+        report(apps, "adb");
+    });
+    connect(manager, &AppManager::loadError, this, [this](const QString &error) {
+        fail(AdbError, error);
+    });
+    manager->loadApps();
+}
+
+void HeadlessCli::launch(const QString &packageName, const QString &profileName, const QString &appName)
+{
+    LaunchTrace trace;
+    trace.start();
+
+    ProfileStore *profiles = ProfileStore::instance();
+    if (!profileName.isEmpty() && !profiles->profileNames().contains(profileName)) {
+        fail(UsageError, "Unknown profile: " + profileName);
+        return;
+    }
+    const ScrcpyProfile &profile = profileName.isEmpty() ? profiles->profileFor(packageName)
+                                                         : profiles->profile(profileName);
+    if (!profile.customArgsError.isEmpty()) {
+        qCWarning(lcScrcpy) << profile.customArgsError << "; custom arguments ignored";
+    }
+
+    // Same title the GUI would use: the custom app's name or the guessed one
+    QString title = appName;
+    if (title.isEmpty()) {
+        CustomAppStore *store = CustomAppStore::instance();
+        if (!store->isLoaded()) {
+            store->load();
+        }
+        for (const AppInfo &app : store->apps()) {
+            if (app.packageName == packageName) {
+                title = app.name;
+            }
+        }
+    }
+    if (title.isEmpty()) {
+        title = PackageParser::packageToName(packageName);
+    }
+
+    trace.mark(LaunchTrace::SettingsResolved);
+    trace.videoCodec = profile.videoCodec;
+    trace.bitRate = profile.bitRate;
+
+    sessionManager = new SessionManager(this);
+    ScrcpySession *session = sessionManager->startSession(serial, packageName, title,
+                                                          profile.launchArguments(serial, packageName, title),
+                                                          trace);
+
+    connect(session, &ScrcpySession::windowShown, this, [this, session](qint64 latencyMs) {
+        print({ { "event", "windowShown" }, { "session", session->id() },
+                { "pid", session->processId() }, { "latencyMs", latencyMs } });
+    });
+    connect(session, &ScrcpySession::stateChanged, this, [this, session]() {
+        if (session->isActive()) {
+            return;
+        }
+        if (!session->launchTrace().has(LaunchTrace::ProcessStarted)) {
+            fail(LaunchFailed, session->lastError().isEmpty() ? QString("Failed to start scrcpy")
+                                                              : session->lastError());
+            return;
+        }
+        print({ { "event", "exited" }, { "session", session->id() },
+                { "exitCode", session->exitCode() }, { "error", session->lastError() } });
+        finish(session->state() == ScrcpySession::Finished ? Success : ScrcpyFailed);
+    });
+}
+
+QJsonObject HeadlessCli::appToJson(const AppInfo &app)
+{
+    QJsonObject object {
+        { "package", app.packageName },
+        { "name", app.name },
+        { "custom", app.isCustom }
+    };
+    if (app.versionCode > 0) {
+        object["versionCode"] = app.versionCode;
+    }
+    return object;
+}
+
+void HeadlessCli::print(QJsonObject object)
+{
+    object["startupMs"] = startupMs;
+    object["elapsedMs"] = startup.elapsed();
+    QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+    fwrite(line.constData(), 1, line.size(), stdout);
+    fflush(stdout);
+}
+
+void HeadlessCli::fail(ExitCode code, const QString &error)
+{
+    // A late error must not follow the answer already printed
+    if (finished) {
+        return;
+    }
+    print({ { "error", error }, { "exitCode", int(code) } });
+    finish(code);
+}
+
+void HeadlessCli::finish(ExitCode code)
+{
+    if (finished) {
+        return;
+    }
+    finished = true;
+    // Queued, so it also works before the event loop has started
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [code]() {
+        QCoreApplication::exit(code);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,68 @@
+#ifndef HEADLESSCLI_H
+#define HEADLESSCLI_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include "appmanager.h"
+
+class DeviceManager;
+class SessionManager;
+class ScrcpySession;
+
+// `scrcpy-gui --headless <command>` for scripts: runs on QCoreApplication,
+// never creates a widget, and prints one compact JSON object per line on
+// stdout. Diagnostics go to stderr and the log file as usual.
+//
+//   devices                                      attached devices
+//   list [--device S] [--cached]                 apps, as the GUI lists them
+//   launch PACKAGE [--device S] [--profile P] [--name N]
+//                                                start scrcpy and stay until it exits
+//
+// Every object carries "startupMs" (process start to command dispatch) and
+// "elapsedMs" (process start to this line).
+class HeadlessCli : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitCode {
+        Success = 0,
+        Failure = 1,
+        UsageError = 2,
+        AdbError = 3,
+        LaunchFailed = 4,
+        ScrcpyFailed = 5
+    };
+
+    // startup was started when the process entered main()
+    explicit HeadlessCli(const QElapsedTimer &startup, QObject *parent = nullptr);
+
+    static bool isRequested(int argc, char *argv[]);
+
+    // Parses the arguments, runs the command in the event loop and returns
+    // the exit code
+    int exec(const QStringList &arguments);
+
+private:
+    void listDevices();
+    void listApps(bool cachedOk);
+    void launch(const QString &packageName, const QString &profileName, const QString &appName);
+
+    void print(QJsonObject object);
+    void fail(ExitCode code, const QString &error);
+    void finish(ExitCode code);
+
+    static QJsonObject appToJson(const AppInfo &app);
+
+    QElapsedTimer startup;
+    qint64 startupMs;
+    QString serial;
+    DeviceManager *deviceManager;
+    SessionManager *sessionManager;
+    bool finished;
+};
+
+#endif // HEADLESSCLI_H
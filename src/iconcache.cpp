@@ -0,0 +1,91 @@
+#include "iconcache.h"
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+IconCache::IconCache(const QString &directory, qint64 maxMemoryBytes)
+    : dir(directory.isEmpty()
+          ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/icons"
+          : directory)
+{
+    memory.setMaxCost(maxMemoryBytes);
+}
+
+QString IconCache::keyFor(const QString &packageName, qint64 versionCode)
+{
+    QByteArray id = packageName.toUtf8() + '@' + QByteArray::number(versionCode);
+    return QString::fromLatin1(QCryptographicHash::hash(id, QCryptographicHash::Sha1).toHex());
+}
+
+const QPixmap *IconCache::find(const QString &key)
+{
+    return memory.object(key);
+}
+
+void IconCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    qint64 cost = qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    memory.insert(key, new QPixmap(pixmap), qMax<qint64>(cost, 1));
+}
+
+qint64 IconCache::memoryBytes() const
+{
+    return memory.totalCost();
+}
+
+qint64 IconCache::maxMemoryBytes() const
+{
+    return memory.maxCost();
+}
+
+QString IconCache::filePath(const QString &key) const
+{
+    // Two-character fan-out keeps directories small
+    return dir + "/" + key.left(2) + "/" + key.mid(2) + ".png";
+}
+
+IconCache::DiskResult IconCache::readFile(const QString &path, QImage *image)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return NotCached;
+    }
+    if (file.size() == 0) {
+        return NoIcon;
+    }
+    if (!image->load(&file, "PNG")) {
+        // Corrupt entry; fetch it again
+        return NotCached;
+    }
+    return Found;
+}
+
+bool IconCache::writeFile(const QString &path, const QImage &image)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (!image.isNull() && !image.save(&file, "PNG")) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+QImage IconCache::scaled(const QByteArray &encoded)
+{
+    QImage image = QImage::fromData(encoded);
+    if (image.isNull()) {
+        return QImage();
+    }
+    if (image.width() > ICON_PIXELS || image.height() > ICON_PIXELS) {
+        image = image.scaled(ICON_PIXELS, ICON_PIXELS, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
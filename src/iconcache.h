@@ -0,0 +1,51 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QString>
+#include <QPixmap>
+#include <QImage>
+#include <QCache>
+
+// App icons in memory and on disk.
+//
+// Entries are addressed by a hash of package name and version code, so an
+// update gets a new entry and old ones are never invalidated in place. The
+// memory side is an LRU bounded by pixmap bytes and is GUI-thread only; the
+// disk side is plain PNG files that the static helpers read and write from
+// any thread. An empty file records that the APK has no usable icon.
+class IconCache
+{
+public:
+    static constexpr int ICON_PIXELS = 48;
+    static constexpr qint64 DEFAULT_MEMORY_BYTES = 8 * 1024 * 1024;
+
+    enum DiskResult {
+        NotCached,
+        NoIcon,
+        Found
+    };
+
+    // An empty directory means CacheLocation/icons
+    explicit IconCache(const QString &directory = QString(), qint64 maxMemoryBytes = DEFAULT_MEMORY_BYTES);
+
+    static QString keyFor(const QString &packageName, qint64 versionCode);
+
+    // nullptr on a miss; a hit becomes the most recently used entry
+    const QPixmap *find(const QString &key);
+    void insert(const QString &key, const QPixmap &pixmap);
+    qint64 memoryBytes() const;
+    qint64 maxMemoryBytes() const;
+
+    QString filePath(const QString &key) const;
+    static DiskResult readFile(const QString &path, QImage *image);
+    // A null image stores the "no icon" marker
+    static bool writeFile(const QString &path, const QImage &image);
+    // Decoded APK resource scaled to ICON_PIXELS
+    static QImage scaled(const QByteArray &encoded);
+
+private:
+    QString dir;
+    QCache<QString, QPixmap> memory;
+};
+
+#endif // ICONCACHE_H
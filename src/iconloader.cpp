@@ -0,0 +1,225 @@
+#include "iconloader.h"
+#include "adbshellsession.h"
+#include "logger.h"
+#include <QRegularExpression>
+#include <QThread>
+
+namespace {
+
+// Custom apps are typed in by hand and end up in a shell command
+bool isSafePackageName(const QString &packageName)
+{
+    static const QRegularExpression pattern("^[A-Za-z0-9_]+(\\.[A-Za-z0-9_]+)*$");
+    return pattern.match(packageName).hasMatch();
+}
+
+} // namespace
+
+IconLoader::IconLoader(AdbClient *client, QObject *parent)
+    : QObject(parent)
+    , client(client)
+    , shell(nullptr)
+    , placeholder(IconCache::ICON_PIXELS, IconCache::ICON_PIXELS)
+    , diskReads(0)
+{
+    placeholder.fill(Qt::transparent);
+    workers.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+}
+
+IconLoader::~IconLoader()
+{
+    closeShell();
+    // Results posted back after this are dropped with the object
+    workers.clear();
+    workers.waitForDone();
+}
+
+void IconLoader::setSerial(const QString &serial)
+{
+    if (serial == deviceSerial) {
+        return;
+    }
+    deviceSerial = serial;
+
+    // Entries are per package version, so memory and disk stay valid; only
+    // the device queue belongs to the old device
+    closeShell();
+}
+
+void IconLoader::closeShell()
+{
+    for (const Job &job : std::as_const(fetches)) {
+        busy.remove(job.key);
+    }
+    for (const Job &job : std::as_const(fetchQueue)) {
+        busy.remove(job.key);
+    }
+    fetches.clear();
+    fetchQueue.clear();
+
+    if (shell) {
+        shell->disconnect(this);
+        shell->close();
+        shell->deleteLater();
+        shell = nullptr;
+    }
+}
+
+QPixmap IconLoader::icon(const AppInfo &app)
+{
+    if (app.versionCode <= 0) {
+        return placeholder;
+    }
+    const QPixmap *pixmap = cache.find(IconCache::keyFor(app.packageName, app.versionCode));
+    return pixmap ? *pixmap : placeholder;
+}
+
+void IconLoader::request(const QList<AppInfo> &apps)
+{
+    QSet<QString> wanted;
+    diskQueue.clear();
+
+    for (const AppInfo &app : apps) {
+        if (app.versionCode <= 0 || !isSafePackageName(app.packageName)) {
+            continue;
+        }
+        QString key = IconCache::keyFor(app.packageName, app.versionCode);
+        wanted.insert(key);
+        if (busy.contains(key) || noIcon.contains(key) || cache.find(key)) {
+            continue;
+        }
+        diskQueue.append({ key, app.packageName });
+        busy.insert(key);
+    }
+
+    // Rows scrolled away from give their place on the device to new ones
+    for (auto it = fetchQueue.begin(); it != fetchQueue.end();) {
+        if (wanted.contains(it->key)) {
+            ++it;
+        } else {
+            busy.remove(it->key);
+            it = fetchQueue.erase(it);
+        }
+    }
+
+    pump();
+}
+
+void IconLoader::pump()
+{
+    while (diskReads < MAX_DISK_READS && !diskQueue.isEmpty()) {
+        Job job = diskQueue.takeFirst();
+        QString path = cache.filePath(job.key);
+        ++diskReads;
+        workers.start([this, job, path]() {
+            QImage image;
+            IconCache::DiskResult result = IconCache::readFile(path, &image);
+            QMetaObject::invokeMethod(this, [this, job, result, image]() {
+                onDiskRead(job, result, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    while (fetches.size() < MAX_DEVICE_FETCHES && !fetchQueue.isEmpty()) {
+        if (!shell) {
+            shell = new AdbShellSession(client, deviceSerial, this);
+            connect(shell, &AdbShellSession::commandFinished, this, &IconLoader::onShellCommandFinished);
+            connect(shell, &AdbShellSession::commandFailed, this, &IconLoader::onShellCommandFailed);
+        }
+        Job job = fetchQueue.takeFirst();
+        fetches.insert(shell->execute(fetchScript(job.packageName)), job);
+    }
+}
+
+void IconLoader::onDiskRead(const Job &job, IconCache::DiskResult result, const QImage &image)
+{
+    --diskReads;
+
+    switch (result) {
+    case IconCache::Found:
+        busy.remove(job.key);
+        cache.insert(job.key, QPixmap::fromImage(image));
+        emit iconReady(job.packageName);
+        break;
+    case IconCache::NoIcon:
+        busy.remove(job.key);
+        noIcon.insert(job.key);
+        break;
+    case IconCache::NotCached:
+        fetchQueue.append(job);
+        break;
+    }
+
+    pump();
+}
+
+void IconLoader::onShellCommandFinished(int id, const QByteArray &output, int exitCode)
+{
+    if (!fetches.contains(id)) {
+        return;
+    }
+    Job job = fetches.take(id);
+
+    // Only NO_ICON_EXIT says something about the APK (adaptive icons only,
+    // or shrunk resource names) and is remembered. Anything else, like no
+    // unzip or base64, pm failing or a locked device, is retried by a later
+    // request.
+    bool noBitmap = exitCode == NO_ICON_EXIT;
+    if (!noBitmap && (exitCode != 0 || output.trimmed().isEmpty())) {
+        busy.remove(job.key);
+        qCDebug(lcAdb) << "Icon fetch for" << job.packageName << "exited with" << exitCode;
+        pump();
+        return;
+    }
+
+    QByteArray encoded = noBitmap ? QByteArray() : QByteArray::fromBase64(output);
+    QString path = cache.filePath(job.key);
+    workers.start([this, job, encoded, path]() {
+        QImage image = encoded.isEmpty() ? QImage() : IconCache::scaled(encoded);
+        IconCache::writeFile(path, image);
+        QMetaObject::invokeMethod(this, [this, job, image]() {
+            onDecoded(job, image);
+        }, Qt::QueuedConnection);
+    });
+
+    pump();
+}
+
+void IconLoader::onShellCommandFailed(int id, const QString &error)
+{
+    if (!fetches.contains(id)) {
+        return;
+    }
+    Job job = fetches.take(id);
+    busy.remove(job.key);
+    qCDebug(lcAdb) << "Icon fetch for" << job.packageName << "failed:" << error;
+    pump();
+}
+
+void IconLoader::onDecoded(const Job &job, const QImage &image)
+{
+    busy.remove(job.key);
+    if (image.isNull()) {
+        noIcon.insert(job.key);
+        return;
+    }
+    cache.insert(job.key, QPixmap::fromImage(image));
+    emit iconReady(job.packageName);
+}
+
+QString IconLoader::fetchScript(const QString &packageName)
+{
+    // Largest launcher bitmap in the base APK, base64 so the shell's text
+    // stream carries it intact. unzip is on the device since Android 9. The
+    // subshell keeps exit from ending the shell session.
+    return QString("( p=$(pm path %1 | head -n 1); p=${p#package:}; [ -n \"$p\" ] || exit 1; "
+                   "l=$(unzip -l \"$p\" 2>/dev/null) || exit 1; "
+                   "l=$(echo \"$l\" | grep -oE 'res/[^ ]*/ic_launcher(_round)?\\.(png|webp)$'); e=; "
+                   "for d in xxxhdpi xxhdpi xhdpi hdpi mdpi; do "
+                   "e=$(echo \"$l\" | grep -m 1 -- \"-$d\"); [ -n \"$e\" ] && break; "
+                   "done; "
+                   "[ -n \"$e\" ] || exit %2; "
+                   "unzip -p \"$p\" \"$e\" | base64 )")
+        .arg(packageName)
+        .arg(NO_ICON_EXIT);
+}
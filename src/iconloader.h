@@ -0,0 +1,80 @@
+#ifndef ICONLOADER_H
+#define ICONLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QPixmap>
+#include <QThreadPool>
+#include "appmanager.h"
+#include "iconcache.h"
+
+class AdbClient;
+class AdbShellSession;
+
+// Fetches app icons for the rows the list is about to show.
+//
+// icon() only looks at memory and never blocks. request() takes the rows in
+// priority order (visible first, then the look-ahead) and replaces whatever
+// was still waiting from the previous call. Misses are looked up on disk by
+// a small worker pool; disk misses are pulled from the device (the launcher
+// icon inside the APK, base64 over the shell session), scaled on the pool
+// and written back. At most MAX_DEVICE_FETCHES are queued on the device so
+// newly visible rows never wait behind rows scrolled away from.
+class IconLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_DEVICE_FETCHES = 2;
+    static constexpr int MAX_DISK_READS = 8;
+    // Fetch script exit code for an APK without a usable launcher bitmap
+    static constexpr int NO_ICON_EXIT = 3;
+
+    explicit IconLoader(AdbClient *client, QObject *parent = nullptr);
+    ~IconLoader();
+
+    // Device to pull icons from; an empty serial means the only attached one
+    void setSerial(const QString &serial);
+
+    // Transparent placeholder until the icon is in memory
+    QPixmap icon(const AppInfo &app);
+    void request(const QList<AppInfo> &apps);
+
+signals:
+    void iconReady(const QString &packageName);
+
+private slots:
+    void onShellCommandFinished(int id, const QByteArray &output, int exitCode);
+    void onShellCommandFailed(int id, const QString &error);
+
+private:
+    struct Job {
+        QString key;
+        QString packageName;
+    };
+
+    void pump();
+    void onDiskRead(const Job &job, IconCache::DiskResult result, const QImage &image);
+    void onDecoded(const Job &job, const QImage &image);
+    void closeShell();
+    static QString fetchScript(const QString &packageName);
+
+    AdbClient *client;
+    QString deviceSerial;
+    AdbShellSession *shell;
+    IconCache cache;
+    QThreadPool workers;
+    QPixmap placeholder;
+
+    QList<Job> diskQueue;    // wanted, not looked up on disk yet
+    QList<Job> fetchQueue;   // not on disk, waiting for the device
+    QHash<int, Job> fetches; // shell command id -> job
+    QSet<QString> busy;      // keys in any of the above or on the pool
+    QSet<QString> noIcon;
+    int diskReads;
+};
+
+#endif // ICONLOADER_H
@@ -0,0 +1,145 @@
+#include "latencyhistogram.h"
+#include <QJsonArray>
+
+namespace {
+
+constexpr int SUB_BUCKETS = 1 << LatencyHistogram::SUB_BUCKET_BITS;
+constexpr int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+
+int highestBit(quint64 value)
+{
+    int bit = -1;
+    while (value) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    if (value < SUB_BUCKETS)
+        return int(value);
+
+    // index = shift * HALF + (value >> shift), with value >> shift in [HALF, SUB)
+    int shift = highestBit(quint64(value)) - SUB_BUCKET_BITS + 1;
+    return shift * HALF_SUB_BUCKETS + int(value >> shift);
+}
+
+qint64 LatencyHistogram::bucketLowest(int index)
+{
+    if (index < SUB_BUCKETS)
+        return index;
+    int shift = index / HALF_SUB_BUCKETS - 1;
+    qint64 sub = index - shift * HALF_SUB_BUCKETS;
+    return sub << shift;
+}
+
+qint64 LatencyHistogram::bucketHighest(int index)
+{
+    if (index < SUB_BUCKETS)
+        return index;
+    int shift = index / HALF_SUB_BUCKETS - 1;
+    return bucketLowest(index) + (qint64(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 valueUs)
+{
+    qint64 value = qBound<qint64>(0, valueUs, MAX_VALUE);
+    int index = bucketIndex(value);
+    if (index >= counts.size())
+        counts.resize(index + 1);
+    ++counts[index];
+
+    if (total == 0 || value < minValue)
+        minValue = value;
+    if (total == 0 || value > maxValue)
+        maxValue = value;
+    ++total;
+    sum += value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.total == 0)
+        return;
+    if (other.counts.size() > counts.size())
+        counts.resize(other.counts.size());
+    for (int i = 0; i < other.counts.size(); ++i)
+        counts[i] += other.counts.at(i);
+
+    minValue = total == 0 ? other.minValue : qMin(minValue, other.minValue);
+    maxValue = total == 0 ? other.maxValue : qMax(maxValue, other.maxValue);
+    total += other.total;
+    sum += other.sum;
+}
+
+void LatencyHistogram::reset()
+{
+    counts.clear();
+    total = 0;
+    minValue = 0;
+    maxValue = 0;
+    sum = 0;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return total;
+}
+
+qint64 LatencyHistogram::min() const
+{
+    return minValue;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return maxValue;
+}
+
+double LatencyHistogram::mean() const
+{
+    return total ? sum / total : 0.0;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (total == 0)
+        return 0;
+
+    quint64 target = quint64(qBound(0.0, percentile, 100.0) / 100.0 * total + 0.5);
+    target = qBound<quint64>(1, target, total);
+
+    quint64 seen = 0;
+    for (int i = 0; i < counts.size(); ++i) {
+        seen += counts.at(i);
+        if (seen >= target)
+            return qMin(bucketHighest(i), maxValue);
+    }
+    return maxValue;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    QJsonArray buckets;
+    for (int i = 0; i < counts.size(); ++i) {
+        if (counts.at(i) == 0)
+            continue;
+        buckets.append(QJsonArray { bucketLowest(i), bucketHighest(i), qint64(counts.at(i)) });
+    }
+
+    QJsonObject object;
+    object["count"] = qint64(total);
+    object["min"] = minValue;
+    object["max"] = maxValue;
+    object["mean"] = mean();
+    object["p50"] = valueAtPercentile(50);
+    object["p90"] = valueAtPercentile(90);
+    object["p99"] = valueAtPercentile(99);
+    object["p999"] = valueAtPercentile(99.9);
+    object["buckets"] = buckets;
+    return object;
+}
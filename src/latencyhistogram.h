@@ -0,0 +1,46 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+#include <QJsonObject>
+#include <QtGlobal>
+
+// Log-linear latency histogram in the spirit of HdrHistogram.
+//
+// Values (microseconds) below 2^SUB_BUCKET_BITS are counted exactly; above
+// that every power of two is split into 2^(SUB_BUCKET_BITS - 1) linear
+// buckets, so any recorded value is off by at most ~3%. Memory stays under
+// a few KB however many samples are recorded.
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr qint64 MAX_VALUE = Q_INT64_C(3600) * 1000 * 1000;  // 1 h
+
+    void record(qint64 valueUs);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    quint64 count() const;
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+    // Upper bound of the bucket holding the given percentile (0-100)
+    qint64 valueAtPercentile(double percentile) const;
+
+    // count, min, max, mean, p50/p90/p99/p999 and the non-empty buckets
+    QJsonObject toJson() const;
+
+private:
+    static int bucketIndex(qint64 value);
+    static qint64 bucketLowest(int index);
+    static qint64 bucketHighest(int index);
+
+    QVector<quint64> counts;
+    quint64 total = 0;
+    qint64 minValue = 0;
+    qint64 maxValue = 0;
+    double sum = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,220 @@
+#include "launchmetrics.h"
+#include "logger.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <algorithm>
+
+const QString LaunchMetrics::ALL_GROUP = QStringLiteral("all");
+
+LaunchTrace::LaunchTrace()
+{
+    std::fill(std::begin(offsets), std::end(offsets), -1);
+}
+
+void LaunchTrace::start()
+{
+    clock.start();
+    startedAt = QDateTime::currentDateTime();
+    std::fill(std::begin(offsets), std::end(offsets), -1);
+    offsets[Clicked] = 0;
+}
+
+bool LaunchTrace::isValid() const
+{
+    return clock.isValid();
+}
+
+void LaunchTrace::mark(Phase phase)
+{
+    if (clock.isValid() && offsets[phase] < 0) {
+        offsets[phase] = clock.nsecsElapsed() / 1000;
+    }
+}
+
+bool LaunchTrace::has(Phase phase) const
+{
+    return offsets[phase] >= 0;
+}
+
+qint64 LaunchTrace::offsetUs(Phase phase) const
+{
+    return offsets[phase];
+}
+
+qint64 LaunchTrace::elapsedMs() const
+{
+    return clock.isValid() ? clock.elapsed() : 0;
+}
+
+QString LaunchTrace::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Clicked:
+        return "clicked";
+    case SettingsResolved:
+        return "settings-resolved";
+    case ProcessStarted:
+        return "process-started";
+    case ServerPushed:
+        return "server-pushed";
+    case DeviceConnected:
+        return "device-connected";
+    case FirstFrame:
+        return "first-frame";
+    case FirstFps:
+        return "first-fps";
+    default:
+        return QString();
+    }
+}
+
+LaunchMetrics::LaunchMetrics(QObject *parent)
+    : QObject(parent)
+    , total(0)
+{
+}
+
+void LaunchMetrics::record(const LaunchTrace &trace)
+{
+    if (!trace.isValid()) {
+        return;
+    }
+
+    recordGroup(ALL_GROUP, trace);
+    if (!trace.serial.isEmpty()) {
+        recordGroup("device:" + trace.serial, trace);
+    }
+    recordGroup("codec:" + (trace.videoCodec.isEmpty() ? QString("default") : trace.videoCodec), trace);
+    recordGroup("bit-rate:" + (trace.bitRate.isEmpty() ? QString("default") : trace.bitRate), trace);
+
+    recent.append(trace);
+    if (recent.size() > MAX_LAUNCHES) {
+        recent.removeFirst();
+    }
+    ++total;
+
+    if (trace.has(LaunchTrace::FirstFrame)) {
+        qCInfo(lcScrcpy) << "Launch of" << trace.packageName << "first frame after"
+                         << trace.offsetUs(LaunchTrace::FirstFrame) / 1000 << "ms";
+    }
+    emit launchRecorded();
+}
+
+void LaunchMetrics::recordGroup(const QString &group, const LaunchTrace &trace)
+{
+    QVector<LatencyHistogram> &phases = histograms[group];
+    if (phases.isEmpty()) {
+        phases.resize(LaunchTrace::PhaseCount);
+    }
+    for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+        if (trace.offsets[phase] >= 0) {
+            phases[phase].record(trace.offsets[phase]);
+        }
+    }
+}
+
+void LaunchMetrics::clear()
+{
+    histograms.clear();
+    recent.clear();
+    total = 0;
+    emit launchRecorded();
+}
+
+int LaunchMetrics::launchCount() const
+{
+    return total;
+}
+
+QList<LaunchTrace> LaunchMetrics::launches() const
+{
+    return recent;
+}
+
+QStringList LaunchMetrics::groups() const
+{
+    return histograms.keys();
+}
+
+LatencyHistogram LaunchMetrics::histogram(const QString &group, LaunchTrace::Phase phase) const
+{
+    return histograms.value(group).value(phase);
+}
+
+QJsonObject LaunchMetrics::toJson() const
+{
+    QJsonObject groupsObject;
+    for (auto it = histograms.cbegin(); it != histograms.cend(); ++it) {
+        QJsonObject phasesObject;
+        for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+            phasesObject[LaunchTrace::phaseName(LaunchTrace::Phase(phase))] = it.value().at(phase).toJson();
+        }
+        groupsObject[it.key()] = phasesObject;
+    }
+
+    QJsonArray launchesArray;
+    for (const LaunchTrace &trace : recent) {
+        QJsonObject launch;
+        launch["startedAt"] = trace.startedAt.toString(Qt::ISODateWithMs);
+        launch["serial"] = trace.serial;
+        launch["package"] = trace.packageName;
+        launch["videoCodec"] = trace.videoCodec;
+        launch["bitRate"] = trace.bitRate;
+        for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+            launch[LaunchTrace::phaseName(LaunchTrace::Phase(phase))] = trace.offsets[phase];
+        }
+        launchesArray.append(launch);
+    }
+
+    QJsonObject root;
+    root["unit"] = "us";
+    root["launchCount"] = total;
+    root["histograms"] = groupsObject;
+    root["launches"] = launchesArray;
+    return root;
+}
+
+QByteArray LaunchMetrics::toCsv() const
+{
+    // One row per launch; offsets in microseconds, empty when not reached
+    QByteArray csv = "started_at,serial,package,video_codec,bit_rate";
+    for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+        csv += ',' + LaunchTrace::phaseName(LaunchTrace::Phase(phase)).toUtf8() + "_us";
+    }
+    csv += '\n';
+
+    for (const LaunchTrace &trace : recent) {
+        csv += trace.startedAt.toString(Qt::ISODateWithMs).toUtf8();
+        for (const QString &field : { trace.serial, trace.packageName, trace.videoCodec, trace.bitRate }) {
+            csv += ',' + field.toUtf8();
+        }
+        for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+            csv += ',';
+            if (trace.offsets[phase] >= 0) {
+                csv += QByteArray::number(trace.offsets[phase]);
+            }
+        }
+        csv += '\n';
+    }
+    return csv;
+}
+
+bool LaunchMetrics::exportToFile(const QString &path, QString *errorMessage) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    if (path.endsWith(".csv", Qt::CaseInsensitive)) {
+        file.write(toCsv());
+    } else {
+        file.write(QJsonDocument(toJson()).toJson());
+    }
+    qCDebug(lcApp) << "Exported" << recent.size() << "launch traces to" << path;
+    return true;
+}
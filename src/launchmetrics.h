@@ -0,0 +1,92 @@
+#ifndef LAUNCHMETRICS_H
+#define LAUNCHMETRICS_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonObject>
+#include "latencyhistogram.h"
+
+// Timestamps of one launch, from the click to scrcpy's first FPS report.
+// Every phase after Clicked is an offset from the click in microseconds;
+// phases scrcpy never reported stay at -1.
+struct LaunchTrace {
+    enum Phase {
+        Clicked,
+        SettingsResolved,
+        ProcessStarted,
+        ServerPushed,
+        DeviceConnected,
+        FirstFrame,
+        FirstFps,
+        PhaseCount
+    };
+
+    LaunchTrace();
+
+    void start();
+    bool isValid() const;
+    // Records the phase if it hasn't been seen yet
+    void mark(Phase phase);
+    bool has(Phase phase) const;
+    qint64 offsetUs(Phase phase) const;
+    qint64 elapsedMs() const;
+
+    static QString phaseName(Phase phase);
+
+    QDateTime startedAt;
+    QString serial;
+    QString packageName;
+    QString videoCodec;
+    QString bitRate;
+    qint64 offsets[PhaseCount];
+
+private:
+    QElapsedTimer clock;
+};
+
+// Per-phase latency histograms over every recorded launch.
+//
+// Each launch is counted under "all" and under its device, codec and bit
+// rate so those can be compared. The last MAX_LAUNCHES raw traces are kept
+// for export.
+class LaunchMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_LAUNCHES = 1000;
+    static const QString ALL_GROUP;
+
+    explicit LaunchMetrics(QObject *parent = nullptr);
+
+    void record(const LaunchTrace &trace);
+    void clear();
+
+    int launchCount() const;
+    QList<LaunchTrace> launches() const;
+    QStringList groups() const;
+    LatencyHistogram histogram(const QString &group, LaunchTrace::Phase phase) const;
+
+    QJsonObject toJson() const;
+    QByteArray toCsv() const;
+    // Format follows the suffix: .csv, anything else is JSON
+    bool exportToFile(const QString &path, QString *errorMessage = nullptr) const;
+
+signals:
+    void launchRecorded();
+
+private:
+    void recordGroup(const QString &group, const LaunchTrace &trace);
+
+    QMap<QString, QVector<LatencyHistogram>> histograms;
+    QList<LaunchTrace> recent;
+    int total;
+};
+
+#endif // LAUNCHMETRICS_H
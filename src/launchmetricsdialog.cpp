@@ -0,0 +1,126 @@
+#include "launchmetricsdialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QSignalBlocker>
+
+namespace {
+
+QString formatMs(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 1);
+}
+
+} // namespace
+
+LaunchMetricsDialog::LaunchMetricsDialog(LaunchMetrics *metrics, QWidget *parent)
+    : QDialog(parent)
+    , metrics(metrics)
+{
+    setWindowTitle("Launch Latency");
+    resize(640, 320);
+    setupUI();
+    refresh();
+
+    connect(metrics, &LaunchMetrics::launchRecorded, this, &LaunchMetricsDialog::refresh);
+}
+
+void LaunchMetricsDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    QHBoxLayout *groupLayout = new QHBoxLayout();
+    groupLayout->addWidget(new QLabel("Launches:"));
+    groupCombo = new QComboBox();
+    groupCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    groupLayout->addWidget(groupCombo);
+    groupLayout->addStretch();
+    summaryLabel = new QLabel();
+    groupLayout->addWidget(summaryLabel);
+    mainLayout->addLayout(groupLayout);
+    connect(groupCombo, &QComboBox::currentTextChanged, this, &LaunchMetricsDialog::fillTable);
+
+    // Rows are phases, offsets from the click in milliseconds
+    table = new QTableWidget(LaunchTrace::PhaseCount - 1, 7, this);
+    table->setHorizontalHeaderLabels({"Count", "Min", "p50", "p90", "p99", "Max", "Mean"});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    QStringList phaseLabels;
+    for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+        phaseLabels << LaunchTrace::phaseName(LaunchTrace::Phase(phase));
+    }
+    table->setVerticalHeaderLabels(phaseLabels);
+    mainLayout->addWidget(table);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    QPushButton *exportButton = buttonBox->addButton("Export...", QDialogButtonBox::ActionRole);
+    QPushButton *clearButton = buttonBox->addButton("Clear", QDialogButtonBox::ResetRole);
+    connect(exportButton, &QPushButton::clicked, this, &LaunchMetricsDialog::onExportClicked);
+    connect(clearButton, &QPushButton::clicked, this, &LaunchMetricsDialog::onClearClicked);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttonBox);
+}
+
+void LaunchMetricsDialog::refresh()
+{
+    QString current = groupCombo->currentText();
+    {
+        QSignalBlocker blocker(groupCombo);
+        groupCombo->clear();
+        groupCombo->addItems(metrics->groups());
+        int index = groupCombo->findText(current.isEmpty() ? LaunchMetrics::ALL_GROUP : current);
+        groupCombo->setCurrentIndex(qMax(0, index));
+    }
+    summaryLabel->setText(QString("%1 launches recorded (ms since click)").arg(metrics->launchCount()));
+    fillTable();
+}
+
+void LaunchMetricsDialog::fillTable()
+{
+    QString group = groupCombo->currentText();
+    for (int phase = LaunchTrace::SettingsResolved; phase < LaunchTrace::PhaseCount; ++phase) {
+        LatencyHistogram histogram = metrics->histogram(group, LaunchTrace::Phase(phase));
+        QStringList cells;
+        if (histogram.count() > 0) {
+            cells << QString::number(histogram.count())
+                  << formatMs(histogram.min())
+                  << formatMs(histogram.valueAtPercentile(50))
+                  << formatMs(histogram.valueAtPercentile(90))
+                  << formatMs(histogram.valueAtPercentile(99))
+                  << formatMs(histogram.max())
+                  << formatMs(qint64(histogram.mean()));
+        } else {
+            cells << "0" << "-" << "-" << "-" << "-" << "-" << "-";
+        }
+
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem(cells.at(column));
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(phase - 1, column, item);
+        }
+    }
+}
+
+void LaunchMetricsDialog::onExportClicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Export Launch Latency", "launch-latency.json",
+                                                "JSON (*.json);;CSV (*.csv)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!metrics->exportToFile(path, &error)) {
+        QMessageBox::warning(this, "Export Failed", "Could not write " + path + ":\n" + error);
+    }
+}
+
+void LaunchMetricsDialog::onClearClicked()
+{
+    metrics->clear();
+}
@@ -0,0 +1,35 @@
+#ifndef LAUNCHMETRICSDIALOG_H
+#define LAUNCHMETRICSDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QTableWidget>
+#include <QLabel>
+#include "launchmetrics.h"
+
+// Per-phase launch latency percentiles for one group (all launches, one
+// device, codec or bit rate), with JSON/CSV export.
+class LaunchMetricsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LaunchMetricsDialog(LaunchMetrics *metrics, QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+    void onExportClicked();
+    void onClearClicked();
+
+private:
+    void setupUI();
+    void fillTable();
+
+    LaunchMetrics *metrics;
+
+    QComboBox *groupCombo;
+    QTableWidget *table;
+    QLabel *summaryLabel;
+};
+
+#endif // LAUNCHMETRICSDIALOG_H
@@ -0,0 +1,331 @@
+#include "logger.h"
+#include "metrics.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QThread>
+#include <QDateTime>
+#include <QSettings>
+#include <QStringList>
+#include <cstdio>
+
+Q_LOGGING_CATEGORY(lcApp, "scrcpygui.app")
+Q_LOGGING_CATEGORY(lcAdb, "scrcpygui.adb")
+Q_LOGGING_CATEGORY(lcScrcpy, "scrcpygui.scrcpy")
+
+namespace {
+
+int levelRank(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return 0;
+    case QtInfoMsg: return 1;
+    case QtWarningMsg: return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg: return 4;
+    }
+    return 0;
+}
+
+const char *levelName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return "Debug";
+    case QtInfoMsg: return "Info";
+    case QtWarningMsg: return "Warning";
+    case QtCriticalMsg: return "Critical";
+    case QtFatalMsg: return "Fatal";
+    }
+    return "Debug";
+}
+
+} // namespace
+
+Logger *Logger::instance()
+{
+    static Logger logger;
+    return &logger;
+}
+
+Logger::Logger()
+    : head(&stub)
+    , tail(&stub)
+{
+}
+
+Logger::~Logger()
+{
+    stop();
+}
+
+void Logger::start(const QString &path)
+{
+    if (running.load())
+        return;
+
+    filePath = path;
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    file = new QFile(filePath);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        fprintf(stderr, "Failed to open log file: %s\n", qPrintable(filePath));
+        delete file;
+        file = nullptr;
+        return;
+    }
+
+    running.store(true);
+    writerThread = QThread::create([this]() { writerLoop(); });
+    writerThread->setObjectName("LogWriter");
+    writerThread->start(QThread::LowPriority);
+}
+
+void Logger::stop()
+{
+    if (!running.exchange(false))
+        return;
+
+    wakeWriter();
+    writerThread->wait();
+    delete writerThread;
+    writerThread = nullptr;
+
+    // Anything pushed while the writer was shutting down
+    drain();
+    file->close();
+    delete file;
+    file = nullptr;
+}
+
+void Logger::flush()
+{
+    if (!running.load() || QThread::currentThread() == writerThread)
+        return;
+
+    QMutexLocker locker(&wakeMutex);
+    flushRequested.store(true);
+    wakeCondition.wakeOne();
+    while (flushRequested.load() && running.load())
+        flushedCondition.wait(&wakeMutex, 100);
+}
+
+void Logger::setMaxFileSize(qint64 bytes)
+{
+    maxFileSize = bytes;
+}
+
+void Logger::setRetainedFiles(int count)
+{
+    retainedFiles = qMax(0, count);
+}
+
+void Logger::setFlushInterval(int msecs)
+{
+    flushIntervalMs = qMax(1, msecs);
+}
+
+void Logger::setFlushThreshold(int messages)
+{
+    flushThreshold = qMax(1, messages);
+}
+
+void Logger::setCategoryLevel(const QString &category, QtMsgType minimumLevel)
+{
+    categoryLevels[category] = minimumLevel;
+    applyCategoryRules();
+}
+
+void Logger::loadCategoryLevels()
+{
+    static const QMap<QString, QtMsgType> names = {
+        { "debug", QtDebugMsg },
+        { "info", QtInfoMsg },
+        { "warning", QtWarningMsg },
+        { "critical", QtCriticalMsg }
+    };
+
+    QSettings settings("ScrcpyGUI", "Settings");
+    settings.beginGroup("log-levels");
+    for (const QString &category : settings.childKeys()) {
+        QString level = settings.value(category).toString().toLower();
+        if (names.contains(level))
+            categoryLevels[category] = names.value(level);
+    }
+    settings.endGroup();
+
+    applyCategoryRules();
+}
+
+void Logger::applyCategoryRules()
+{
+    static const QtMsgType levels[] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg };
+    static const char *suffixes[] = { "debug", "info", "warning", "critical" };
+
+    QStringList rules;
+    for (auto it = categoryLevels.cbegin(); it != categoryLevels.cend(); ++it) {
+        for (int i = 0; i < 4; ++i) {
+            bool enabled = levelRank(levels[i]) >= levelRank(it.value());
+            rules << QString("%1.%2=%3").arg(it.key(), QLatin1String(suffixes[i]),
+                                             QLatin1String(enabled ? "true" : "false"));
+        }
+    }
+    QLoggingCategory::setFilterRules(rules.join('\n'));
+}
+
+void Logger::messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    Logger *logger = instance();
+
+    if (logger->running.load()) {
+        logger->enqueue(type, context.category, msg);
+        // Show alert for critical/fatal errors; the file is not on screen
+        if (type == QtFatalMsg || type == QtCriticalMsg) {
+            fprintf(stderr, "%s: %s\n", levelName(type), qPrintable(msg));
+        }
+    } else {
+        QByteArray line = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ").toUtf8()
+                          + levelName(type) + ": " + msg.toUtf8();
+        fprintf(stderr, "%s\n", line.constData());
+    }
+
+    // Qt aborts right after the handler returns for fatal messages
+    if (type == QtFatalMsg) {
+        logger->flush();
+    }
+}
+
+void Logger::enqueue(QtMsgType type, const char *category, const QString &message)
+{
+    Metrics::instance()->countLogLines(Metrics::FileLog);
+    Entry *entry = new Entry;
+    entry->timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry->type = type;
+    entry->category = category;
+    entry->message = message;
+
+    Entry *prev = head.exchange(entry, std::memory_order_acq_rel);
+    prev->next.store(entry, std::memory_order_release);
+
+    if (pending.fetch_add(1, std::memory_order_relaxed) + 1 == flushThreshold)
+        wakeWriter();
+}
+
+Logger::Entry *Logger::dequeue()
+{
+    Entry *first = tail;
+    Entry *next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub) {
+        if (!next)
+            return nullptr;
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    // A producer has exchanged head but not linked its node yet
+    if (first != head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // Re-insert the stub so the last real node can be handed out
+    stub.next.store(nullptr, std::memory_order_relaxed);
+    Entry *prev = head.exchange(&stub, std::memory_order_acq_rel);
+    prev->next.store(&stub, std::memory_order_release);
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+void Logger::wakeWriter()
+{
+    QMutexLocker locker(&wakeMutex);
+    wakeCondition.wakeOne();
+}
+
+void Logger::writerLoop()
+{
+    while (running.load()) {
+        {
+            QMutexLocker locker(&wakeMutex);
+            if (pending.load(std::memory_order_relaxed) < flushThreshold && !flushRequested.load())
+                wakeCondition.wait(&wakeMutex, flushIntervalMs);
+        }
+
+        drain();
+
+        if (flushRequested.load()) {
+            QMutexLocker locker(&wakeMutex);
+            flushRequested.store(false);
+            flushedCondition.wakeAll();
+        }
+    }
+}
+
+void Logger::drain()
+{
+    if (!file)
+        return;
+
+    int count = 0;
+    while (Entry *entry = dequeue()) {
+        batch += formatEntry(*entry);
+        delete entry;
+        ++count;
+    }
+
+    if (count == 0)
+        return;
+
+    pending.fetch_sub(count, std::memory_order_relaxed);
+    file->write(batch);
+    file->flush();
+    batch.clear();
+
+    if (maxFileSize > 0 && file->size() >= maxFileSize)
+        rotate();
+}
+
+void Logger::rotate()
+{
+    file->close();
+
+    // scrcpy-gui.log -> scrcpy-gui.log.1 -> ... -> scrcpy-gui.log.N
+    QFile::remove(QString("%1.%2").arg(filePath).arg(retainedFiles));
+    for (int i = retainedFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(filePath).arg(i),
+                      QString("%1.%2").arg(filePath).arg(i + 1));
+    }
+    if (retainedFiles > 0)
+        QFile::rename(filePath, filePath + ".1");
+    else
+        QFile::remove(filePath);
+
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        fprintf(stderr, "Failed to reopen log file: %s\n", qPrintable(filePath));
+    }
+}
+
+QByteArray Logger::formatEntry(const Entry &entry)
+{
+    QByteArray line = QDateTime::fromMSecsSinceEpoch(entry.timestamp)
+                          .toString("yyyy-MM-dd hh:mm:ss.zzz ").toUtf8();
+    line += levelName(entry.type);
+    line += ": ";
+    if (entry.category && qstrcmp(entry.category, "default") != 0) {
+        line += '[';
+        line += entry.category;
+        line += "] ";
+    }
+    line += entry.message.toUtf8();
+    line += '\n';
+    return line;
+}
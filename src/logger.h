@@ -0,0 +1,92 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QLoggingCategory>
+#include <atomic>
+
+class QFile;
+class QThread;
+
+Q_DECLARE_LOGGING_CATEGORY(lcApp)
+Q_DECLARE_LOGGING_CATEGORY(lcAdb)
+Q_DECLARE_LOGGING_CATEGORY(lcScrcpy)
+
+// Asynchronous log writer behind the Qt message handler.
+//
+// Callers only push a node onto a lock-free multi-producer queue; a single
+// writer thread formats the messages, writes them in batches to one open
+// file handle and rotates the file once it grows past maxFileSize.
+class Logger
+{
+public:
+    static Logger *instance();
+
+    void start(const QString &filePath);
+    void stop();
+    void flush();
+
+    void setMaxFileSize(qint64 bytes);
+    void setRetainedFiles(int count);
+    void setFlushInterval(int msecs);
+    void setFlushThreshold(int messages);
+
+    // Minimum level for a category, e.g. ("scrcpygui.adb", QtInfoMsg).
+    // Disabled levels are filtered by QLoggingCategory before any formatting.
+    void setCategoryLevel(const QString &category, QtMsgType minimumLevel);
+    void loadCategoryLevels();
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+
+private:
+    struct Entry {
+        std::atomic<Entry *> next { nullptr };
+        qint64 timestamp = 0;
+        QtMsgType type = QtDebugMsg;
+        const char *category = nullptr;
+        QString message;
+    };
+
+    Logger();
+    ~Logger();
+
+    void enqueue(QtMsgType type, const char *category, const QString &message);
+    Entry *dequeue();
+    void wakeWriter();
+    void writerLoop();
+    void drain();
+    void rotate();
+    void applyCategoryRules();
+    static QByteArray formatEntry(const Entry &entry);
+
+    // Vyukov MPSC queue: producers exchange head, the writer owns tail.
+    std::atomic<Entry *> head;
+    Entry *tail;
+    Entry stub;
+
+    std::atomic<int> pending { 0 };
+    std::atomic<bool> running { false };
+    std::atomic<bool> flushRequested { false };
+
+    QMutex wakeMutex;
+    QWaitCondition wakeCondition;
+    QWaitCondition flushedCondition;
+
+    QThread *writerThread = nullptr;
+    QFile *file = nullptr;
+    QString filePath;
+    QByteArray batch;
+
+    qint64 maxFileSize = 5 * 1024 * 1024;
+    int retainedFiles = 3;
+    int flushIntervalMs = 250;
+    int flushThreshold = 256;
+
+    QMap<QString, QtMsgType> categoryLevels;
+};
+
+#endif // LOGGER_H
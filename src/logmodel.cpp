@@ -0,0 +1,151 @@
+#include "logmodel.h"
+#include "metrics.h"
+#include "tracer.h"
+#include <QTimer>
+#include <QBrush>
+#include <QStringList>
+
+namespace {
+// One UI update per frame at 60 Hz
+const int FLUSH_INTERVAL_MS = 16;
+}
+
+LogModel::LogModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , first(0)
+    , count(0)
+    , flushTimer(new QTimer(this))
+{
+    ring.resize(DEFAULT_LINE_CAP);
+
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(flushTimer, &QTimer::timeout, this, &LogModel::flushPending);
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count)
+        return QVariant();
+
+    const Line &line = lineAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return line.text;
+    case Qt::ForegroundRole:
+        return QBrush(severityColor(line.severity));
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::append(const QString &text, LogSeverity severity)
+{
+    TRACE_SPAN("LogModel::append");
+    const QStringList lines = text.split('\n');
+    Metrics::instance()->countLogLines(Metrics::UiLog, lines.size());
+    for (const QString &part : lines) {
+        Line line;
+        line.text = part.endsWith('\r') ? part.chopped(1) : part;
+        line.severity = severity;
+        pending.append(line);
+    }
+
+    // Lines that would be evicted in the same flush are never shown
+    int cap = ring.size();
+    if (pending.size() > cap)
+        pending.remove(0, pending.size() - cap);
+
+    if (!flushTimer->isActive())
+        flushTimer->start();
+}
+
+void LogModel::clear()
+{
+    flushTimer->stop();
+    pending.clear();
+
+    beginResetModel();
+    for (Line &line : ring)
+        line = Line();
+    first = 0;
+    count = 0;
+    endResetModel();
+}
+
+int LogModel::lineCap() const
+{
+    return ring.size();
+}
+
+void LogModel::setLineCap(int lines)
+{
+    lines = qMax(100, lines);
+    if (lines == ring.size())
+        return;
+
+    flushPending();
+
+    beginResetModel();
+    int keep = qMin(count, lines);
+    QVector<Line> resized(lines);
+    for (int i = 0; i < keep; ++i)
+        resized[i] = std::move(ring[(first + count - keep + i) % ring.size()]);
+    ring = std::move(resized);
+    first = 0;
+    count = keep;
+    endResetModel();
+}
+
+void LogModel::flushPending()
+{
+    if (pending.isEmpty())
+        return;
+
+    const int cap = ring.size();
+    const int incoming = pending.size();
+
+    int overflow = count + incoming - cap;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        for (int i = 0; i < overflow; ++i)
+            ring[(first + i) % cap] = Line();
+        first = (first + overflow) % cap;
+        count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), count, count + incoming - 1);
+    for (Line &line : pending) {
+        ring[(first + count) % cap] = std::move(line);
+        ++count;
+    }
+    endInsertRows();
+
+    pending.clear();
+    emit linesAppended();
+}
+
+const LogModel::Line &LogModel::lineAt(int row) const
+{
+    return ring.at((first + row) % ring.size());
+}
+
+QColor LogModel::severityColor(LogSeverity severity)
+{
+    switch (severity) {
+    case LogSeverity::Muted: return QColor(0x9e, 0x9e, 0x9e);
+    case LogSeverity::Info: return QColor(0x4f, 0xc3, 0xf7);
+    case LogSeverity::Success: return QColor(0x4c, 0xaf, 0x50);
+    case LogSeverity::Notice: return QColor(0xff, 0x98, 0x00);
+    case LogSeverity::Warning: return QColor(0xff, 0xc1, 0x07);
+    case LogSeverity::Error: return QColor(0xf4, 0x43, 0x36);
+    case LogSeverity::Normal: break;
+    }
+    return QColor(0xd4, 0xd4, 0xd4);
+}
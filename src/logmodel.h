@@ -0,0 +1,67 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include <QColor>
+
+class QTimer;
+
+enum class LogSeverity {
+    Normal,
+    Muted,
+    Info,
+    Success,
+    Notice,
+    Warning,
+    Error
+};
+
+// Bounded log buffer for the scrcpy log pane.
+//
+// Lines live in a fixed-size ring; once lineCap is reached the oldest lines
+// are dropped. Appends are queued and applied at most once per frame so a
+// chatty scrcpy process cannot force a relayout per line.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_LINE_CAP = 5000;
+
+    explicit LogModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void append(const QString &text, LogSeverity severity = LogSeverity::Normal);
+    void clear();
+
+    int lineCap() const;
+    void setLineCap(int lines);
+
+    static QColor severityColor(LogSeverity severity);
+
+signals:
+    void linesAppended();
+
+public slots:
+    void flushPending();
+
+private:
+    struct Line {
+        QString text;
+        LogSeverity severity = LogSeverity::Normal;
+    };
+
+    const Line &lineAt(int row) const;
+
+    QVector<Line> ring;
+    int first;
+    int count;
+    QVector<Line> pending;
+    QTimer *flushTimer;
+};
+
+#endif // LOGMODEL_H
@@ -1,70 +1,146 @@
 #include <QApplication>
-#include <QMessageBox>
-#include <QFile>
-#include <QTextStream>
-#include <QDateTime>
+#include <QCoreApplication>
 #include <QStandardPaths>
-#include <QDir>
+#include <QSettings>
+#include <QElapsedTimer>
+#include <QLockFile>
+#include <QThread>
 #include "mainwindow.h"
+#include "headlesscli.h"
+#include "controlclient.h"
+#include "controlserver.h"
+#include "customappstore.h"
+#include "logger.h"
+#include "tracer.h"
+#include <cstdio>
+#include <cstring>
 
-// Custom message handler to log to file and show alerts
-void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+static void setApplicationMetadata()
 {
-    // Get log file path
-    QString logPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(logPath);
-    if (!dir.exists()) dir.mkpath(".");
-    QString logFile = logPath + "/scrcpy-gui.log";
-
-    // Format message
-    QString txt;
-    switch (type) {
-    case QtDebugMsg:
-        txt = QString("Debug: %1").arg(msg);
-        break;
-    case QtInfoMsg:
-        txt = QString("Info: %1").arg(msg);
-        break;
-    case QtWarningMsg:
-        txt = QString("Warning: %1").arg(msg);
-        break;
-    case QtCriticalMsg:
-        txt = QString("Critical: %1").arg(msg);
-        break;
-    case QtFatalMsg:
-        txt = QString("Fatal: %1").arg(msg);
-        break;
+    QCoreApplication::setApplicationName("Qt GUI Scrcpy");
+    QCoreApplication::setApplicationVersion("1.0.8");
+    QCoreApplication::setOrganizationName("Qt GUI Scrcpy");
+}
+
+static void startLogger()
+{
+    // Log to file from a background writer thread
+    QSettings settings("ScrcpyGUI", "Settings");
+    Logger *logger = Logger::instance();
+    logger->setMaxFileSize(settings.value("log-max-size-mb", 5).toLongLong() * 1024 * 1024);
+    logger->setRetainedFiles(settings.value("log-retained-files", 3).toInt());
+    logger->loadCategoryLevels();
+    logger->start(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/scrcpy-gui.log");
+    qInstallMessageHandler(Logger::messageHandler);
+}
+
+static void stopLogger()
+{
+    qInstallMessageHandler(nullptr);
+    Logger::instance()->stop();
+}
+
+// `--control <command...>`: hand one command to the running instance and
+// print its reply. 0 = ok, 1 = the instance refused it, 3 = none running.
+static int runControlClient(int argc, char *argv[], int first)
+{
+    QCoreApplication app(argc, argv);
+    QByteArrayList words;
+    for (int i = first; i < argc; ++i) {
+        words << QByteArray(argv[i]);
     }
 
-    // Write to file
-    QFile outFile(logFile);
-    if (outFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        QTextStream ts(&outFile);
-        ts << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ") << txt << Qt::endl;
+    QByteArray reply;
+    if (!ControlClient::send(words.join(' '), &reply)) {
+        fputs("{\"ok\":false,\"error\":\"No running instance\"}\n", stdout);
+        return 3;
     }
+    fwrite(reply.constData(), 1, reply.size(), stdout);
+    fputc('\n', stdout);
+    return reply.contains("\"ok\":true") ? 0 : 1;
+}
+
+// How long a second start waits for the running instance to take "show"
+static const int INSTANCE_WAIT_MS = 10000;
 
-    // Show alert for critical/fatal errors
-    if (type == QtFatalMsg || type == QtCriticalMsg) {
-        // Use native message box if possible, or simple stderr if GUI not ready
-        fprintf(stderr, "%s\n", qPrintable(txt));
-        // Note: Cannot safely use QMessageBox in all contexts, but helpful for startup errors
-        // if QApplication is running.
+static void writeTrace(const QString &tracePath)
+{
+    if (!tracePath.isEmpty()) {
+        Tracer::instance()->writeChromeTrace(tracePath);
     }
 }
 
 int main(int argc, char *argv[])
 {
-    qInstallMessageHandler(messageHandler);
+    QElapsedTimer startup;
+    startup.start();
+
+    // Spans are recorded from here on; the file is written at exit
+    QString tracePath = Tracer::pathFromArguments(argc, argv);
+    if (!tracePath.isEmpty()) {
+        Tracer::instance()->enable();
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--control") == 0) {
+            return runControlClient(argc, argv, i + 1);
+        }
+    }
+
+    // Scripted use: no QApplication, no widgets, no window
+    if (HeadlessCli::isRequested(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        setApplicationMetadata();
+        startLogger();
+
+        int result;
+        {
+            HeadlessCli cli(startup);
+            result = cli.exec(app.arguments());
+        }
+
+        CustomAppStore::instance()->sync();
+        writeTrace(tracePath);
+        stopLogger();
+        return result;
+    }
 
     QApplication app(argc, argv);
+    setApplicationMetadata();
 
-    // Set application metadata
-    QApplication::setApplicationName("Qt GUI Scrcpy");
-    QApplication::setApplicationVersion("1.0.8");
-    QApplication::setOrganizationName("Qt GUI Scrcpy");
+    // Single instance: the lock holder owns the window and the control
+    // socket. A later start brings it forward, waiting out a holder that is
+    // still starting or busy, and only starts over once the holder is gone.
+    QLockFile instanceLock(ControlServer::instanceLockPath());
+    instanceLock.setStaleLockTime(0);
+    QElapsedTimer waiting;
+    waiting.start();
+    while (!instanceLock.tryLock(0)) {
+        if (ControlClient::send("show")) {
+            return 0;
+        }
+        if (waiting.elapsed() >= INSTANCE_WAIT_MS) {
+            fputs("scrcpy-gui is already running but does not answer\n", stderr);
+            return 1;
+        }
+        QThread::msleep(100);
+    }
+    startLogger();
+
+    int result;
+    {
+        MainWindow window;
+        {
+            TRACE_SPAN("MainWindow::show");
+            window.show();
+        }
+        result = app.exec();
+    }
 
-    MainWindow window;
-    window.show();
+    // Write custom app changes still waiting for their debounced flush
+    CustomAppStore::instance()->sync();
 
-    return app.exec();
+    writeTrace(tracePath);
+    stopLogger();
+    return result;
 }
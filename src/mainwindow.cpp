@@ -1,27 +1,80 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "settingsdialog.h"
+#include "launchmetricsdialog.h"
 #include <QMessageBox>
 #include <QInputDialog>
-#include <QDebug>
+#include "logger.h"
 #include <QSettings>
 #include <QDateTime>
+#include <QScrollBar>
+#include <QShortcut>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QSignalBlocker>
+#include <QMenu>
+#include <QActionGroup>
+#include <QTimer>
+#include "packagecatalog.h"
+#include "packageparser.h"
+#include "profilestore.h"
+#include "tracer.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , appManager(new AppManager(this))
-    , scrcpyProcess(nullptr)
+    , deviceManager(new DeviceManager(this))
+    , appManager(nullptr)
+    , appModel(new AppListModel(this))
+    , appProxy(new AppFilterProxyModel(this))
+    , iconLoader(new IconLoader(deviceManager->client(), this))
+    , iconTimer(new QTimer(this))
+    , logModel(new LogModel(this))
+    , logFollowTail(true)
+    , sessionManager(new SessionManager(this))
+    , sessionModel(new SessionListModel(sessionManager, this))
+    , shownSession(nullptr)
+    , launchMetrics(new LaunchMetrics(this))
+    , metricsServer(new MetricsServer(sessionManager, this))
+    , qualityController(new QualityController(sessionManager, this))
+    , sessionSupervisor(new SessionSupervisor(sessionManager, deviceManager, this))
+    , controlServer(new ControlServer(sessionManager, this))
+    , replaceSessions(false)
     , showRunningOnly(false)
+    , firstAppListShown(false)
 {
-    ui->setupUi(this);
+    TRACE_SPAN("MainWindow::MainWindow");
+    startupTimer.start();
+    {
+        TRACE_SPAN("MainWindow::setupUi");
+        ui->setupUi(this);
+    }
     setWindowIcon(QIcon(":/resources/icon.png"));
     
     // Set splitter initial sizes (60% left, 40% right)
     ui->splitter->setSizes(QList<int>() << 600 << 400);
     
+    appProxy->setSourceModel(appModel);
+    ui->appListView->setModel(appProxy);
+
+    // Icons for the rows on screen and a page either side, once scrolling settles
+    appModel->setIconLoader(iconLoader);
+    ui->appListView->setIconSize(QSize(24, 24));
+    iconTimer->setSingleShot(true);
+    iconTimer->setInterval(50);
+    connect(iconTimer, &QTimer::timeout, this, &MainWindow::requestVisibleIcons);
+    QScrollBar *appScrollBar = ui->appListView->verticalScrollBar();
+    connect(appScrollBar, &QScrollBar::valueChanged, iconTimer, qOverload<>(&QTimer::start));
+    connect(appScrollBar, &QScrollBar::rangeChanged, iconTimer, qOverload<>(&QTimer::start));
+    connect(appProxy, &QAbstractItemModel::rowsInserted, iconTimer, qOverload<>(&QTimer::start));
+    connect(appProxy, &QAbstractItemModel::rowsRemoved, iconTimer, qOverload<>(&QTimer::start));
+    connect(appProxy, &QAbstractItemModel::modelReset, iconTimer, qOverload<>(&QTimer::start));
+    connect(appProxy, &QAbstractItemModel::layoutChanged, iconTimer, qOverload<>(&QTimer::start));
+
     // Connect signals from UI elements
-    connect(ui->appListWidget, &QListWidget::itemClicked, this, &MainWindow::onAppSelected);
+    connect(ui->appListView, &QListView::clicked, this, &MainWindow::onAppSelected);
+    ui->appListView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(ui->appListView, &QListView::customContextMenuRequested, this, &MainWindow::onAppContextMenu);
     connect(ui->refreshButton, &QPushButton::clicked, this, &MainWindow::onRefreshClicked);
     connect(ui->manualAddButton, &QPushButton::clicked, this, &MainWindow::onManualAddClicked);
     connect(ui->mirrorDeviceButton, &QPushButton::clicked, this, &MainWindow::onMirrorDeviceClicked);
@@ -29,9 +82,51 @@ MainWindow::MainWindow(QWidget *parent)
     // Connect filter radio buttons
     connect(ui->allAppsRadio, &QRadioButton::toggled, this, &MainWindow::onFilterChanged);
     connect(ui->runningOnlyRadio, &QRadioButton::toggled, this, &MainWindow::onFilterChanged);
+
+    // Search box
+    connect(ui->searchEdit, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
+    connect(ui->searchEdit, &QLineEdit::returnPressed, this, &MainWindow::onSearchReturnPressed);
+    QShortcut *findShortcut = new QShortcut(QKeySequence::Find, this);
+    connect(findShortcut, &QShortcut::activated, this, [this]() {
+        ui->searchEdit->setFocus();
+        ui->searchEdit->selectAll();
+    });
     
+    // Log pane: bounded model, only visible rows are laid out
+    QSettings settings("ScrcpyGUI", "Settings");
+    logModel->setLineCap(settings.value("log-line-cap", LogModel::DEFAULT_LINE_CAP).toInt());
+    sessionManager->setLogLineCap(logModel->lineCap());
+    replaceSessions = settings.value("replace-session", false).toBool();
+    showLog(nullptr);
+    connect(ui->logView->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::onLogScrolled);
+    QShortcut *copyShortcut = new QShortcut(QKeySequence::Copy, ui->logView);
+    copyShortcut->setContext(Qt::WidgetShortcut);
+    connect(copyShortcut, &QShortcut::activated, this, &MainWindow::copySelectedLogLines);
+
+    // Scrcpy sessions; selecting one shows its log
+    ui->sessionListView->setModel(sessionModel);
+    connect(ui->sessionListView->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &MainWindow::onSessionSelected);
+    connect(sessionManager, &SessionManager::sessionChanged, this, &MainWindow::onSessionChanged);
+    connect(sessionManager, &SessionManager::sessionError, this, &MainWindow::onSessionError);
+    connect(sessionManager, &SessionManager::sessionAboutToBeRemoved, this, &MainWindow::onSessionRemoved);
+    metricsServer->loadSettings();
+    qualityController->loadSettings();
+    connect(qualityController, &QualityController::sessionRelaunched, this, &MainWindow::onSessionRelaunched);
+    connect(sessionSupervisor, &SessionSupervisor::sessionRestarted, this, &MainWindow::onSessionRestarted);
+
+    // Commands from launchers and later starts of the app
+    connect(controlServer, &ControlServer::showRequested, this, &MainWindow::onControlShow);
+    connect(controlServer, &ControlServer::refreshRequested, this, &MainWindow::onRefreshClicked);
+    connect(controlServer, &ControlServer::launchRequested, this, &MainWindow::onControlLaunch);
+    if (!controlServer->listen()) {
+        ui->statusBar->showMessage("Control socket unavailable; --control will not reach this window", 10000);
+    }
+
     // Connect scrcpy control buttons
     connect(ui->stopScrcpyButton, &QPushButton::clicked, this, &MainWindow::onStopScrcpyClicked);
+    connect(ui->stopAllButton, &QPushButton::clicked, this, &MainWindow::onStopAllClicked);
+    connect(ui->removeFinishedButton, &QPushButton::clicked, this, &MainWindow::onRemoveFinishedClicked);
     connect(ui->clearLogsButton, &QPushButton::clicked, this, &MainWindow::onClearLogsClicked);
     
     // Connect menu actions
@@ -45,10 +140,17 @@ MainWindow::MainWindow(QWidget *parent)
     ui->menuBar->addAction(actionSettings);
     connect(actionSettings, &QAction::triggered, this, &MainWindow::onSettings);
 
-    // Connect app manager signals
-    connect(appManager, &AppManager::appsLoaded, this, &MainWindow::onAppsLoaded);
-    connect(appManager, &AppManager::loadError, this, &MainWindow::onLoadError);
-    connect(appManager, &AppManager::runningAppsLoaded, this, &MainWindow::onRunningAppsLoaded);
+    QAction *actionLaunchMetrics = new QAction("Launch Latency", this);
+    ui->menuHelp->insertAction(ui->actionAbout, actionLaunchMetrics);
+    connect(actionLaunchMetrics, &QAction::triggered, this, &MainWindow::onLaunchMetrics);
+
+    // Devices; each one has its own AppManager
+    connect(ui->deviceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onDeviceSelected);
+    connect(deviceManager, &DeviceManager::devicesChanged, this, &MainWindow::onDevicesChanged);
+    connect(deviceManager, &DeviceManager::deviceError, this, &MainWindow::onDeviceError);
+    connect(deviceManager, &DeviceManager::deviceAppsLoaded, this, &MainWindow::onDeviceAppsLoaded);
+    connect(deviceManager, &DeviceManager::refreshFinished, this, &MainWindow::onDevicesRefreshed);
+    setCurrentDevice(PackageCatalog::lastSerial());
 
     // Load apps on startup
     loadAppList();
@@ -56,10 +158,23 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
-    stopScrcpy();
+    // The only place we wait on scrcpy; everything else stops asynchronously
+    sessionManager->shutdown();
     delete ui;
 }
 
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::ActivationChange || event->type() == QEvent::WindowStateChange) {
+        if (appManager) {
+            RunningAppsMonitor *monitor = appManager->runningAppsMonitor();
+            monitor->setPaused(isMinimized());
+            monitor->setFocused(isActiveWindow());
+        }
+    }
+    QMainWindow::changeEvent(event);
+}
+
 void MainWindow::setupUI()
 {
     // No longer needed - UI is set up by ui->setupUi(this)
@@ -67,251 +182,404 @@ void MainWindow::setupUI()
 
 void MainWindow::loadAppList()
 {
+    TRACE_SPAN("MainWindow::loadAppList");
     ui->statusLabel->setText("Loading apps...");
-    ui->appListWidget->clear();
     ui->refreshButton->setEnabled(false);
 
-    appManager->loadApps();
+    // Lists devices first, then loads every device's apps in parallel
+    deviceManager->refresh();
 }
 
-void MainWindow::addAppToList(const AppInfo &appInfo)
+void MainWindow::setCurrentDevice(const QString &serial)
 {
-    QListWidgetItem *item = new QListWidgetItem(appInfo.name);
-    item->setData(Qt::UserRole, appInfo.packageName);
-    ui->appListWidget->addItem(item);
+    if (appManager && currentSerial == serial) {
+        return;
+    }
+
+    if (appManager) {
+        appManager->runningAppsMonitor()->stop();
+        disconnect(appManager, nullptr, this, nullptr);
+        disconnect(appManager->runningAppsMonitor(), nullptr, this, nullptr);
+    }
+
+    currentSerial = serial;
+    appManager = deviceManager->appManager(serial);
+    iconLoader->setSerial(serial);
+    qCDebug(lcApp) << "Current device:" << (serial.isEmpty() ? QString("(any)") : serial);
+
+    connect(appManager, &AppManager::appsLoaded, this, &MainWindow::onAppsLoaded);
+    connect(appManager, &AppManager::cachedAppsLoaded, this, &MainWindow::onCachedAppsLoaded);
+    connect(appManager, &AppManager::loadError, this, &MainWindow::onLoadError);
+    connect(appManager, &AppManager::runningAppsLoaded, this, &MainWindow::onRunningAppsLoaded);
+
+    // Running state is polled in the background and applied as deltas
+    RunningAppsMonitor *monitor = appManager->runningAppsMonitor();
+    connect(monitor, &RunningAppsMonitor::runningAppsAdded, this, &MainWindow::onRunningAppsAdded);
+    connect(monitor, &RunningAppsMonitor::runningAppsRemoved, this, &MainWindow::onRunningAppsRemoved);
+
+    appModel->setApps(appManager->apps());
+    appModel->setRunningPackages(monitor->runningPackages());
+    applyFilter();
+
+    monitor->setFocused(isActiveWindow());
+    monitor->setPaused(isMinimized());
+    monitor->start();
 }
 
-void MainWindow::onAppSelected(QListWidgetItem *item)
+void MainWindow::onDeviceSelected(int index)
 {
-    if (!item) return;
+    if (index < 0) {
+        return;
+    }
+    setCurrentDevice(ui->deviceCombo->itemData(index).toString());
+}
 
-    QString packageName = item->data(Qt::UserRole).toString();
-    QString appName = item->text();
+void MainWindow::onDevicesChanged(const QList<DeviceInfo> &devices)
+{
+    QString wanted = currentSerial;
+    QString firstReady;
+    bool wantedReady = false;
+
+    QSignalBlocker blocker(ui->deviceCombo);
+    ui->deviceCombo->clear();
+    for (const DeviceInfo &device : devices) {
+        QString text = device.displayName();
+        if (!device.isReady()) {
+            text += " - " + device.state;
+        }
+        ui->deviceCombo->addItem(text, device.serial);
 
-    qDebug() << "Launching scrcpy for:" << packageName;
+        if (device.isReady()) {
+            if (firstReady.isEmpty()) {
+                firstReady = device.serial;
+            }
+            if (device.serial == wanted) {
+                wantedReady = true;
+            }
+        }
+    }
 
-    // Stop current scrcpy if running
-    if (scrcpyProcess && scrcpyProcess->state() == QProcess::Running) {
-        appendLog("Stopping current scrcpy session...", "#ff9800");
-        stopScrcpy();
+    if (firstReady.isEmpty()) {
+        // Nothing usable: let a plain adb shell report what's wrong
+        ui->deviceCombo->setEnabled(false);
+        setCurrentDevice(QString());
+        appManager->loadApps();
+        return;
     }
 
-    launchScrcpy(packageName, appName);
+    ui->deviceCombo->setEnabled(true);
+    QString serial = wantedReady ? wanted : firstReady;
+    ui->deviceCombo->setCurrentIndex(ui->deviceCombo->findData(serial));
+    setCurrentDevice(serial);
 }
 
-void MainWindow::launchScrcpy(const QString &packageName, const QString &appName)
+void MainWindow::onDeviceError(const QString &error)
 {
-    currentPackageName = packageName;
-    currentAppName = appName;
-    
-    if (scrcpyProcess) {
-        delete scrcpyProcess;
-    }
-
-    scrcpyProcess = new QProcess(this);
+    qCDebug(lcAdb) << "Device listing failed, using the default device:" << error;
+    setCurrentDevice(QString());
+    appManager->loadApps();
+}
 
-    // Connect signals
-    connect(scrcpyProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &MainWindow::onScrcpyFinished);
-    connect(scrcpyProcess, &QProcess::errorOccurred, this, &MainWindow::onScrcpyError);
-    connect(scrcpyProcess, &QProcess::started, this, &MainWindow::onScrcpyStarted);
-    connect(scrcpyProcess, &QProcess::readyReadStandardOutput, this, &MainWindow::onScrcpyReadyReadStandardOutput);
-    connect(scrcpyProcess, &QProcess::readyReadStandardError, this, &MainWindow::onScrcpyReadyReadStandardError);
+void MainWindow::onDeviceAppsLoaded(const QString &serial, const QList<AppInfo> &apps)
+{
+    int index = ui->deviceCombo->findData(serial);
+    if (index >= 0) {
+        ui->deviceCombo->setItemText(index, QString("%1 - %2 apps")
+                                     .arg(deviceManager->device(serial).displayName())
+                                     .arg(apps.size()));
+    }
+}
 
-    // Build scrcpy command
-    QStringList arguments;
+void MainWindow::onDevicesRefreshed(int deviceCount, qint64 elapsedMs)
+{
+    ui->refreshButton->setEnabled(true);
+    if (deviceCount > 1) {
+        ui->statusBar->showMessage(QString("Refreshed %1 devices in %2 ms").arg(deviceCount).arg(elapsedMs), 5000);
+    }
+}
 
-    // Only use --new-display and --start-app if launching specific app
-    if (!packageName.isEmpty()) {
-        arguments << "--new-display";
-        arguments << "--start-app=" + packageName;
+void MainWindow::reportFirstAppList(const char *source)
+{
+    if (firstAppListShown) {
+        return;
     }
+    firstAppListShown = true;
 
-    // Load settings
-    QSettings settings("ScrcpyGUI", "Settings");
+    qint64 elapsed = startupTimer.elapsed();
+    qCInfo(lcApp) << "First app list shown after" << elapsed << "ms from" << source
+                  << "with" << appModel->rowCount() << "apps";
+    ui->statusBar->showMessage(QString("App list ready in %1 ms (%2)").arg(elapsed).arg(QLatin1String(source)), 5000);
+}
 
-    // General
-    if (settings.value("always-on-top", false).toBool()) arguments << "--always-on-top";
-    if (settings.value("no-control", false).toBool()) arguments << "--no-control";
-    if (settings.value("stay-awake", false).toBool()) arguments << "--stay-awake";
-    if (settings.value("turn-screen-off", false).toBool()) arguments << "--turn-screen-off";
-    if (settings.value("no-vd-destroy-content", false).toBool()) arguments << "--no-vd-destroy-content";
-    if (settings.value("show-touches", false).toBool()) arguments << "--show-touches";
-    if (settings.value("disable-screensaver", false).toBool()) arguments << "--disable-screensaver";
+void MainWindow::onAppSelected(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
 
-    // Video
-    int maxSize = settings.value("max-size", 0).toInt();
-    if (maxSize > 0) arguments << "--max-size" << QString::number(maxSize);
+    LaunchTrace trace;
+    trace.start();
 
-    QString bitRate = settings.value("bit-rate", "Default (8M)").toString();
-    if (bitRate != "Default (8M)") arguments << "--bit-rate" << bitRate;
+    QString packageName = index.data(AppListModel::PackageNameRole).toString();
+    QString appName = index.data(Qt::DisplayRole).toString();
 
-    int maxFps = settings.value("max-fps", 0).toInt();
-    if (maxFps > 0) arguments << "--max-fps" << QString::number(maxFps);
+    qCDebug(lcScrcpy) << "Launching scrcpy for:" << packageName;
 
-    QString videoCodec = settings.value("video-codec", "Default (h264)").toString();
-    if (videoCodec != "Default (h264)") arguments << "--video-codec" << videoCodec;
+    launchScrcpy(packageName, appName, trace);
+}
 
-    int rotation = settings.value("rotation", 0).toInt();
-    if (rotation > 0) arguments << "--rotation" << QString::number(rotation);
+void MainWindow::launchScrcpy(const QString &packageName, const QString &appName,
+                              LaunchTrace trace, const QString &profileName)
+{
+    TRACE_SPAN("MainWindow::launchScrcpy");
+    if (!trace.isValid()) {
+        trace.start();
+    }
 
-    if (settings.value("no-mipmaps", false).toBool()) arguments << "--no-mipmaps";
+    QString serial = currentSerial;
 
-    // Audio
-    if (settings.value("no-audio", false).toBool()) arguments << "--no-audio";
-    
-    QString audioCodec = settings.value("audio-codec", "Default (opus)").toString();
-    if (audioCodec != "Default (opus)") arguments << "--audio-codec" << audioCodec;
+    // Each app has its own window already; bring the user to its session
+    ScrcpySession *existing = sessionManager->findActive(serial, packageName);
+    if (existing) {
+        appendLog(appName + " is already running (session #" + QString::number(existing->id()) + ")",
+                  LogSeverity::Notice);
+        selectSession(existing);
+        return;
+    }
 
-    QString audioBitRate = settings.value("audio-bit-rate", "Default (128K)").toString();
-    if (audioBitRate != "Default (128K)") arguments << "--audio-bit-rate" << audioBitRate;
+    // Compiled once per settings change; no settings I/O or parsing here
+    ProfileStore *profiles = ProfileStore::instance();
+    const ScrcpyProfile &profile = profileName.isEmpty() ? profiles->profileFor(packageName)
+                                                         : profiles->profile(profileName);
+    QStringList arguments = profile.launchArguments(serial, packageName, appName);
+    if (!profile.customArgsError.isEmpty()) {
+        appendLog(profile.customArgsError + "; custom arguments ignored", LogSeverity::Warning);
+    }
 
-    // Window
-    if (settings.value("fullscreen", false).toBool()) arguments << "--fullscreen";
-    if (settings.value("window-borderless", false).toBool()) arguments << "--window-borderless";
-    
-    QString windowTitle = settings.value("window-title", "").toString();
-    if (!windowTitle.isEmpty()) {
-        arguments << "--window-title" << windowTitle;
-    } else {
-        arguments << "--window-title" << appName;
+    // Sessions that this launch replaces; they are stopped only after the new
+    // one is on its way so the two overlap instead of running back to back
+    QList<ScrcpySession *> replaced;
+    if (replaceSessions) {
+        for (ScrcpySession *other : sessionManager->sessions()) {
+            if (other->isActive() && other->state() != ScrcpySession::Stopping && other->serial() == serial) {
+                replaced.append(other);
+            }
+        }
+    }
+
+    trace.mark(LaunchTrace::SettingsResolved);
+    trace.videoCodec = profile.videoCodec;
+    trace.bitRate = profile.bitRate;
+
+    bool adaptive = qualityController->isEnabled();
+    ScrcpySession *session = adaptive
+        ? qualityController->launch(serial, packageName, appName, arguments, trace)
+        : sessionManager->startSession(serial, packageName, appName, arguments, trace);
+    watchSession(session);
+    if (profile.autoRestart) {
+        // Restarts go through the same launcher, so they stay adaptive
+        sessionSupervisor->supervise(session, [this, adaptive, serial, packageName, appName, arguments]() {
+            return adaptive ? qualityController->launch(serial, packageName, appName, arguments)
+                            : sessionManager->startSession(serial, packageName, appName, arguments);
+        });
     }
 
-    // Advanced
-    QString customArgs = settings.value("custom-args", "").toString();
-    if (!customArgs.isEmpty()) {
-        arguments << customArgs.split(" ", Qt::SkipEmptyParts);
+    for (ScrcpySession *other : std::as_const(replaced)) {
+        qCDebug(lcScrcpy) << "Session" << session->id() << "replaces session" << other->id();
+        other->stop();
     }
 
-    qDebug() << "Launching scrcpy with args:" << arguments;
+    selectSession(session);
+    updateScrcpyStatus();
+}
+
+void MainWindow::watchSession(ScrcpySession *session)
+{
+    connect(session, &ScrcpySession::windowShown, this, [this, session](qint64 latencyMs) {
+        appendLog(QString("%1 window shown in %2 ms").arg(session->appName()).arg(latencyMs), LogSeverity::Muted);
+    });
+    connect(session, &ScrcpySession::launchTraced, launchMetrics, &LaunchMetrics::record);
+}
 
-    appendLog("========================================", "#4fc3f7");
-    appendLog(QString("[%1] Launching scrcpy: %2")
-              .arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
-              .arg(appName), "#4fc3f7");
-    if (!packageName.isEmpty()) {
-        appendLog("Package: " + packageName, "#9e9e9e");
+void MainWindow::appendLog(const QString &text, LogSeverity severity)
+{
+    logModel->append(text, severity);
+}
+
+// Shows the given session's log, or the general log for nullptr
+void MainWindow::showLog(ScrcpySession *session)
+{
+    LogModel *current = qobject_cast<LogModel *>(ui->logView->model());
+    if (current) {
+        disconnect(current, &LogModel::linesAppended, this, &MainWindow::onLogLinesAppended);
     }
-    appendLog("Command: scrcpy " + arguments.join(" "), "#9e9e9e");
-    appendLog("========================================", "#4fc3f7");
 
-    ui->scrcpyStatusLabel->setText("Starting " + appName + "...");
-    scrcpyProcess->start("scrcpy", arguments);
+    shownSession = session;
+    LogModel *model = session ? session->log() : logModel;
+    ui->logView->setModel(model);
+    connect(model, &LogModel::linesAppended, this, &MainWindow::onLogLinesAppended);
+
+    logFollowTail = true;
+    ui->logView->scrollToBottom();
 }
 
-void MainWindow::stopScrcpy()
+void MainWindow::selectSession(ScrcpySession *session)
 {
-    if (scrcpyProcess && scrcpyProcess->state() == QProcess::Running) {
-        appendLog("Terminating scrcpy...", "#ff9800");
-        scrcpyProcess->terminate();
-        if (!scrcpyProcess->waitForFinished(3000)) {
-            appendLog("Force killing scrcpy...", "#f44336");
-            scrcpyProcess->kill();
-        }
+    int row = sessionModel->rowOf(session);
+    if (row >= 0) {
+        ui->sessionListView->setCurrentIndex(sessionModel->index(row));
     }
 }
 
-void MainWindow::appendLog(const QString &text, const QString &color)
+ScrcpySession *MainWindow::selectedSession() const
 {
-    QString coloredText = QString("<span style='color:%1;'>%2</span>")
-                          .arg(color)
-                          .arg(text.toHtmlEscaped());
-    ui->logTextEdit->append(coloredText);
+    QModelIndex current = ui->sessionListView->currentIndex();
+    return current.isValid() ? sessionModel->sessionAt(current.row()) : nullptr;
 }
 
-void MainWindow::onStopScrcpyClicked()
+void MainWindow::onLogLinesAppended()
 {
-    stopScrcpy();
+    if (logFollowTail) {
+        ui->logView->scrollToBottom();
+    }
 }
 
-void MainWindow::onClearLogsClicked()
+void MainWindow::requestVisibleIcons()
 {
-    ui->logTextEdit->clear();
-    appendLog("Logs cleared", "#9e9e9e");
+    QListView *view = ui->appListView;
+    int rows = appProxy->rowCount();
+    QModelIndex top = view->indexAt(QPoint(0, 0));
+    if (rows == 0 || !top.isValid()) {
+        return;
+    }
+    QModelIndex bottom = view->indexAt(QPoint(0, view->viewport()->height() - 1));
+
+    int first = top.row();
+    int last = bottom.isValid() ? bottom.row() : rows - 1;
+    int page = last - first + 1;
+
+    QList<AppInfo> wanted;
+    wanted.reserve(page * 3);
+    auto add = [this, &wanted](int row) {
+        wanted.append(appModel->appAt(appProxy->mapToSource(appProxy->index(row, 0)).row()));
+    };
+    for (int row = first; row <= last; ++row) {
+        add(row);
+    }
+    for (int row = last + 1; row <= qMin(rows - 1, last + page); ++row) {
+        add(row);
+    }
+    for (int row = first - 1; row >= qMax(0, first - page); --row) {
+        add(row);
+    }
+    iconLoader->request(wanted);
 }
 
-void MainWindow::onScrcpyStarted()
+void MainWindow::onLogScrolled(int value)
 {
-    qDebug() << "Scrcpy started successfully";
-    appendLog("Scrcpy started successfully!", "#4caf50");
-    ui->scrcpyStatusLabel->setText("Running: " + currentAppName);
-    ui->scrcpyStatusLabel->setStyleSheet("color: #4caf50; padding: 5px;");
-    ui->stopScrcpyButton->setEnabled(true);
+    logFollowTail = value >= ui->logView->verticalScrollBar()->maximum();
 }
 
-void MainWindow::onScrcpyFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void MainWindow::copySelectedLogLines()
 {
-    qDebug() << "Scrcpy finished with exit code:" << exitCode;
+    QModelIndexList selected = ui->logView->selectionModel()->selectedRows();
+    std::sort(selected.begin(), selected.end());
 
-    ui->stopScrcpyButton->setEnabled(false);
+    QStringList lines;
+    for (const QModelIndex &index : selected) {
+        lines << index.data().toString();
+    }
+    QGuiApplication::clipboard()->setText(lines.join('\n'));
+}
 
-    if (exitStatus == QProcess::NormalExit && exitCode == 0) {
-        appendLog("Scrcpy closed normally", "#4caf50");
-        ui->scrcpyStatusLabel->setText("No scrcpy running");
-        ui->scrcpyStatusLabel->setStyleSheet("color: gray; padding: 5px;");
-    } else {
-        appendLog(QString("Scrcpy exited with error code: %1").arg(exitCode), "#f44336");
-        ui->scrcpyStatusLabel->setText("Scrcpy error - see logs");
-        ui->scrcpyStatusLabel->setStyleSheet("color: #f44336; padding: 5px;");
+void MainWindow::onStopScrcpyClicked()
+{
+    ScrcpySession *session = selectedSession();
+    if (session) {
+        sessionManager->stopSession(session->id());
     }
 }
 
-void MainWindow::onScrcpyError(QProcess::ProcessError error)
+void MainWindow::onStopAllClicked()
 {
-    QString errorMsg;
+    sessionManager->stopAll();
+}
 
-    switch (error) {
-        case QProcess::FailedToStart:
-            errorMsg = "Failed to start scrcpy. Make sure scrcpy is installed and in your PATH.";
-            appendLog("ERROR: " + errorMsg, "#f44336");
-            QMessageBox::critical(this, "Scrcpy Error", errorMsg + "\n\nYou can install it from: https://github.com/Genymobile/scrcpy");
-            break;
-        case QProcess::Crashed:
-            errorMsg = "Scrcpy crashed";
-            appendLog("ERROR: " + errorMsg, "#f44336");
-            break;
-        case QProcess::Timedout:
-            errorMsg = "Scrcpy operation timed out";
-            appendLog("ERROR: " + errorMsg, "#f44336");
-            break;
-        default:
-            errorMsg = "An error occurred with scrcpy: " + scrcpyProcess->errorString();
-            appendLog("ERROR: " + errorMsg, "#f44336");
-    }
+void MainWindow::onRemoveFinishedClicked()
+{
+    sessionManager->removeFinished();
+}
 
-    qDebug() << "Scrcpy error:" << errorMsg;
-    ui->scrcpyStatusLabel->setText("Error - see logs");
-    ui->scrcpyStatusLabel->setStyleSheet("color: #f44336; padding: 5px;");
-    ui->stopScrcpyButton->setEnabled(false);
+void MainWindow::onClearLogsClicked()
+{
+    LogModel *model = shownSession ? shownSession->log() : logModel;
+    model->clear();
+    model->append("Logs cleared", LogSeverity::Muted);
 }
 
-void MainWindow::onScrcpyReadyReadStandardOutput()
+void MainWindow::onSessionSelected(const QModelIndex &current)
 {
-    QString output = QString::fromLocal8Bit(scrcpyProcess->readAllStandardOutput());
-    if (!output.trimmed().isEmpty()) {
-        appendLog("[stdout] " + output.trimmed(), "#d4d4d4");
-    }
+    showLog(current.isValid() ? sessionModel->sessionAt(current.row()) : nullptr);
+    updateScrcpyStatus();
+}
+
+void MainWindow::onSessionChanged(ScrcpySession *session)
+{
+    Q_UNUSED(session);
+    updateScrcpyStatus();
 }
 
-void MainWindow::onScrcpyReadyReadStandardError()
+void MainWindow::onSessionRemoved(ScrcpySession *session)
 {
-    QString output = QString::fromLocal8Bit(scrcpyProcess->readAllStandardError());
-    if (!output.trimmed().isEmpty()) {
-        // stderr dari scrcpy biasanya info, bukan error
-        appendLog("[stderr] " + output.trimmed(), "#ffc107");
+    if (session == shownSession) {
+        showLog(nullptr);
     }
 }
 
-void MainWindow::onMirrorDeviceClicked()
+void MainWindow::onSessionError(ScrcpySession *session, QProcess::ProcessError error)
 {
-    qDebug() << "Launching full device mirror";
+    Q_UNUSED(session);
+    if (error == QProcess::FailedToStart) {
+        QMessageBox::critical(this, "Scrcpy Error",
+                              "Failed to start scrcpy. Make sure scrcpy is installed and in your PATH."
+                              "\n\nYou can install it from: https://github.com/Genymobile/scrcpy");
+    }
+    updateScrcpyStatus();
+}
 
-    // Stop current scrcpy if running
-    if (scrcpyProcess && scrcpyProcess->state() == QProcess::Running) {
-        appendLog("Stopping current scrcpy session...", "#ff9800");
-        stopScrcpy();
+void MainWindow::updateScrcpyStatus()
+{
+    int active = sessionManager->activeCount();
+    ScrcpySession *session = selectedSession();
+
+    ui->stopScrcpyButton->setEnabled(session && session->isActive());
+    ui->stopAllButton->setEnabled(active > 0);
+
+    QString color = "gray";
+    QString status;
+    if (session) {
+        status = session->statusText();
+        if (session->state() == ScrcpySession::Running) {
+            color = "#4caf50";
+        } else if (session->state() == ScrcpySession::Failed) {
+            color = "#f44336";
+        }
+        if (active > 1) {
+            status += QString("  [%1 sessions running]").arg(active);
+        }
+    } else if (active > 0) {
+        status = QString("%1 scrcpy sessions running").arg(active);
+        color = "#4caf50";
+    } else {
+        status = "No scrcpy running";
     }
 
+    ui->scrcpyStatusLabel->setText(status);
+    ui->scrcpyStatusLabel->setStyleSheet("color: " + color + "; padding: 5px;");
+}
+
+void MainWindow::onMirrorDeviceClicked()
+{
+    qCDebug(lcScrcpy) << "Launching full device mirror";
+
     // Launch scrcpy in full device mirror mode (empty packageName)
     launchScrcpy("", "Full Device Mirror");
 }
@@ -347,7 +615,8 @@ void MainWindow::onManualAddClicked()
             appInfo.name = displayName;
             appInfo.isCustom = true;
 
-            addAppToList(appInfo);
+            appModel->addApp(appInfo);
+            applyFilter();
             appManager->saveCustomApp(appInfo);
 
             ui->statusLabel->setText("Added: " + displayName);
@@ -355,11 +624,18 @@ void MainWindow::onManualAddClicked()
     }
 }
 
+void MainWindow::onCachedAppsLoaded(const QList<AppInfo> &apps)
+{
+    appModel->setApps(apps);
+    applyFilter();
+    reportFirstAppList("cache");
+    ui->statusLabel->setText(QString("Showing %1 cached apps, refreshing...").arg(apps.size()));
+}
+
 void MainWindow::onAppsLoaded(const QList<AppInfo> &apps)
 {
-    allLoadedApps = apps;  // Store all apps
-    
-    ui->appListWidget->clear();
+    appModel->setApps(apps);
+    reportFirstAppList("adb");
 
     if (apps.isEmpty()) {
         ui->statusLabel->setText("No apps found. Make sure device is connected.");
@@ -408,10 +684,105 @@ void MainWindow::onAbout()
                       "<p>Licensed under MIT License</p>");
 }
 
+void MainWindow::onSessionRelaunched(ScrcpySession *previous, ScrcpySession *replacement, int level)
+{
+    QualityLevel rung = QualityController::level(level);
+    QString quality = level == 0 ? QString("the configured quality")
+                                 : QString("%1, %2 fps, %3 px").arg(rung.bitRate).arg(rung.maxFps).arg(rung.maxSize);
+    appendLog(QString("%1 relaunched as session #%2 at %3")
+              .arg(replacement->appName())
+              .arg(replacement->id())
+              .arg(quality), LogSeverity::Notice);
+    watchSession(replacement);
+    if (selectedSession() == previous) {
+        selectSession(replacement);
+    }
+    updateScrcpyStatus();
+}
+
+void MainWindow::onSessionRestarted(ScrcpySession *previous, ScrcpySession *replacement)
+{
+    appendLog(QString("%1 restarted as session #%2")
+              .arg(replacement->appName())
+              .arg(replacement->id()), LogSeverity::Notice);
+    watchSession(replacement);
+    if (previous && selectedSession() == previous) {
+        selectSession(replacement);
+    }
+    updateScrcpyStatus();
+}
+
+void MainWindow::onControlLaunch(const QString &packageName, const QString &profileName)
+{
+    LaunchTrace trace;
+    trace.start();
+
+    int row = appModel->rowOf(packageName);
+    QString appName = row >= 0 ? appModel->appAt(row).name : PackageParser::packageToName(packageName);
+    qCDebug(lcScrcpy) << "Launching scrcpy for" << packageName << "from the control socket";
+    launchScrcpy(packageName, appName, trace, profileName);
+}
+
+void MainWindow::onControlShow()
+{
+    if (isMinimized()) {
+        showNormal();
+    } else {
+        show();
+    }
+    raise();
+    activateWindow();
+}
+
+void MainWindow::onAppContextMenu(const QPoint &pos)
+{
+    QModelIndex index = ui->appListView->indexAt(pos);
+    if (!index.isValid()) {
+        return;
+    }
+    QString packageName = index.data(AppListModel::PackageNameRole).toString();
+
+    // Launch profile for this app
+    ProfileStore *store = ProfileStore::instance();
+    QString current = store->overrideFor(packageName);
+    QMenu menu(this);
+    QMenu *profileMenu = menu.addMenu("Launch Profile");
+    QActionGroup *group = new QActionGroup(profileMenu);
+    QStringList names = store->profileNames();
+    names.prepend(QString());
+    for (const QString &name : std::as_const(names)) {
+        QAction *action = profileMenu->addAction(name.isEmpty() ? QString("Default") : name);
+        action->setCheckable(true);
+        action->setChecked(name == current);
+        action->setData(name);
+        group->addAction(action);
+    }
+
+    QAction *chosen = menu.exec(ui->appListView->viewport()->mapToGlobal(pos));
+    if (chosen && chosen->actionGroup() == group && chosen->data().toString() != current) {
+        store->setOverride(packageName, chosen->data().toString());
+        appendLog(index.data(Qt::DisplayRole).toString() + " now launches with profile: " + chosen->text(),
+                  LogSeverity::Muted);
+    }
+}
+
+void MainWindow::onLaunchMetrics()
+{
+    LaunchMetricsDialog dialog(launchMetrics, this);
+    dialog.exec();
+}
+
 void MainWindow::onSettings()
 {
     SettingsDialog dialog(this);
-    dialog.exec();
+    if (dialog.exec() == QDialog::Accepted) {
+        QSettings settings("ScrcpyGUI", "Settings");
+        logModel->setLineCap(settings.value("log-line-cap", LogModel::DEFAULT_LINE_CAP).toInt());
+        sessionManager->setLogLineCap(logModel->lineCap());
+        replaceSessions = settings.value("replace-session", false).toBool();
+        metricsServer->loadSettings();
+        qualityController->loadSettings();
+    }
 }
 
 void MainWindow::onFilterChanged()
@@ -428,42 +799,67 @@ void MainWindow::onFilterChanged()
     }
 }
 
+void MainWindow::onSearchTextChanged(const QString &text)
+{
+    appProxy->setFilterText(text);
+    if (text.trimmed().isEmpty()) {
+        applyFilter();
+    } else {
+        ui->statusLabel->setText(QString("%1 matching apps").arg(appProxy->rowCount()));
+    }
+}
+
+void MainWindow::onSearchReturnPressed()
+{
+    // Launch the best match
+    QModelIndex top = appProxy->index(0, 0);
+    if (top.isValid()) {
+        ui->appListView->setCurrentIndex(top);
+        onAppSelected(top);
+    }
+}
+
 void MainWindow::onRunningAppsLoaded(const QSet<QString> &packages)
 {
-    runningPackages = packages;
-    qDebug() << "Running packages loaded:" << runningPackages.size();
+    appModel->setRunningPackages(packages);
+    qCDebug(lcApp) << "Running packages loaded:" << packages.size();
     
     if (showRunningOnly) {
         applyFilter();
         ui->statusLabel->setText(QString("Showing %1 running apps")
-                                .arg(ui->appListWidget->count()));
+                                .arg(appProxy->rowCount()));
+    }
+}
+
+void MainWindow::onRunningAppsAdded(const QSet<QString> &packages)
+{
+    appModel->addRunningPackages(packages);
+    if (showRunningOnly && ui->searchEdit->text().trimmed().isEmpty()) {
+        applyFilter();
+    }
+}
+
+void MainWindow::onRunningAppsRemoved(const QSet<QString> &packages)
+{
+    appModel->removeRunningPackages(packages);
+    if (showRunningOnly && ui->searchEdit->text().trimmed().isEmpty()) {
+        applyFilter();
     }
 }
 
 void MainWindow::applyFilter()
 {
-    ui->appListWidget->clear();
-    
+    TRACE_SPAN("MainWindow::applyFilter");
+    appProxy->setRunningOnly(showRunningOnly);
+
     if (showRunningOnly) {
-        // Show only running apps
-        int count = 0;
-        for (const AppInfo &app : allLoadedApps) {
-            if (runningPackages.contains(app.packageName)) {
-                addAppToList(app);
-                count++;
-            }
-        }
-        
+        int count = appProxy->rowCount();
         if (count == 0) {
             ui->statusLabel->setText("No running apps found");
         } else {
             ui->statusLabel->setText(QString("%1 running apps").arg(count));
         }
     } else {
-        // Show all apps
-        for (const AppInfo &app : allLoadedApps) {
-            addAppToList(app);
-        }
-        ui->statusLabel->setText(QString("Loaded %1 apps").arg(allLoadedApps.size()));
+        ui->statusLabel->setText(QString("Loaded %1 apps").arg(appModel->rowCount()));
     }
 }
@@ -2,13 +2,27 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QListWidget>
+#include <QModelIndex>
 #include <QProcess>
-#include <QTextEdit>
 #include <QPushButton>
 #include <QLabel>
 #include <QRadioButton>
+#include <QElapsedTimer>
 #include "appmanager.h"
+#include "devicemanager.h"
+#include "applistmodel.h"
+#include "appfilterproxymodel.h"
+#include "logmodel.h"
+#include "sessionmanager.h"
+#include "sessionlistmodel.h"
+#include "launchmetrics.h"
+#include "metricsserver.h"
+#include "qualitycontroller.h"
+#include "sessionsupervisor.h"
+#include "iconloader.h"
+#include "controlserver.h"
+
+class QTimer;
 
 namespace Ui {
 class MainWindow;
@@ -22,54 +36,108 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void changeEvent(QEvent *event) override;
+
 private slots:
-    void onAppSelected(QListWidgetItem *item);
+    void onAppSelected(const QModelIndex &index);
     void onRefreshClicked();
     void onManualAddClicked();
     void onMirrorDeviceClicked();
     void onAppsLoaded(const QList<AppInfo> &apps);
+    void onCachedAppsLoaded(const QList<AppInfo> &apps);
     void onLoadError(const QString &error);
     void onExit();
     void onAbout();
     void onSettings();
+    void onLaunchMetrics();
+    void onAppContextMenu(const QPoint &pos);
+    void onSessionRelaunched(ScrcpySession *previous, ScrcpySession *replacement, int level);
+    void onSessionRestarted(ScrcpySession *previous, ScrcpySession *replacement);
+    void onControlLaunch(const QString &packageName, const QString &profileName);
+    void onControlShow();
     
     // Scrcpy control slots
     void onStopScrcpyClicked();
+    void onStopAllClicked();
+    void onRemoveFinishedClicked();
     void onClearLogsClicked();
-    void onScrcpyStarted();
-    void onScrcpyFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onScrcpyError(QProcess::ProcessError error);
-    void onScrcpyReadyReadStandardOutput();
-    void onScrcpyReadyReadStandardError();
+    void onSessionSelected(const QModelIndex &current);
+    void onSessionChanged(ScrcpySession *session);
+    void onSessionRemoved(ScrcpySession *session);
+    void onSessionError(ScrcpySession *session, QProcess::ProcessError error);
+    void onLogLinesAppended();
+    void onLogScrolled(int value);
+    void requestVisibleIcons();
+    void copySelectedLogLines();
     
     // Filter slots
     void onFilterChanged();
+    void onSearchTextChanged(const QString &text);
+    void onSearchReturnPressed();
     void onRunningAppsLoaded(const QSet<QString> &packages);
+    void onRunningAppsAdded(const QSet<QString> &packages);
+    void onRunningAppsRemoved(const QSet<QString> &packages);
+
+    // Devices
+    void onDeviceSelected(int index);
+    void onDevicesChanged(const QList<DeviceInfo> &devices);
+    void onDeviceError(const QString &error);
+    void onDeviceAppsLoaded(const QString &serial, const QList<AppInfo> &apps);
+    void onDevicesRefreshed(int deviceCount, qint64 elapsedMs);
 
 private:
     void setupUI();
     void loadAppList();
-    void addAppToList(const AppInfo &appInfo);
-    void launchScrcpy(const QString &packageName, const QString &appName);
-    void stopScrcpy();
-    void appendLog(const QString &text, const QString &color = "#d4d4d4");
+    void setCurrentDevice(const QString &serial);
+    void reportFirstAppList(const char *source);
+    // An empty profile name uses the app's own profile
+    void launchScrcpy(const QString &packageName, const QString &appName,
+                      LaunchTrace trace = LaunchTrace(), const QString &profileName = QString());
+    // Window and launch-latency reporting, for first launches and replacements
+    void watchSession(ScrcpySession *session);
+    void showLog(ScrcpySession *session);
+    void selectSession(ScrcpySession *session);
+    ScrcpySession *selectedSession() const;
+    void appendLog(const QString &text, LogSeverity severity = LogSeverity::Normal);
     void applyFilter();
+    void updateScrcpyStatus();
 
     // UI from Qt Designer
     Ui::MainWindow *ui;
 
     // Business Logic
-    AppManager *appManager;
-    
-    // Scrcpy process management
-    QProcess *scrcpyProcess;
-    QString currentPackageName;
-    QString currentAppName;
+    DeviceManager *deviceManager;
+    AppManager *appManager;  // the selected device's
+    QString currentSerial;
+
+    // App list: full catalog plus the filtered view over it
+    AppListModel *appModel;
+    AppFilterProxyModel *appProxy;
+    IconLoader *iconLoader;
+    QTimer *iconTimer;
+
+    // Log pane: general messages, or the selected session's log
+    LogModel *logModel;
+    bool logFollowTail;
+
+    // Scrcpy sessions
+    SessionManager *sessionManager;
+    SessionListModel *sessionModel;
+    ScrcpySession *shownSession;
+    LaunchMetrics *launchMetrics;
+    MetricsServer *metricsServer;
+    QualityController *qualityController;
+    SessionSupervisor *sessionSupervisor;
+    ControlServer *controlServer;
+    bool replaceSessions;
     
     // Filter state
     bool showRunningOnly;
-    QList<AppInfo> allLoadedApps;
-    QSet<QString> runningPackages;
+
+    // Startup-to-first-usable-list measurement
+    QElapsedTimer startupTimer;
+    bool firstAppListShown;
 };
 
 #endif // MAINWINDOW_H
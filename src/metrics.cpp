@@ -0,0 +1,194 @@
+#include "metrics.h"
+
+namespace {
+
+const qint64 bucketBoundsMs[AtomicHistogram::BUCKET_COUNT] = {
+    1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000
+};
+
+const char *const adbQueryNames[Metrics::AdbQueryCount] = {
+    "packages", "running", "request"
+};
+
+const char *const logSourceNames[Metrics::LogSourceCount] = {
+    "ui", "file"
+};
+
+const char *const exitReasonNames[Metrics::SessionExitReasonCount] = {
+    "user_closed", "device_gone", "crashed"
+};
+
+QByteArray seconds(double ms)
+{
+    return QByteArray::number(ms / 1000.0, 'g', 10);
+}
+
+void writeHeader(QByteArray &out, const char *name, const char *type, const char *help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void writeValue(QByteArray &out, const char *name, const QByteArray &labels, quint64 value)
+{
+    out += name;
+    if (!labels.isEmpty()) {
+        out += '{' + labels + '}';
+    }
+    out += ' ' + QByteArray::number(value) + '\n';
+}
+
+} // namespace
+
+void AtomicHistogram::observe(qint64 ms)
+{
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT && ms > bucketBoundsMs[bucket])
+        ++bucket;
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumMs.fetch_add(quint64(qMax<qint64>(0, ms)), std::memory_order_relaxed);
+}
+
+void AtomicHistogram::write(QByteArray &out, const QByteArray &name, const QByteArray &labels) const
+{
+    QByteArray prefix = labels.isEmpty() ? QByteArray() : labels + ',';
+    quint64 cumulative = 0;
+    for (int bucket = 0; bucket <= BUCKET_COUNT; ++bucket) {
+        cumulative += buckets[bucket].load(std::memory_order_relaxed);
+        QByteArray le = bucket < BUCKET_COUNT ? seconds(double(bucketBoundsMs[bucket])) : QByteArray("+Inf");
+        out += name + "_bucket{" + prefix + "le=\"" + le + "\"} " + QByteArray::number(cumulative) + '\n';
+    }
+    QByteArray suffix = labels.isEmpty() ? QByteArray() : '{' + labels + '}';
+    out += name + "_sum" + suffix + ' ' + seconds(double(sumMs.load(std::memory_order_relaxed))) + '\n';
+    out += name + "_count" + suffix + ' ' + QByteArray::number(cumulative) + '\n';
+}
+
+Metrics *Metrics::instance()
+{
+    static Metrics metrics;
+    return &metrics;
+}
+
+void Metrics::observeAdbQuery(AdbQuery query, qint64 ms, bool failed)
+{
+    adbLatency[query].observe(ms);
+    if (failed) {
+        adbFailures[query].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::sessionStarted(bool restart)
+{
+    sessionsStarted.fetch_add(1, std::memory_order_relaxed);
+    sessionsActive.fetch_add(1, std::memory_order_relaxed);
+    if (restart) {
+        sessionRestarts.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::sessionExited(int exitCode, bool failed, bool crashed)
+{
+    sessionsActive.fetch_sub(1, std::memory_order_relaxed);
+    if (failed || crashed) {
+        sessionsFailed.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (crashed) {
+        sessionsCrashed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    int slot = (exitCode >= 0 && exitCode < EXIT_CODE_SLOTS - 1) ? exitCode : EXIT_CODE_SLOTS - 1;
+    exitCodes[slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::countLogLines(LogSource source, int lines)
+{
+    logLines[source].fetch_add(quint64(lines), std::memory_order_relaxed);
+}
+
+void Metrics::supervisedExit(SessionExitReason reason)
+{
+    supervisedExits[reason].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::supervisorRestarted()
+{
+    supervisorRestarts.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::sessionRecovered(qint64 recoveryMs)
+{
+    recoveryTime.observe(recoveryMs);
+}
+
+void Metrics::observeEventLoopLag(qint64 ms)
+{
+    eventLoopLag.observe(ms);
+    qint64 previous = eventLoopLagMaxMs.load(std::memory_order_relaxed);
+    while (ms > previous && !eventLoopLagMaxMs.compare_exchange_weak(previous, ms, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::write(QByteArray &out) const
+{
+    writeHeader(out, "scrcpygui_adb_query_duration_seconds", "histogram", "Latency of adb queries.");
+    for (int query = 0; query < AdbQueryCount; ++query) {
+        adbLatency[query].write(out, "scrcpygui_adb_query_duration_seconds",
+                                QByteArray("query=\"") + adbQueryNames[query] + '"');
+    }
+    writeHeader(out, "scrcpygui_adb_query_failures_total", "counter", "Failed adb queries.");
+    for (int query = 0; query < AdbQueryCount; ++query) {
+        writeValue(out, "scrcpygui_adb_query_failures_total",
+                   QByteArray("query=\"") + adbQueryNames[query] + '"',
+                   adbFailures[query].load(std::memory_order_relaxed));
+    }
+
+    writeHeader(out, "scrcpygui_sessions_started_total", "counter", "Scrcpy sessions started.");
+    writeValue(out, "scrcpygui_sessions_started_total", QByteArray(), sessionsStarted.load(std::memory_order_relaxed));
+    writeHeader(out, "scrcpygui_session_restarts_total", "counter", "Sessions started again for an app that had one before.");
+    writeValue(out, "scrcpygui_session_restarts_total", QByteArray(), sessionRestarts.load(std::memory_order_relaxed));
+    writeHeader(out, "scrcpygui_sessions_failed_total", "counter", "Sessions that failed to start, crashed or exited non-zero.");
+    writeValue(out, "scrcpygui_sessions_failed_total", QByteArray(), sessionsFailed.load(std::memory_order_relaxed));
+    writeHeader(out, "scrcpygui_sessions_crashed_total", "counter", "Sessions whose process crashed.");
+    writeValue(out, "scrcpygui_sessions_crashed_total", QByteArray(), sessionsCrashed.load(std::memory_order_relaxed));
+    writeHeader(out, "scrcpygui_sessions_active", "gauge", "Scrcpy processes currently running.");
+    writeValue(out, "scrcpygui_sessions_active", QByteArray(),
+               quint64(qMax<qint64>(0, sessionsActive.load(std::memory_order_relaxed))));
+
+    writeHeader(out, "scrcpygui_session_exits_total", "counter", "Session exits by exit code (255 includes out-of-range codes).");
+    for (int code = 0; code < EXIT_CODE_SLOTS; ++code) {
+        quint64 count = exitCodes[code].load(std::memory_order_relaxed);
+        if (count > 0) {
+            writeValue(out, "scrcpygui_session_exits_total", "code=\"" + QByteArray::number(code) + '"', count);
+        }
+    }
+
+    writeHeader(out, "scrcpygui_supervised_exits_total", "counter", "Exits of auto-restarted sessions by cause.");
+    for (int reason = 0; reason < SessionExitReasonCount; ++reason) {
+        writeValue(out, "scrcpygui_supervised_exits_total",
+                   QByteArray("reason=\"") + exitReasonNames[reason] + '"',
+                   supervisedExits[reason].load(std::memory_order_relaxed));
+    }
+    writeHeader(out, "scrcpygui_supervisor_restarts_total", "counter", "Relaunches by the session supervisor.");
+    writeValue(out, "scrcpygui_supervisor_restarts_total", QByteArray(), supervisorRestarts.load(std::memory_order_relaxed));
+    writeHeader(out, "scrcpygui_supervisor_recovery_seconds", "histogram", "Time from a supervised exit to the replacement's window.");
+    recoveryTime.write(out, "scrcpygui_supervisor_recovery_seconds", QByteArray());
+
+    writeHeader(out, "scrcpygui_log_lines_total", "counter", "Log lines produced.");
+    for (int source = 0; source < LogSourceCount; ++source) {
+        writeValue(out, "scrcpygui_log_lines_total",
+                   QByteArray("source=\"") + logSourceNames[source] + '"',
+                   logLines[source].load(std::memory_order_relaxed));
+    }
+
+    writeHeader(out, "scrcpygui_event_loop_lag_seconds", "histogram", "How late the UI event loop served a periodic timer.");
+    eventLoopLag.write(out, "scrcpygui_event_loop_lag_seconds", QByteArray());
+    writeHeader(out, "scrcpygui_event_loop_lag_max_seconds", "gauge", "Largest event loop lag seen.");
+    out += "scrcpygui_event_loop_lag_max_seconds " + seconds(double(eventLoopLagMaxMs.load(std::memory_order_relaxed))) + '\n';
+}
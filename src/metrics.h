@@ -0,0 +1,95 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <atomic>
+
+// Cumulative millisecond histogram with fixed Prometheus-style buckets.
+// observe() is a couple of relaxed atomic adds and safe from any thread.
+class AtomicHistogram
+{
+public:
+    static constexpr int BUCKET_COUNT = 12;
+
+    void observe(qint64 ms);
+    // Appends <name>_bucket/_sum/_count lines, in seconds
+    void write(QByteArray &out, const QByteArray &name, const QByteArray &labels) const;
+
+private:
+    std::atomic<quint64> buckets[BUCKET_COUNT + 1] = {};  // last one is +Inf
+    std::atomic<quint64> sumMs { 0 };
+};
+
+// Process-wide health counters, exported by MetricsServer.
+//
+// Everything here is updated where it happens (adb replies, session exits,
+// log appends) and only read on scrape, so an idle scraper costs nothing
+// and a busy one never walks application state.
+class Metrics
+{
+public:
+    enum AdbQuery {
+        PackageList,    // AppManager's pm list packages
+        RunningApps,    // RunningAppsMonitor's ps poll
+        AdbRequest,     // Any one-shot AdbReply
+        AdbQueryCount
+    };
+
+    enum LogSource {
+        UiLog,          // Lines appended to a LogModel
+        FileLog,        // Messages handed to the Logger
+        LogSourceCount
+    };
+
+    // How SessionSupervisor classified a supervised session's exit
+    enum SessionExitReason {
+        UserClosed,
+        DeviceGone,
+        Crashed,
+        SessionExitReasonCount
+    };
+
+    static constexpr int EXIT_CODE_SLOTS = 256;
+
+    static Metrics *instance();
+
+    void observeAdbQuery(AdbQuery query, qint64 ms, bool failed);
+    void sessionStarted(bool restart);
+    // exitCode is ignored when crashed; a crash counts as a failure
+    void sessionExited(int exitCode, bool failed, bool crashed);
+    void countLogLines(LogSource source, int lines = 1);
+    void supervisedExit(SessionExitReason reason);
+    void supervisorRestarted();
+    // From the exit to the replacement's window
+    void sessionRecovered(qint64 recoveryMs);
+    void observeEventLoopLag(qint64 ms);
+
+    // Prometheus text exposition of all counters above
+    void write(QByteArray &out) const;
+
+private:
+    Metrics() = default;
+
+    AtomicHistogram adbLatency[AdbQueryCount];
+    std::atomic<quint64> adbFailures[AdbQueryCount] = {};
+
+    std::atomic<quint64> sessionsStarted { 0 };
+    std::atomic<quint64> sessionRestarts { 0 };
+    std::atomic<quint64> sessionsFailed { 0 };
+    std::atomic<quint64> sessionsCrashed { 0 };
+    std::atomic<qint64> sessionsActive { 0 };
+    // Index EXIT_CODE_SLOTS - 1 also holds codes outside 0..254
+    std::atomic<quint64> exitCodes[EXIT_CODE_SLOTS] = {};
+
+    std::atomic<quint64> logLines[LogSourceCount] = {};
+
+    std::atomic<quint64> supervisedExits[SessionExitReasonCount] = {};
+    std::atomic<quint64> supervisorRestarts { 0 };
+    AtomicHistogram recoveryTime;
+
+    AtomicHistogram eventLoopLag;
+    std::atomic<qint64> eventLoopLagMaxMs { 0 };
+};
+
+#endif // METRICS_H
@@ -0,0 +1,159 @@
+#include "metricsserver.h"
+#include "metrics.h"
+#include "sessionmanager.h"
+#include "logger.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QSettings>
+
+namespace {
+
+// Label values may not contain raw quotes, backslashes or newlines
+QByteArray escapeLabel(const QString &value)
+{
+    QByteArray escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(SessionManager *sessions, QObject *parent)
+    : QObject(parent)
+    , sessions(sessions)
+    , server(new QTcpServer(this))
+    , lagTimer(new QTimer(this))
+{
+    lagTimer->setTimerType(Qt::PreciseTimer);
+    lagTimer->setInterval(LAG_SAMPLE_MS);
+    connect(lagTimer, &QTimer::timeout, this, &MetricsServer::onLagTick);
+    connect(server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+void MetricsServer::loadSettings()
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    bool enabled = settings.value("metrics-enabled", false).toBool();
+    quint16 wantedPort = quint16(settings.value("metrics-port", DEFAULT_PORT).toUInt());
+
+    if (!enabled) {
+        close();
+    } else if (!isListening() || port() != wantedPort) {
+        close();
+        listen(wantedPort);
+    }
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    // Loopback only; kiosks are scraped by a local agent
+    if (!server->listen(QHostAddress::LocalHost, port)) {
+        qCWarning(lcApp) << "Metrics endpoint could not listen on port" << port << ":" << server->errorString();
+        return false;
+    }
+    qCInfo(lcApp) << "Serving metrics on http://127.0.0.1:" << server->serverPort() << "/metrics";
+    lagClock.start();
+    lagTimer->start();
+    return true;
+}
+
+void MetricsServer::close()
+{
+    if (server->isListening()) {
+        server->close();
+        qCDebug(lcApp) << "Metrics endpoint closed";
+    }
+    lagTimer->stop();
+}
+
+bool MetricsServer::isListening() const
+{
+    return server->isListening();
+}
+
+quint16 MetricsServer::port() const
+{
+    return server->serverPort();
+}
+
+void MetricsServer::onLagTick()
+{
+    // Anything past the interval is time the event loop spent elsewhere
+    qint64 elapsed = lagClock.restart();
+    Metrics::instance()->observeEventLoopLag(qMax<qint64>(0, elapsed - LAG_SAMPLE_MS));
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            pendingRequests.remove(socket);
+            socket->deleteLater();
+        });
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            QByteArray &request = pendingRequests[socket];
+            request += socket->readAll();
+            if (request.contains("\r\n\r\n")) {
+                QByteArray complete = request;
+                pendingRequests.remove(socket);
+                handleRequest(socket, complete);
+            } else if (request.size() > MAX_REQUEST_BYTES) {
+                pendingRequests.remove(socket);
+                reply(socket, "431 Request Header Fields Too Large", "text/plain", "Request too large\n");
+            }
+        });
+    }
+}
+
+void MetricsServer::handleRequest(QTcpSocket *socket, const QByteArray &request)
+{
+    QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    if (requestLine.size() < 2 || (requestLine.at(0) != "GET" && requestLine.at(0) != "HEAD")) {
+        reply(socket, "405 Method Not Allowed", "text/plain", "Only GET and HEAD are supported\n");
+        return;
+    }
+
+    bool head = requestLine.at(0) == "HEAD";
+    QByteArray path = requestLine.at(1);
+    if (path == "/metrics" || path.startsWith("/metrics?")) {
+        reply(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8", render(), head);
+    } else {
+        reply(socket, "404 Not Found", "text/plain", "Try /metrics\n", head);
+    }
+}
+
+void MetricsServer::reply(QTcpSocket *socket, const QByteArray &status, const QByteArray &contentType,
+                          const QByteArray &body, bool headOnly)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                          "Content-Type: " + contentType + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    if (!headOnly) {
+        response += body;
+    }
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray MetricsServer::render() const
+{
+    QByteArray out;
+    out.reserve(8192);
+    Metrics::instance()->write(out);
+
+    // Read straight from the sessions; scrcpy's FPS line already updated them
+    out += "# HELP scrcpygui_session_fps Frames per second last reported by scrcpy (--print-fps).\n"
+           "# TYPE scrcpygui_session_fps gauge\n";
+    for (const ScrcpySession *session : sessions->sessions()) {
+        if (session->state() != ScrcpySession::Running) {
+            continue;
+        }
+        out += "scrcpygui_session_fps{session=\"" + QByteArray::number(session->id())
+             + "\",serial=\"" + escapeLabel(session->serial())
+             + "\",package=\"" + escapeLabel(session->packageName())
+             + "\"} " + QByteArray::number(session->fps()) + '\n';
+    }
+    return out;
+}
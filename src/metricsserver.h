@@ -0,0 +1,56 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class SessionManager;
+
+// Optional loopback HTTP listener serving GET and HEAD /metrics in the
+// Prometheus text format: the Metrics counters plus one FPS gauge per
+// running session.
+//
+// While listening it also samples UI event-loop lag with a periodic timer.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint16 DEFAULT_PORT = 9464;
+    static constexpr int LAG_SAMPLE_MS = 250;
+    static constexpr int MAX_REQUEST_BYTES = 8192;
+
+    explicit MetricsServer(SessionManager *sessions, QObject *parent = nullptr);
+
+    // Applies "metrics-enabled" and "metrics-port"
+    void loadSettings();
+    bool listen(quint16 port);
+    void close();
+    bool isListening() const;
+    quint16 port() const;
+
+    QByteArray render() const;
+
+private slots:
+    void onNewConnection();
+    void onLagTick();
+
+private:
+    void handleRequest(QTcpSocket *socket, const QByteArray &request);
+    // headOnly sends the headers for body, Content-Length included, without it
+    void reply(QTcpSocket *socket, const QByteArray &status, const QByteArray &contentType,
+               const QByteArray &body, bool headOnly = false);
+
+    SessionManager *sessions;
+    QTcpServer *server;
+    QTimer *lagTimer;
+    QElapsedTimer lagClock;
+    QHash<QTcpSocket *, QByteArray> pendingRequests;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,172 @@
+#include "packagecatalog.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QSettings>
+#include "logger.h"
+
+namespace {
+const quint32 CATALOG_MAGIC = 0x53475043; // "SGPC"
+const quint16 CATALOG_VERSION = 2;
+}
+
+PackageCatalog::PackageCatalog(const QString &serial)
+    : deviceSerial(serial)
+{
+}
+
+bool PackageCatalog::load()
+{
+    if (deviceSerial.isEmpty()) {
+        return false;
+    }
+
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic;
+    quint16 version;
+    in >> magic >> version;
+    if (magic != CATALOG_MAGIC || version != CATALOG_VERSION) {
+        qCDebug(lcApp) << "Ignoring package catalog with unknown format:" << file.fileName();
+        return false;
+    }
+
+    QString storedSerial;
+    qint64 updatedMs;
+    quint32 count;
+    in >> storedSerial >> buildFingerprint >> updatedMs >> count;
+    if (storedSerial != deviceSerial) {
+        return false;
+    }
+
+    packageNames.clear();
+    packageNames.reserve(qMin<quint32>(count, 100000));
+    packageVersions.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QByteArray name;
+        qint64 versionCode;
+        in >> name >> versionCode;
+        packageNames.append(QString::fromUtf8(name));
+        if (versionCode > 0) {
+            packageVersions.insert(packageNames.last(), versionCode);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qCDebug(lcApp) << "Truncated package catalog:" << file.fileName();
+        packageNames.clear();
+        packageVersions.clear();
+        return false;
+    }
+
+    updated = QDateTime::fromMSecsSinceEpoch(updatedMs);
+    return true;
+}
+
+bool PackageCatalog::save() const
+{
+    if (deviceSerial.isEmpty()) {
+        return false;
+    }
+
+    QString path = filePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(lcApp) << "Failed to save package catalog:" << path;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << CATALOG_MAGIC << CATALOG_VERSION
+        << deviceSerial << buildFingerprint
+        << QDateTime::currentMSecsSinceEpoch()
+        << quint32(packageNames.size());
+    for (const QString &name : packageNames) {
+        out << name.toUtf8() << packageVersions.value(name);
+    }
+
+    return file.commit();
+}
+
+QString PackageCatalog::serial() const
+{
+    return deviceSerial;
+}
+
+QString PackageCatalog::fingerprint() const
+{
+    return buildFingerprint;
+}
+
+QStringList PackageCatalog::packages() const
+{
+    return packageNames;
+}
+
+QHash<QString, qint64> PackageCatalog::versionCodes() const
+{
+    return packageVersions;
+}
+
+QDateTime PackageCatalog::updatedAt() const
+{
+    return updated;
+}
+
+bool PackageCatalog::isEmpty() const
+{
+    return packageNames.isEmpty();
+}
+
+void PackageCatalog::setFingerprint(const QString &fingerprint)
+{
+    buildFingerprint = fingerprint;
+}
+
+void PackageCatalog::setPackages(const QStringList &packages)
+{
+    packageNames = packages;
+}
+
+void PackageCatalog::setVersionCodes(const QHash<QString, qint64> &versionCodes)
+{
+    packageVersions = versionCodes;
+}
+
+QString PackageCatalog::lastSerial()
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    return settings.value("catalog/last-serial").toString();
+}
+
+void PackageCatalog::setLastSerial(const QString &serial)
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    settings.setValue("catalog/last-serial", serial);
+}
+
+QString PackageCatalog::filePath() const
+{
+    // Wireless serials look like "192.168.1.20:5555"
+    QString safeSerial = deviceSerial;
+    for (QChar &c : safeSerial) {
+        if (!c.isLetterOrNumber() && c != '-' && c != '_' && c != '.') {
+            c = '_';
+        }
+    }
+
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return cacheDir + "/catalog/" + safeSerial + ".bin";
+}
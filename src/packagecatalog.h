@@ -0,0 +1,46 @@
+#ifndef PACKAGECATALOG_H
+#define PACKAGECATALOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QDateTime>
+
+// Last known third-party packages of one device, kept on disk so the app
+// list can be painted before adb answers.
+//
+// Catalogs are keyed by device serial and remember the build fingerprint
+// they were taken on. The file is a small versioned QDataStream blob.
+class PackageCatalog
+{
+public:
+    explicit PackageCatalog(const QString &serial);
+
+    bool load();
+    bool save() const;
+
+    QString serial() const;
+    QString fingerprint() const;
+    QStringList packages() const;
+    QHash<QString, qint64> versionCodes() const;
+    QDateTime updatedAt() const;
+    bool isEmpty() const;
+
+    void setFingerprint(const QString &fingerprint);
+    void setPackages(const QStringList &packages);
+    void setVersionCodes(const QHash<QString, qint64> &versionCodes);
+
+    static QString lastSerial();
+    static void setLastSerial(const QString &serial);
+
+private:
+    QString filePath() const;
+
+    QString deviceSerial;
+    QString buildFingerprint;
+    QStringList packageNames;
+    QHash<QString, qint64> packageVersions;
+    QDateTime updated;
+};
+
+#endif // PACKAGECATALOG_H
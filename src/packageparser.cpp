@@ -0,0 +1,169 @@
+#include "packageparser.h"
+#include "tracer.h"
+#include <QCollator>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Calls fn for each non-empty, whitespace-trimmed line
+template <typename Fn>
+void forEachLine(QByteArrayView data, Fn fn)
+{
+    const char *p = data.data();
+    const char *end = p + data.size();
+    while (p < end) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *lineEnd = newline ? newline : end;
+        QByteArrayView line = QByteArrayView(p, lineEnd - p).trimmed();
+        if (!line.isEmpty()) {
+            fn(line);
+        }
+        p = lineEnd + 1;
+    }
+}
+}
+
+PackageListing PackageParser::parsePackageList(QByteArrayView output)
+{
+    TRACE_SPAN("PackageParser::parsePackageList");
+    PackageListing listing;
+    QSet<QByteArrayView> seen;
+
+    forEachLine(output, [&](QByteArrayView line) {
+        if (line.startsWith("package:")) {
+            QByteArrayView name = line.sliced(8).trimmed();
+            qint64 versionCode = 0;
+            qsizetype space = name.indexOf(' ');
+            if (space >= 0) {
+                QByteArrayView rest = name.sliced(space + 1).trimmed();
+                if (rest.startsWith("versionCode:")) {
+                    versionCode = rest.sliced(12).toLongLong();
+                }
+                name = name.first(space);
+            }
+            if (!name.isEmpty() && !seen.contains(name)) {
+                seen.insert(name);
+                QString packageName = QString::fromUtf8(name);
+                if (versionCode > 0) {
+                    listing.versionCodes.insert(packageName, versionCode);
+                }
+                listing.packages.append(packageName);
+            }
+        } else if (line.startsWith("serial:")) {
+            listing.serial = QString::fromUtf8(line.sliced(7).trimmed());
+        } else if (line.startsWith("fingerprint:")) {
+            listing.fingerprint = QString::fromUtf8(line.sliced(12).trimmed());
+        }
+    });
+
+    return listing;
+}
+
+QSet<QString> PackageParser::parseRunningPackages(QByteArrayView output)
+{
+    QSet<QString> packages;
+    QSet<QByteArrayView> seen;
+
+    forEachLine(output, [&](QByteArrayView line) {
+        qsizetype start = line.size();
+        while (start > 0 && !isSpace(line.at(start - 1))) {
+            --start;
+        }
+        QByteArrayView name = line.sliced(start);
+
+        qsizetype colon = name.indexOf(':');
+        if (colon >= 0) {
+            name = name.first(colon);
+        }
+
+        // Kernel threads look like "[kworker/0:1]"
+        if (name.startsWith('[') || !name.contains('.') || seen.contains(name)) {
+            return;
+        }
+        seen.insert(name);
+        packages.insert(QString::fromUtf8(name));
+    });
+
+    return packages;
+}
+
+QList<AppInfo> PackageParser::buildAppList(const QStringList &packages, const QList<AppInfo> &customApps,
+                                           const QHash<QString, qint64> &versionCodes)
+{
+    TRACE_SPAN("PackageParser::buildAppList");
+    QSet<QString> customPackages;
+    customPackages.reserve(customApps.size());
+    for (const AppInfo &app : customApps) {
+        customPackages.insert(app.packageName);
+    }
+
+    QList<AppInfo> apps;
+    apps.reserve(customApps.size() + packages.size());
+    apps.append(customApps);
+    for (AppInfo &app : apps) {
+        app.versionCode = versionCodes.value(app.packageName);
+    }
+    for (const QString &packageName : packages) {
+        if (customPackages.contains(packageName)) {
+            continue;
+        }
+        AppInfo app;
+        app.packageName = packageName;
+        app.name = packageToName(packageName);
+        app.versionCode = versionCodes.value(packageName);
+        apps.append(app);
+    }
+
+    // One sort key per app instead of two case conversions per comparison
+    QCollator collator;
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    collator.setNumericMode(true);
+
+    QList<QCollatorSortKey> keys;
+    keys.reserve(apps.size());
+    for (const AppInfo &app : std::as_const(apps)) {
+        keys.append(collator.sortKey(app.name));
+    }
+
+    QList<int> order(apps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+        return keys.at(a).compare(keys.at(b)) < 0;
+    });
+
+    QList<AppInfo> sorted;
+    sorted.reserve(apps.size());
+    for (int i : std::as_const(order)) {
+        sorted.append(std::move(apps[i]));
+    }
+    return sorted;
+}
+
+QString PackageParser::packageToName(const QString &packageName)
+{
+    // Simple conversion: com.example.myApp -> My App
+    QStringView appName = QStringView(packageName).sliced(packageName.lastIndexOf('.') + 1);
+
+    // Capitalize first letter and add spaces before capitals
+    QString result;
+    result.reserve(appName.size() + 4);
+    for (qsizetype i = 0; i < appName.size(); ++i) {
+        QChar c = appName.at(i);
+        if (i == 0) {
+            result += c.toUpper();
+        } else if (c.isUpper()) {
+            result += ' ';
+            result += c;
+        } else {
+            result += c;
+        }
+    }
+
+    return result;
+}
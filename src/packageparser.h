@@ -0,0 +1,41 @@
+#ifndef PACKAGEPARSER_H
+#define PACKAGEPARSER_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include "appmanager.h"
+
+struct PackageListing {
+    QString serial;
+    QString fingerprint;
+    QStringList packages;
+    QHash<QString, qint64> versionCodes;
+};
+
+// Parsers for `pm list packages` and `ps` output. They walk the raw bytes in
+// place and only allocate for the values they keep, so cost stays linear in
+// the output size.
+class PackageParser
+{
+public:
+    // "package:<name> [versionCode:<n>]" lines plus the "serial:"/"fingerprint:"
+    // lines that AppManager prepends; duplicates are dropped, order is kept
+    static PackageListing parsePackageList(QByteArrayView output);
+
+    // Last column of each ps line that looks like a package name. Secondary
+    // processes ("com.example.app:remote") count for their package.
+    static QSet<QString> parseRunningPackages(QByteArrayView output);
+
+    // Custom apps first (they win over device entries with the same package),
+    // then the rest, sorted by display name with a locale-aware collator
+    static QList<AppInfo> buildAppList(const QStringList &packages, const QList<AppInfo> &customApps,
+                                       const QHash<QString, qint64> &versionCodes = QHash<QString, qint64>());
+
+    static QString packageToName(const QString &packageName);
+};
+
+#endif // PACKAGEPARSER_H
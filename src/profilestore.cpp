@@ -0,0 +1,123 @@
+#include "profilestore.h"
+#include "logger.h"
+#include <QSettings>
+#include <algorithm>
+
+ProfileStore *ProfileStore::instance()
+{
+    static ProfileStore store;
+    return &store;
+}
+
+void ProfileStore::ensureLoaded()
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    QSettings settings("ScrcpyGUI", "Settings");
+    defaultProfile = ScrcpyProfile::load(settings);
+
+    namedProfiles.clear();
+    settings.beginGroup("profiles");
+    const QStringList names = settings.childGroups();
+    for (const QString &name : names) {
+        settings.beginGroup(name);
+        ScrcpyProfile profile = ScrcpyProfile::load(settings);
+        profile.name = name;
+        namedProfiles.insert(name, profile);
+        settings.endGroup();
+    }
+    settings.endGroup();
+
+    overrides.clear();
+    settings.beginGroup("profile-overrides");
+    const QStringList packages = settings.childKeys();
+    for (const QString &packageName : packages) {
+        overrides.insert(packageName, settings.value(packageName).toString());
+    }
+    settings.endGroup();
+
+    qCDebug(lcApp) << "Loaded" << namedProfiles.size() + 1 << "launch profiles and"
+                   << overrides.size() << "per-app overrides";
+}
+
+const ScrcpyProfile &ProfileStore::profile(const QString &name)
+{
+    ensureLoaded();
+    auto it = namedProfiles.constFind(name);
+    return it != namedProfiles.constEnd() ? it.value() : defaultProfile;
+}
+
+const ScrcpyProfile &ProfileStore::profileFor(const QString &packageName)
+{
+    ensureLoaded();
+    return profile(overrides.value(packageName));
+}
+
+QStringList ProfileStore::profileNames()
+{
+    ensureLoaded();
+    QStringList names = namedProfiles.keys();
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+QString ProfileStore::overrideFor(const QString &packageName)
+{
+    ensureLoaded();
+    return overrides.value(packageName);
+}
+
+void ProfileStore::setOverride(const QString &packageName, const QString &profileName)
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    settings.beginGroup("profile-overrides");
+    if (profileName.isEmpty()) {
+        settings.remove(packageName);
+    } else {
+        settings.setValue(packageName, profileName);
+    }
+    settings.endGroup();
+    invalidate();
+}
+
+void ProfileStore::saveProfile(const ScrcpyProfile &profile)
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    if (!profile.name.isEmpty()) {
+        settings.beginGroup("profiles/" + profile.name);
+    }
+    profile.save(settings);
+    if (!profile.name.isEmpty()) {
+        settings.endGroup();
+    }
+    invalidate();
+}
+
+void ProfileStore::removeProfile(const QString &name)
+{
+    if (name.isEmpty()) {
+        return;
+    }
+
+    QSettings settings("ScrcpyGUI", "Settings");
+    settings.remove("profiles/" + name);
+
+    // Apps that used it fall back to the default
+    settings.beginGroup("profile-overrides");
+    const QStringList packages = settings.childKeys();
+    for (const QString &packageName : packages) {
+        if (settings.value(packageName).toString() == name) {
+            settings.remove(packageName);
+        }
+    }
+    settings.endGroup();
+    invalidate();
+}
+
+void ProfileStore::invalidate()
+{
+    loaded = false;
+}
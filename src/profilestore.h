@@ -0,0 +1,46 @@
+#ifndef PROFILESTORE_H
+#define PROFILESTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include "scrcpyprofile.h"
+
+// Cache of the compiled launch profiles.
+//
+// The default profile lives in the top-level settings keys, named profiles
+// under "profiles/<name>" and per-package choices under
+// "profile-overrides/<package>". Everything is read on first use and kept
+// until invalidate(), which SettingsDialog calls after saving. GUI thread only.
+class ProfileStore
+{
+public:
+    static ProfileStore *instance();
+
+    // Default profile for an empty or unknown name. References stay valid
+    // until the next invalidate().
+    const ScrcpyProfile &profile(const QString &name);
+    const ScrcpyProfile &profileFor(const QString &packageName);
+    QStringList profileNames();
+
+    QString overrideFor(const QString &packageName);
+    // An empty profile name removes the override
+    void setOverride(const QString &packageName, const QString &profileName);
+
+    void saveProfile(const ScrcpyProfile &profile);
+    void removeProfile(const QString &name);
+
+    void invalidate();
+
+private:
+    ProfileStore() = default;
+
+    void ensureLoaded();
+
+    bool loaded = false;
+    ScrcpyProfile defaultProfile;
+    QHash<QString, ScrcpyProfile> namedProfiles;
+    QHash<QString, QString> overrides;
+};
+
+#endif // PROFILESTORE_H
@@ -0,0 +1,272 @@
+#include "qualitycontroller.h"
+#include "scrcpysession.h"
+#include "sessionmanager.h"
+#include "logger.h"
+#include <QSettings>
+#include <iterator>
+#include <memory>
+
+namespace {
+
+// Rung 0 keeps whatever the settings say
+const QualityLevel ladder[] = {
+    { QString(), 0, 0 },
+    { "8M", 60, 1920 },
+    { "6M", 60, 1600 },
+    { "4M", 45, 1280 },
+    { "2M", 30, 1024 },
+    { "1M", 24, 800 }
+};
+
+const char *const adjustedOptions[] = {
+    "--bit-rate", "--video-bit-rate", "-b", "--max-fps", "--max-size", "-m"
+};
+
+bool isAdjustedOption(const QString &argument, bool *takesValue)
+{
+    for (const char *option : adjustedOptions) {
+        QLatin1String name(option);
+        if (argument == name) {
+            *takesValue = true;
+            return true;
+        }
+        if (argument.startsWith(name + '=')) {
+            *takesValue = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+QString profileKey(const QString &serial, const QString &packageName)
+{
+    return "quality-profiles/" + (serial.isEmpty() ? QString("default") : serial)
+         + "/" + (packageName.isEmpty() ? QString("mirror") : packageName);
+}
+
+} // namespace
+
+QualityController::QualityController(SessionManager *sessions, QObject *parent)
+    : QObject(parent)
+    , sessions(sessions)
+    , enabled(false)
+{
+}
+
+void QualityController::loadSettings()
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    enabled = settings.value("adaptive-quality", false).toBool();
+}
+
+bool QualityController::isEnabled() const
+{
+    return enabled;
+}
+
+int QualityController::levelCount()
+{
+    return int(std::size(ladder));
+}
+
+QualityLevel QualityController::level(int index)
+{
+    return ladder[qBound(0, index, levelCount() - 1)];
+}
+
+QStringList QualityController::applyLevel(const QStringList &arguments, int index)
+{
+    if (index <= 0) {
+        return arguments;
+    }
+
+    QStringList result;
+    for (int i = 0; i < arguments.size(); ++i) {
+        bool takesValue = false;
+        if (isAdjustedOption(arguments.at(i), &takesValue)) {
+            if (takesValue) {
+                ++i;
+            }
+            continue;
+        }
+        result << arguments.at(i);
+    }
+
+    QualityLevel rung = level(index);
+    result << "--bit-rate" << rung.bitRate
+           << "--max-fps" << QString::number(rung.maxFps)
+           << "--max-size" << QString::number(rung.maxSize);
+    return result;
+}
+
+int QualityController::targetFps(const QStringList &arguments)
+{
+    int fps = 0;
+    for (int i = 0; i < arguments.size(); ++i) {
+        const QString &argument = arguments.at(i);
+        if (argument == "--max-fps" && i + 1 < arguments.size()) {
+            fps = arguments.at(++i).toInt();
+        } else if (argument.startsWith("--max-fps=")) {
+            fps = argument.mid(10).toInt();
+        }
+    }
+    return fps > 0 ? fps : DEFAULT_FPS;
+}
+
+bool QualityController::isBadReport(const ScrcpyEvent &event, int targetFps)
+{
+    int frames = event.fps + event.skippedFrames;
+    if (frames > 0 && event.skippedFrames * 100 > frames * DROP_PERCENT) {
+        return true;
+    }
+    // A starved link skips nothing, it just delivers fewer frames
+    return event.fps * 100 < targetFps * LOW_FPS_PERCENT;
+}
+
+int QualityController::profileLevel(const QString &serial, const QString &packageName) const
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    return qBound(0, settings.value(profileKey(serial, packageName), 0).toInt(), levelCount() - 1);
+}
+
+void QualityController::saveProfile(const QString &serial, const QString &packageName, int level)
+{
+    QSettings settings("ScrcpyGUI", "Settings");
+    QString key = profileKey(serial, packageName);
+    if (settings.value(key, 0).toInt() == level) {
+        return;
+    }
+    if (level == 0) {
+        settings.remove(key);
+    } else {
+        settings.setValue(key, level);
+    }
+    qCDebug(lcScrcpy) << "Remembered quality level" << level << "for" << serial << packageName;
+}
+
+ScrcpySession *QualityController::launch(const QString &serial, const QString &packageName,
+                                         const QString &appName, const QStringList &arguments,
+                                         const LaunchTrace &trace)
+{
+    Tracked state;
+    state.level = profileLevel(serial, packageName);
+    state.baseArguments = arguments;
+    if (!state.baseArguments.contains("--print-fps")) {
+        state.baseArguments << "--print-fps";
+    }
+
+    ScrcpySession *session = sessions->startSession(serial, packageName, appName,
+                                                    applyLevel(state.baseArguments, state.level), trace);
+    startTracking(session, state);
+    return session;
+}
+
+void QualityController::startTracking(ScrcpySession *session, Tracked state)
+{
+    state.reports = 0;
+    state.history = 0;
+    state.goodStreak = 0;
+    state.remembered = false;
+    state.targetFps = targetFps(applyLevel(state.baseArguments, state.level));
+    state.sinceChange.start();
+    tracked.insert(session, state);
+
+    connect(session, &ScrcpySession::eventParsed, this, [this, session](const ScrcpyEvent &event) {
+        if (event.type == ScrcpyEvent::Fps) {
+            onFpsReport(session, event);
+        }
+    });
+    connect(session, &ScrcpySession::stateChanged, this, [this, session]() {
+        onSessionStateChanged(session);
+    });
+    connect(session, &QObject::destroyed, this, [this, session]() {
+        tracked.remove(session);
+    });
+}
+
+void QualityController::onFpsReport(ScrcpySession *session, const ScrcpyEvent &event)
+{
+    auto it = tracked.find(session);
+    if (it == tracked.end() || session->state() != ScrcpySession::Running) {
+        return;
+    }
+    Tracked &state = it.value();
+
+    // The first reports after a (re)launch cover connection setup
+    if (++state.reports <= SETTLE_REPORTS) {
+        return;
+    }
+
+    bool bad = isBadReport(event, state.targetFps);
+    state.history = ((state.history << 1) | (bad ? 1u : 0u)) & ((1u << DEGRADE_WINDOW) - 1);
+    state.goodStreak = bad ? 0 : state.goodStreak + 1;
+
+    if (!state.remembered && state.sinceChange.elapsed() >= STABLE_MS) {
+        rememberIfStable(session, state);
+        state.remembered = true;
+    }
+    if (state.sinceChange.elapsed() < MIN_DWELL_MS) {
+        return;
+    }
+
+    if (qPopulationCount(state.history) >= DEGRADE_BAD_REPORTS && state.level < levelCount() - 1) {
+        // A climb that didn't hold; wait longer before the next one
+        if (state.lastStepWasUp && state.sinceChange.elapsed() < STABLE_MS) {
+            state.upgradeReports = qMin(state.upgradeReports * 2, MAX_UPGRADE_REPORTS);
+        }
+        relaunch(session, state.level + 1);
+    } else if (state.goodStreak >= state.upgradeReports && state.level > 0) {
+        relaunch(session, state.level - 1);
+    }
+}
+
+void QualityController::onSessionStateChanged(ScrcpySession *session)
+{
+    auto it = tracked.find(session);
+    if (it == tracked.end() || session->isActive()) {
+        return;
+    }
+    rememberIfStable(session, it.value());
+    tracked.erase(it);
+}
+
+void QualityController::rememberIfStable(ScrcpySession *session, const Tracked &state)
+{
+    if (state.sinceChange.elapsed() >= STABLE_MS) {
+        saveProfile(session->serial(), session->packageName(), state.level);
+    }
+}
+
+void QualityController::relaunch(ScrcpySession *session, int newLevel)
+{
+    Tracked state = tracked.take(session);
+    state.lastStepWasUp = newLevel < state.level;
+    state.level = newLevel;
+
+    QString serial = session->serial();
+    QString packageName = session->packageName();
+    QString appName = session->appName();
+    QStringList arguments = applyLevel(state.baseArguments, newLevel);
+
+    qCInfo(lcScrcpy) << "Session" << session->id() << "moving to quality level" << newLevel
+                     << "(" << level(newLevel).bitRate << level(newLevel).maxFps << "fps"
+                     << level(newLevel).maxSize << "px )";
+    session->log()->append(QString("Adaptive quality: relaunching at level %1").arg(newLevel),
+                           LogSeverity::Notice);
+
+    // Same app on the same device: let the old one go first
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(session, &ScrcpySession::stateChanged, this,
+                          [this, session, connection, state, serial, packageName, appName, arguments]() {
+        if (session->isActive()) {
+            return;
+        }
+        disconnect(*connection);
+        ScrcpySession *replacement = sessions->startSession(serial, packageName, appName, arguments);
+        startTracking(replacement, state);
+        emit sessionRelaunched(session, replacement, state.level);
+        // Stepping every MIN_DWELL_MS would otherwise pile up stopped sessions and their logs
+        sessions->removeSession(session->id());
+    });
+    session->stop();
+}
@@ -0,0 +1,101 @@
+#ifndef QUALITYCONTROLLER_H
+#define QUALITYCONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QElapsedTimer>
+#include "scrcpyoutputparser.h"
+#include "launchmetrics.h"
+
+class ScrcpySession;
+class SessionManager;
+
+// One rung of the quality ladder; rung 0 means "as configured"
+struct QualityLevel {
+    QString bitRate;
+    int maxFps = 0;
+    int maxSize = 0;
+};
+
+// Optional adaptive quality for scrcpy sessions.
+//
+// Tracked sessions run with --print-fps. Each one-second report is bad when
+// more than DROP_PERCENT of its frames were skipped, or when fewer than
+// LOW_FPS_PERCENT of the session's --max-fps (DEFAULT_FPS without one) were
+// delivered. Three bad reports out of the last five step the session one
+// rung down the ladder; a long clean run steps it back up. A step relaunches
+// the session with the new --bit-rate, --max-fps and --max-size. Steps are at
+// least MIN_DWELL_MS apart, and the clean run needed to climb doubles
+// whenever a climb is undone shortly after.
+//
+// The rung a session held steadily is remembered per device and app and
+// used for the next launch.
+class QualityController : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DROP_PERCENT = 10;
+    static constexpr int LOW_FPS_PERCENT = 50;
+    static constexpr int DEFAULT_FPS = 60;
+    static constexpr int DEGRADE_WINDOW = 5;
+    static constexpr int DEGRADE_BAD_REPORTS = 3;
+    static constexpr int SETTLE_REPORTS = 3;
+    static constexpr int UPGRADE_REPORTS = 30;
+    static constexpr int MAX_UPGRADE_REPORTS = 480;
+    static constexpr int MIN_DWELL_MS = 15000;
+    static constexpr int STABLE_MS = 60000;
+
+    explicit QualityController(SessionManager *sessions, QObject *parent = nullptr);
+
+    // Applies "adaptive-quality"
+    void loadSettings();
+    bool isEnabled() const;
+
+    static int levelCount();
+    static QualityLevel level(int index);
+    static QStringList applyLevel(const QStringList &arguments, int index);
+
+    // The --max-fps in these arguments, else DEFAULT_FPS
+    static int targetFps(const QStringList &arguments);
+    static bool isBadReport(const ScrcpyEvent &event, int targetFps);
+
+    // Remembered rung for this device and app (0 if none)
+    int profileLevel(const QString &serial, const QString &packageName) const;
+
+    // Starts a session at the remembered rung with --print-fps and watches it
+    ScrcpySession *launch(const QString &serial, const QString &packageName, const QString &appName,
+                          const QStringList &arguments, const LaunchTrace &trace = LaunchTrace());
+
+signals:
+    void sessionRelaunched(ScrcpySession *previous, ScrcpySession *replacement, int level);
+
+private:
+    struct Tracked {
+        int level = 0;
+        int targetFps = DEFAULT_FPS;
+        int reports = 0;
+        quint32 history = 0;      // 1 bits are bad reports, newest lowest
+        int goodStreak = 0;
+        int upgradeReports = UPGRADE_REPORTS;
+        bool lastStepWasUp = false;
+        bool remembered = false;
+        QStringList baseArguments;   // as configured, before any rung
+        QElapsedTimer sinceChange;
+    };
+
+    void startTracking(ScrcpySession *session, Tracked state);
+    void onFpsReport(ScrcpySession *session, const ScrcpyEvent &event);
+    void onSessionStateChanged(ScrcpySession *session);
+    void relaunch(ScrcpySession *session, int newLevel);
+    void rememberIfStable(ScrcpySession *session, const Tracked &state);
+    void saveProfile(const QString &serial, const QString &packageName, int level);
+
+    SessionManager *sessions;
+    bool enabled;
+    QHash<ScrcpySession *, Tracked> tracked;
+};
+
+#endif // QUALITYCONTROLLER_H
@@ -0,0 +1,218 @@
+#include "runningappsmonitor.h"
+#include <QHash>
+#include "packageparser.h"
+#include "logger.h"
+#include "metrics.h"
+
+namespace {
+// Names only keeps the transfer small; old toolbox ps has no -o
+const char *PS_COMMAND = "ps -A -o NAME 2>/dev/null || ps";
+
+const int FOCUSED_INTERVAL_MS = 2000;
+const int FOCUSED_MAX_INTERVAL_MS = 8000;
+const int IDLE_INTERVAL_MS = 10000;
+const int IDLE_MAX_INTERVAL_MS = 60000;
+// Unchanged polls before the interval doubles
+const int BACKOFF_STEP = 5;
+}
+
+RunningAppsMonitor::RunningAppsMonitor(AdbShellSession *session, QObject *parent)
+    : QObject(parent)
+    , session(session)
+    , pollTimer(new QTimer(this))
+    , commandId(0)
+    , enabled(false)
+    , focused(true)
+    , paused(false)
+    , unchangedPolls(0)
+    , haveSnapshot(false)
+    , lastOutputHash(0)
+    , polls(0)
+    , bytesTotal(0)
+{
+    pollTimer->setSingleShot(true);
+    connect(pollTimer, &QTimer::timeout, this, &RunningAppsMonitor::poll);
+    connect(session, &AdbShellSession::commandFinished, this, &RunningAppsMonitor::onCommandFinished);
+    connect(session, &AdbShellSession::commandFailed, this, &RunningAppsMonitor::onCommandFailed);
+}
+
+void RunningAppsMonitor::start()
+{
+    enabled = true;
+    if (!paused) {
+        poll();
+    }
+}
+
+void RunningAppsMonitor::stop()
+{
+    enabled = false;
+    pollTimer->stop();
+}
+
+void RunningAppsMonitor::pollNow()
+{
+    unchangedPolls = 0;
+    poll();
+}
+
+void RunningAppsMonitor::setFocused(bool isFocused)
+{
+    if (focused == isFocused) {
+        return;
+    }
+    focused = isFocused;
+
+    // Coming back to the window: refresh now rather than after a long idle wait
+    if (focused && enabled && !paused) {
+        unchangedPolls = 0;
+        if (pollTimer->isActive() && pollTimer->remainingTime() > FOCUSED_INTERVAL_MS) {
+            poll();
+        }
+    }
+}
+
+void RunningAppsMonitor::setPaused(bool isPaused)
+{
+    if (paused == isPaused) {
+        return;
+    }
+    paused = isPaused;
+    qCDebug(lcAdb) << "Running-apps polling" << (paused ? "paused" : "resumed");
+
+    if (paused) {
+        pollTimer->stop();
+    } else if (enabled) {
+        unchangedPolls = 0;
+        poll();
+    }
+}
+
+QSet<QString> RunningAppsMonitor::runningPackages() const
+{
+    return running;
+}
+
+RunningAppsMonitor::PollStats RunningAppsMonitor::lastPollStats() const
+{
+    return lastStats;
+}
+
+int RunningAppsMonitor::pollCount() const
+{
+    return polls;
+}
+
+qint64 RunningAppsMonitor::totalBytes() const
+{
+    return bytesTotal;
+}
+
+int RunningAppsMonitor::currentInterval() const
+{
+    int base = focused ? FOCUSED_INTERVAL_MS : IDLE_INTERVAL_MS;
+    int cap = focused ? FOCUSED_MAX_INTERVAL_MS : IDLE_MAX_INTERVAL_MS;
+    int shift = qMin(unchangedPolls / BACKOFF_STEP, 5);
+    return qMin(base << shift, cap);
+}
+
+void RunningAppsMonitor::poll()
+{
+    pollTimer->stop();
+
+    // Already waiting for one; its result reschedules
+    if (commandId != 0) {
+        return;
+    }
+
+    roundTripTimer.start();
+    commandId = session->execute(PS_COMMAND);
+}
+
+void RunningAppsMonitor::onCommandFinished(int id, const QByteArray &output, int exitCode)
+{
+    if (id != commandId) {
+        return;
+    }
+    commandId = 0;
+
+    if (exitCode != 0) {
+        qCDebug(lcAdb) << "ps failed with exit code" << exitCode;
+        Metrics::instance()->observeAdbQuery(Metrics::RunningApps, roundTripTimer.elapsed(), true);
+        ++unchangedPolls;
+        emit pollFailed(QString("ps exited with code %1").arg(exitCode));
+        scheduleNext();
+        return;
+    }
+
+    PollStats stats;
+    stats.roundTripMs = roundTripTimer.elapsed();
+    stats.bytes = output.size();
+    Metrics::instance()->observeAdbQuery(Metrics::RunningApps, stats.roundTripMs, false);
+
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+
+    QSet<QString> added;
+    QSet<QString> removed;
+    size_t hash = qHash(output);
+    if (haveSnapshot && hash == lastOutputHash) {
+        stats.unchanged = true;
+    } else {
+        QSet<QString> snapshot = PackageParser::parseRunningPackages(output);
+        added = snapshot - running;
+        removed = running - snapshot;
+        running = std::move(snapshot);
+        lastOutputHash = hash;
+        haveSnapshot = true;
+    }
+
+    stats.parseUs = parseTimer.nsecsElapsed() / 1000;
+    stats.added = added.size();
+    stats.removed = removed.size();
+
+    ++polls;
+    bytesTotal += stats.bytes;
+    lastStats = stats;
+
+    if (added.isEmpty() && removed.isEmpty()) {
+        ++unchangedPolls;
+    } else {
+        unchangedPolls = 0;
+    }
+
+    qCDebug(lcAdb) << "Running-apps poll:" << stats.bytes << "bytes," << stats.roundTripMs << "ms round trip,"
+                   << stats.parseUs << "us parse, +" << stats.added << "-" << stats.removed;
+
+    if (!added.isEmpty()) {
+        emit runningAppsAdded(added);
+    }
+    if (!removed.isEmpty()) {
+        emit runningAppsRemoved(removed);
+    }
+    emit pollFinished(stats);
+
+    scheduleNext();
+}
+
+void RunningAppsMonitor::onCommandFailed(int id, const QString &error)
+{
+    if (id != commandId) {
+        return;
+    }
+    commandId = 0;
+
+    qCDebug(lcAdb) << "Running-apps poll failed:" << error;
+    Metrics::instance()->observeAdbQuery(Metrics::RunningApps, roundTripTimer.elapsed(), true);
+    ++unchangedPolls;
+    emit pollFailed(error);
+    scheduleNext();
+}
+
+void RunningAppsMonitor::scheduleNext()
+{
+    if (!enabled || paused) {
+        return;
+    }
+    pollTimer->start(currentInterval());
+}
@@ -0,0 +1,77 @@
+#ifndef RUNNINGAPPSMONITOR_H
+#define RUNNINGAPPSMONITOR_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "adbshellsession.h"
+
+// Polls the device's process list over the shared shell session and reports
+// which packages started or stopped since the previous snapshot.
+//
+// The interval adapts: short while the window has focus, longer in the
+// background, stretched further while nothing changes, and polling stops
+// entirely while paused (window minimised).
+class RunningAppsMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct PollStats {
+        qint64 roundTripMs = 0;  // command sent -> output received
+        qint64 parseUs = 0;      // host CPU spent hashing and diffing
+        qint64 bytes = 0;        // ps output transferred
+        int added = 0;
+        int removed = 0;
+        bool unchanged = false;  // output identical to the previous poll
+    };
+
+    explicit RunningAppsMonitor(AdbShellSession *session, QObject *parent = nullptr);
+
+    void start();
+    void stop();
+    void pollNow();
+
+    void setFocused(bool focused);
+    void setPaused(bool paused);
+
+    QSet<QString> runningPackages() const;
+    PollStats lastPollStats() const;
+    int pollCount() const;
+    qint64 totalBytes() const;
+    int currentInterval() const;
+
+signals:
+    void runningAppsAdded(const QSet<QString> &packages);
+    void runningAppsRemoved(const QSet<QString> &packages);
+    void pollFinished(const RunningAppsMonitor::PollStats &stats);
+    void pollFailed(const QString &error);
+
+private slots:
+    void poll();
+    void onCommandFinished(int id, const QByteArray &output, int exitCode);
+    void onCommandFailed(int id, const QString &error);
+
+private:
+    void scheduleNext();
+
+    AdbShellSession *session;
+    QTimer *pollTimer;
+    QElapsedTimer roundTripTimer;
+    int commandId;
+    bool enabled;
+    bool focused;
+    bool paused;
+    int unchangedPolls;
+    bool haveSnapshot;
+    size_t lastOutputHash;
+    QSet<QString> running;
+
+    PollStats lastStats;
+    int polls;
+    qint64 bytesTotal;
+};
+
+#endif // RUNNINGAPPSMONITOR_H
@@ -0,0 +1,229 @@
+#include "scrcpyoutputparser.h"
+#include <cstring>
+#include <climits>
+
+namespace {
+
+struct LevelRule {
+    QByteArrayView prefix;
+    LogSeverity severity;
+};
+
+// scrcpy log levels; server lines carry an extra "[server] " prefix
+const LevelRule levelRules[] = {
+    { "VERBOSE: ", LogSeverity::Muted },
+    { "DEBUG: ", LogSeverity::Muted },
+    { "INFO: ", LogSeverity::Normal },
+    { "WARN: ", LogSeverity::Warning },
+    { "ERROR: ", LogSeverity::Error }
+};
+
+struct PrefixRule {
+    QByteArrayView prefix;
+    ScrcpyEvent::Type type;
+};
+
+const PrefixRule prefixRules[] = {
+    { "Device: ", ScrcpyEvent::DeviceName },
+    { "New display: ", ScrcpyEvent::NewDisplay },
+    { "Renderer: ", ScrcpyEvent::Renderer },
+    { "Texture: ", ScrcpyEvent::TextureSize },
+    { "Using video encoder: ", ScrcpyEvent::Codec },
+    { "Using audio encoder: ", ScrcpyEvent::Codec }
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+QByteArrayView trimmed(QByteArrayView view)
+{
+    qsizetype begin = 0;
+    qsizetype end = view.size();
+    while (begin < end && isSpace(view[begin]))
+        ++begin;
+    while (end > begin && isSpace(view[end - 1]))
+        --end;
+    return view.sliced(begin, end - begin);
+}
+
+// Parses leading decimal digits, advancing pos. Returns -1 if there are
+// none or they do not fit in an int (garbled output).
+int parseNumber(QByteArrayView view, qsizetype &pos)
+{
+    qsizetype start = pos;
+    qint64 value = 0;
+    while (pos < view.size() && view[pos] >= '0' && view[pos] <= '9') {
+        if (value <= INT_MAX)
+            value = value * 10 + (view[pos] - '0');
+        ++pos;
+    }
+    return pos > start && value <= INT_MAX ? int(value) : -1;
+}
+
+QSize parseSize(QByteArrayView view)
+{
+    qsizetype pos = 0;
+    int width = parseNumber(view, pos);
+    if (width < 0 || pos >= view.size() || view[pos] != 'x')
+        return QSize();
+    ++pos;
+    int height = parseNumber(view, pos);
+    return height < 0 ? QSize() : QSize(width, height);
+}
+
+// "60 fps" or "58 fps (+2 frames skipped)"
+bool parseFps(QByteArrayView body, ScrcpyEvent &event)
+{
+    qsizetype pos = 0;
+    int fps = parseNumber(body, pos);
+    if (fps < 0 || !body.sliced(pos).startsWith(" fps"))
+        return false;
+
+    event.fps = fps;
+    pos += 4;
+
+    QByteArrayView rest = body.sliced(pos);
+    if (rest.startsWith(" (+")) {
+        qsizetype skippedPos = 3;
+        int skipped = parseNumber(rest, skippedPos);
+        if (skipped > 0)
+            event.skippedFrames = skipped;
+    }
+    return true;
+}
+
+QString decode(QByteArrayView view)
+{
+    return QString::fromLocal8Bit(view.data(), view.size());
+}
+
+} // namespace
+
+ScrcpyOutputParser::ScrcpyOutputParser(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ScrcpyOutputParser::feed(QByteArrayView chunk)
+{
+    qsizetype start = 0;
+    while (start < chunk.size()) {
+        const void *found = memchr(chunk.data() + start, '\n', chunk.size() - start);
+        if (!found)
+            break;
+
+        qsizetype end = static_cast<const char *>(found) - chunk.data();
+        if (partial.isEmpty()) {
+            emitLine(chunk.sliced(start, end - start));
+        } else {
+            partial.append(chunk.data() + start, end - start);
+            emitLine(partial);
+            partial.clear();
+        }
+        start = end + 1;
+    }
+
+    // Keep the incomplete tail for the next read
+    if (start < chunk.size())
+        partial.append(chunk.data() + start, chunk.size() - start);
+}
+
+void ScrcpyOutputParser::finish()
+{
+    if (!partial.isEmpty()) {
+        emitLine(partial);
+        partial.clear();
+    }
+}
+
+void ScrcpyOutputParser::reset()
+{
+    partial.clear();
+}
+
+void ScrcpyOutputParser::emitLine(QByteArrayView line)
+{
+    if (line.endsWith('\r'))
+        line.chop(1);
+    if (trimmed(line).isEmpty())
+        return;
+
+    emit eventParsed(parseLine(line));
+}
+
+ScrcpyEvent ScrcpyOutputParser::parseLine(QByteArrayView line)
+{
+    ScrcpyEvent event;
+    event.text = decode(line);
+
+    QByteArrayView body = line;
+    if (body.startsWith("[server] ")) {
+        event.fromServer = true;
+        body = body.sliced(9);
+    }
+
+    bool hasLevel = false;
+    for (const LevelRule &rule : levelRules) {
+        if (body.startsWith(rule.prefix)) {
+            event.severity = rule.severity;
+            body = body.sliced(rule.prefix.size());
+            hasLevel = true;
+            break;
+        }
+    }
+
+    if (!hasLevel) {
+        // adb push progress is printed without a level
+        if (body.indexOf(" file pushed") >= 0 || body.indexOf(" files pushed") >= 0) {
+            event.type = ScrcpyEvent::ServerPushed;
+            event.severity = LogSeverity::Muted;
+        }
+        return event;
+    }
+
+    for (const PrefixRule &rule : prefixRules) {
+        if (body.startsWith(rule.prefix)) {
+            QByteArrayView value = trimmed(body.sliced(rule.prefix.size()));
+            event.type = rule.type;
+            event.value = decode(value);
+            if (rule.type == ScrcpyEvent::TextureSize || rule.type == ScrcpyEvent::NewDisplay)
+                event.size = parseSize(value);
+            if (rule.type == ScrcpyEvent::Codec && value.size() >= 2
+                    && value.startsWith('\'') && value.endsWith('\''))
+                event.value = decode(value.sliced(1, value.size() - 2));
+            return event;
+        }
+    }
+
+    QByteArrayView trimmedBody = trimmed(body);
+    if (trimmedBody.startsWith("-->")) {
+        // "-->   (usb)  SERIAL   device  MODEL": the serial follows the transport
+        QByteArrayView rest = trimmed(trimmedBody.sliced(3));
+        qsizetype close = rest.indexOf(')');
+        if (rest.startsWith('(') && close > 0)
+            rest = trimmed(rest.sliced(close + 1));
+        qsizetype space = 0;
+        while (space < rest.size() && !isSpace(rest[space]))
+            ++space;
+        event.type = ScrcpyEvent::DeviceFound;
+        event.value = decode(rest.first(space));
+        return event;
+    }
+
+    if (parseFps(trimmedBody, event)) {
+        event.type = ScrcpyEvent::Fps;
+        event.severity = LogSeverity::Muted;
+        return event;
+    }
+
+    if (event.severity == LogSeverity::Warning) {
+        event.type = ScrcpyEvent::Warning;
+        event.value = decode(trimmedBody);
+    } else if (event.severity == LogSeverity::Error) {
+        event.type = ScrcpyEvent::Error;
+        event.value = decode(trimmedBody);
+    }
+    return event;
+}
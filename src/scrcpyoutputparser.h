@@ -0,0 +1,63 @@
+#ifndef SCRCPYOUTPUTPARSER_H
+#define SCRCPYOUTPUTPARSER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QSize>
+#include "logmodel.h"
+
+struct ScrcpyEvent {
+    enum Type {
+        Line,           // Anything not recognized below
+        ServerPushed,   // "scrcpy-server: 1 file pushed, ..."
+        DeviceFound,    // "INFO:     -->   (usb)  SERIAL  device  MODEL"
+        DeviceName,     // "[server] INFO: Device: [vendor] brand model (Android N)"
+        NewDisplay,     // "[server] INFO: New display: 1080x2400/420 (id=5)"
+        Renderer,       // "INFO: Renderer: opengl"
+        TextureSize,    // "INFO: Texture: 1080x2400"
+        Codec,          // "[server] INFO: Using video encoder: 'c2.android.avc.encoder'"
+        Fps,            // "INFO: 60 fps" or "INFO: 58 fps (+2 frames skipped)"
+        Warning,        // Any other "WARN:" line
+        Error           // Any other "ERROR:" line
+    };
+
+    Type type = Line;
+    LogSeverity severity = LogSeverity::Normal;
+    bool fromServer = false;
+    QString text;       // Full line as it should be displayed
+    QString value;      // Device name, renderer, codec or message body
+    QSize size;         // Texture or display size
+    int fps = 0;
+    int skippedFrames = 0;
+};
+
+// Incremental parser for scrcpy stdout/stderr.
+//
+// feed() accepts arbitrary read chunks and carries partial lines across
+// calls; complete lines are sliced out of the chunk without copying and
+// matched against a prefix table to produce typed events.
+class ScrcpyOutputParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScrcpyOutputParser(QObject *parent = nullptr);
+
+    void feed(QByteArrayView chunk);
+    void finish();
+    void reset();
+
+    static ScrcpyEvent parseLine(QByteArrayView line);
+
+signals:
+    void eventParsed(const ScrcpyEvent &event);
+
+private:
+    void emitLine(QByteArrayView line);
+
+    QByteArray partial;
+};
+
+#endif // SCRCPYOUTPUTPARSER_H
@@ -0,0 +1,194 @@
+#include "scrcpyprofile.h"
+#include "tracer.h"
+#include <QSettings>
+
+namespace {
+
+// Older settings store the combo text, e.g. "Default (8M)"
+QString optionValue(const QSettings &settings, const QString &key)
+{
+    QString value = settings.value(key).toString();
+    return value.startsWith("Default") ? QString() : value;
+}
+
+} // namespace
+
+ScrcpyProfile ScrcpyProfile::load(QSettings &settings)
+{
+    ScrcpyProfile profile;
+
+    profile.alwaysOnTop = settings.value("always-on-top", false).toBool();
+    profile.noControl = settings.value("no-control", false).toBool();
+    profile.stayAwake = settings.value("stay-awake", false).toBool();
+    profile.turnScreenOff = settings.value("turn-screen-off", false).toBool();
+    profile.noVdDestroyContent = settings.value("no-vd-destroy-content", false).toBool();
+    profile.showTouches = settings.value("show-touches", false).toBool();
+    profile.disableScreensaver = settings.value("disable-screensaver", false).toBool();
+    profile.autoRestart = settings.value("auto-restart", false).toBool();
+
+    profile.maxSize = settings.value("max-size", 0).toInt();
+    profile.bitRate = optionValue(settings, "bit-rate");
+    profile.maxFps = settings.value("max-fps", 0).toInt();
+    profile.videoCodec = optionValue(settings, "video-codec");
+    profile.rotation = settings.value("rotation", 0).toInt();
+    profile.noMipmaps = settings.value("no-mipmaps", false).toBool();
+
+    profile.noAudio = settings.value("no-audio", false).toBool();
+    profile.audioCodec = optionValue(settings, "audio-codec");
+    profile.audioBitRate = optionValue(settings, "audio-bit-rate");
+
+    profile.fullscreen = settings.value("fullscreen", false).toBool();
+    profile.borderless = settings.value("window-borderless", false).toBool();
+    profile.windowTitle = settings.value("window-title").toString();
+
+    profile.customArgs = settings.value("custom-args").toString();
+
+    profile.compile();
+    return profile;
+}
+
+void ScrcpyProfile::save(QSettings &settings) const
+{
+    settings.setValue("always-on-top", alwaysOnTop);
+    settings.setValue("no-control", noControl);
+    settings.setValue("stay-awake", stayAwake);
+    settings.setValue("turn-screen-off", turnScreenOff);
+    settings.setValue("no-vd-destroy-content", noVdDestroyContent);
+    settings.setValue("show-touches", showTouches);
+    settings.setValue("disable-screensaver", disableScreensaver);
+    settings.setValue("auto-restart", autoRestart);
+
+    settings.setValue("max-size", maxSize);
+    settings.setValue("bit-rate", bitRate);
+    settings.setValue("max-fps", maxFps);
+    settings.setValue("video-codec", videoCodec);
+    settings.setValue("rotation", rotation);
+    settings.setValue("no-mipmaps", noMipmaps);
+
+    settings.setValue("no-audio", noAudio);
+    settings.setValue("audio-codec", audioCodec);
+    settings.setValue("audio-bit-rate", audioBitRate);
+
+    settings.setValue("fullscreen", fullscreen);
+    settings.setValue("window-borderless", borderless);
+    settings.setValue("window-title", windowTitle);
+
+    settings.setValue("custom-args", customArgs);
+}
+
+void ScrcpyProfile::compile()
+{
+    arguments.clear();
+
+    if (alwaysOnTop) arguments << "--always-on-top";
+    if (noControl) arguments << "--no-control";
+    if (stayAwake) arguments << "--stay-awake";
+    if (turnScreenOff) arguments << "--turn-screen-off";
+    if (noVdDestroyContent) arguments << "--no-vd-destroy-content";
+    if (showTouches) arguments << "--show-touches";
+    if (disableScreensaver) arguments << "--disable-screensaver";
+
+    if (maxSize > 0) arguments << "--max-size" << QString::number(maxSize);
+    if (!bitRate.isEmpty()) arguments << "--bit-rate" << bitRate;
+    if (maxFps > 0) arguments << "--max-fps" << QString::number(maxFps);
+    if (!videoCodec.isEmpty()) arguments << "--video-codec" << videoCodec;
+    if (rotation > 0) arguments << "--rotation" << QString::number(rotation);
+    if (noMipmaps) arguments << "--no-mipmaps";
+
+    if (noAudio) arguments << "--no-audio";
+    if (!audioCodec.isEmpty()) arguments << "--audio-codec" << audioCodec;
+    if (!audioBitRate.isEmpty()) arguments << "--audio-bit-rate" << audioBitRate;
+
+    if (fullscreen) arguments << "--fullscreen";
+    if (borderless) arguments << "--window-borderless";
+
+    customArgsError.clear();
+    customArguments = tokenize(customArgs, &customArgsError);
+}
+
+QStringList ScrcpyProfile::launchArguments(const QString &serial, const QString &packageName,
+                                           const QString &appName) const
+{
+    TRACE_SPAN("ScrcpyProfile::launchArguments");
+    QStringList result;
+    result.reserve(arguments.size() + customArguments.size() + 8);
+
+    if (!serial.isEmpty()) {
+        result << "--serial" << serial;
+    }
+    // Only use --new-display and --start-app if launching specific app
+    if (!packageName.isEmpty()) {
+        result << "--new-display" << "--start-app=" + packageName;
+    }
+
+    result += arguments;
+    result << "--window-title" << (windowTitle.isEmpty() ? appName : windowTitle);
+    result += customArguments;
+    return result;
+}
+
+QStringList ScrcpyProfile::tokenize(const QString &command, QString *error)
+{
+    enum Quote { None, Single, Double };
+
+    QStringList tokens;
+    QString current;
+    bool inToken = false;
+    Quote quote = None;
+
+    for (int i = 0; i < command.size(); ++i) {
+        QChar c = command.at(i);
+
+        if (quote == Single) {
+            if (c == '\'') {
+                quote = None;
+            } else {
+                current += c;
+            }
+            continue;
+        }
+
+        if (quote == Double) {
+            if (c == '"') {
+                quote = None;
+            } else if (c == '\\' && i + 1 < command.size()
+                       && QStringView(u"\"\\$`").contains(command.at(i + 1))) {
+                current += command.at(++i);
+            } else {
+                current += c;
+            }
+            continue;
+        }
+
+        if (c.isSpace()) {
+            if (inToken) {
+                tokens << current;
+                current.clear();
+                inToken = false;
+            }
+        } else if (c == '\'') {
+            quote = Single;
+            inToken = true;
+        } else if (c == '"') {
+            quote = Double;
+            inToken = true;
+        } else if (c == '\\' && i + 1 < command.size()) {
+            current += command.at(++i);
+            inToken = true;
+        } else {
+            current += c;
+            inToken = true;
+        }
+    }
+
+    if (quote != None) {
+        if (error) {
+            *error = "Unterminated quote in custom arguments";
+        }
+        return QStringList();
+    }
+    if (inToken) {
+        tokens << current;
+    }
+    return tokens;
+}
@@ -0,0 +1,66 @@
+#ifndef SCRCPYPROFILE_H
+#define SCRCPYPROFILE_H
+
+#include <QString>
+#include <QStringList>
+
+class QSettings;
+
+// Typed scrcpy launch options.
+//
+// load() reads one settings group; compile() turns the options into the
+// argument vector once, so a launch only concatenates lists. Empty strings
+// and zeros mean "scrcpy's default" and add no flag.
+struct ScrcpyProfile {
+    QString name;   // empty for the default profile
+
+    // General
+    bool alwaysOnTop = false;
+    bool noControl = false;
+    bool stayAwake = false;
+    bool turnScreenOff = false;
+    bool noVdDestroyContent = false;
+    bool showTouches = false;
+    bool disableScreensaver = false;
+    // Not a scrcpy flag: SessionSupervisor relaunches the session after a
+    // crash or a lost device
+    bool autoRestart = false;
+
+    // Video
+    int maxSize = 0;
+    QString bitRate;
+    int maxFps = 0;
+    QString videoCodec;
+    int rotation = 0;
+    bool noMipmaps = false;
+
+    // Audio
+    bool noAudio = false;
+    QString audioCodec;
+    QString audioBitRate;
+
+    // Window
+    bool fullscreen = false;
+    bool borderless = false;
+    QString windowTitle;    // empty: the app's name
+
+    QString customArgs;
+
+    // Filled by compile()
+    QStringList arguments;
+    QStringList customArguments;
+    QString customArgsError;
+
+    // Reads/writes the keys of the current settings group
+    static ScrcpyProfile load(QSettings &settings);
+    void save(QSettings &settings) const;
+
+    void compile();
+    QStringList launchArguments(const QString &serial, const QString &packageName,
+                                const QString &appName) const;
+
+    // POSIX shell word splitting: quotes and backslash escapes, no expansion
+    static QStringList tokenize(const QString &command, QString *error = nullptr);
+};
+
+#endif // SCRCPYPROFILE_H
@@ -0,0 +1,397 @@
+#include "scrcpysession.h"
+#include "logger.h"
+#include "metrics.h"
+#include "tracer.h"
+
+ScrcpySession::ScrcpySession(int id, const QString &serial, const QString &packageName,
+                             const QString &appName, QObject *parent)
+    : QObject(parent)
+    , sessionId(id)
+    , deviceSerial(serial)
+    , package(packageName)
+    , name(appName)
+    , process(new QProcess(this))
+    , graceTimer(new QTimer(this))
+    , stdoutParser(new ScrcpyOutputParser(this))
+    , stderrParser(new ScrcpyOutputParser(this))
+    , logModel(new LogModel(this))
+    , currentState(Starting)
+    , scrcpyFps(0)
+    , lastExitCode(0)
+    , pid(0)
+    , uptimeAtExit(0)
+    , bytesRead(0)
+    , events(0)
+    , traceReported(false)
+{
+    graceTimer->setSingleShot(true);
+    graceTimer->setInterval(STOP_GRACE_MS);
+    connect(graceTimer, &QTimer::timeout, this, &ScrcpySession::onGraceExpired);
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &ScrcpySession::onFinished);
+    connect(process, &QProcess::errorOccurred, this, &ScrcpySession::onErrorOccurred);
+    connect(process, &QProcess::started, this, &ScrcpySession::onStarted);
+    connect(process, &QProcess::readyReadStandardOutput, this, &ScrcpySession::onReadyReadStandardOutput);
+    connect(process, &QProcess::readyReadStandardError, this, &ScrcpySession::onReadyReadStandardError);
+
+    connect(stdoutParser, &ScrcpyOutputParser::eventParsed, this, &ScrcpySession::onEvent);
+    connect(stderrParser, &ScrcpyOutputParser::eventParsed, this, &ScrcpySession::onEvent);
+}
+
+ScrcpySession::~ScrcpySession()
+{
+    // QProcess kills the child on destruction; don't report it
+    process->disconnect(this);
+}
+
+int ScrcpySession::id() const
+{
+    return sessionId;
+}
+
+QString ScrcpySession::serial() const
+{
+    return deviceSerial;
+}
+
+QString ScrcpySession::packageName() const
+{
+    return package;
+}
+
+QString ScrcpySession::appName() const
+{
+    return name;
+}
+
+QStringList ScrcpySession::arguments() const
+{
+    return args;
+}
+
+ScrcpySession::State ScrcpySession::state() const
+{
+    return currentState;
+}
+
+bool ScrcpySession::isActive() const
+{
+    return currentState == Starting || currentState == Running || currentState == Stopping;
+}
+
+QString ScrcpySession::statusText() const
+{
+    switch (currentState) {
+    case Starting:
+        return "Starting " + name + "...";
+    case Running: {
+        QString status = "Running: " + name;
+        if (!scrcpyDeviceName.isEmpty()) {
+            status += " on " + scrcpyDeviceName;
+        }
+        if (scrcpyFps > 0) {
+            status += QString(" (%1 fps)").arg(scrcpyFps);
+        }
+        return status;
+    }
+    case Stopping:
+        return "Stopping " + name + "...";
+    case Finished:
+        return name + " closed";
+    case Failed:
+        if (!lastScrcpyError.isEmpty()) {
+            return "Scrcpy error: " + lastScrcpyError;
+        }
+        return "Scrcpy error - see logs";
+    }
+    return QString();
+}
+
+LogModel *ScrcpySession::log() const
+{
+    return logModel;
+}
+
+QString ScrcpySession::deviceName() const
+{
+    return scrcpyDeviceName;
+}
+
+int ScrcpySession::fps() const
+{
+    return scrcpyFps;
+}
+
+QString ScrcpySession::lastError() const
+{
+    return lastScrcpyError;
+}
+
+int ScrcpySession::exitCode() const
+{
+    return lastExitCode;
+}
+
+qint64 ScrcpySession::processId() const
+{
+    return pid;
+}
+
+QDateTime ScrcpySession::startedAt() const
+{
+    return startTime;
+}
+
+qint64 ScrcpySession::uptimeMs() const
+{
+    if (!uptime.isValid()) {
+        return 0;
+    }
+    return isActive() ? uptime.elapsed() : uptimeAtExit;
+}
+
+qint64 ScrcpySession::outputBytes() const
+{
+    return bytesRead;
+}
+
+int ScrcpySession::eventCount() const
+{
+    return events;
+}
+
+qint64 ScrcpySession::windowLatencyMs() const
+{
+    return trace.has(LaunchTrace::FirstFrame) ? trace.offsetUs(LaunchTrace::FirstFrame) / 1000 : -1;
+}
+
+LaunchTrace ScrcpySession::launchTrace() const
+{
+    return trace;
+}
+
+void ScrcpySession::setAdbProgram(const QString &program)
+{
+    adbProgram = program;
+}
+
+void ScrcpySession::start(const QString &program, const QStringList &arguments,
+                          const LaunchTrace &launchTrace)
+{
+    TRACE_SPAN("ScrcpySession::start");
+    scrcpyProgram = program;
+    args = arguments;
+    startTime = QDateTime::currentDateTime();
+    uptime.start();
+    trace = launchTrace;
+    if (!trace.isValid()) {
+        trace.start();
+        trace.mark(LaunchTrace::SettingsResolved);
+    }
+    trace.serial = deviceSerial;
+    trace.packageName = package;
+
+    qCDebug(lcScrcpy) << "Session" << sessionId << "launching scrcpy with args:" << arguments;
+
+    logModel->append("========================================", LogSeverity::Info);
+    logModel->append(QString("[%1] Launching scrcpy: %2")
+                     .arg(startTime.toString("hh:mm:ss"))
+                     .arg(name), LogSeverity::Info);
+    if (!package.isEmpty()) {
+        logModel->append("Package: " + package, LogSeverity::Muted);
+    }
+    logModel->append("Command: " + program + " " + arguments.join(" "), LogSeverity::Muted);
+    logModel->append("========================================", LogSeverity::Info);
+
+    // An adb of another version would restart the server and drop every session
+    if (!adbProgram.isEmpty()) {
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert("ADB", adbProgram);
+        process->setProcessEnvironment(environment);
+    }
+
+    setState(Starting);
+    process->start(program, arguments);
+}
+
+void ScrcpySession::stop()
+{
+    if (process->state() == QProcess::NotRunning || currentState == Stopping) {
+        return;
+    }
+
+    setState(Stopping);
+    logModel->append("Terminating scrcpy...", LogSeverity::Notice);
+    process->terminate();
+    graceTimer->start();
+}
+
+void ScrcpySession::stopAndWait(int timeoutMs)
+{
+    stop();
+    if (process->state() != QProcess::NotRunning && !process->waitForFinished(timeoutMs)) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void ScrcpySession::onGraceExpired()
+{
+    if (process->state() == QProcess::NotRunning) {
+        return;
+    }
+    qCDebug(lcScrcpy) << "Session" << sessionId << "ignored terminate for" << STOP_GRACE_MS << "ms, killing";
+    logModel->append("Force killing scrcpy...", LogSeverity::Error);
+    process->kill();
+}
+
+void ScrcpySession::onStarted()
+{
+    pid = process->processId();
+    trace.mark(LaunchTrace::ProcessStarted);
+    qCDebug(lcScrcpy) << "Session" << sessionId << "started, pid" << pid;
+    logModel->append("Scrcpy started successfully!", LogSeverity::Success);
+    setState(Running);
+}
+
+void ScrcpySession::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    qCDebug(lcScrcpy) << "Session" << sessionId << "finished with exit code:" << exitCode;
+
+    // Drain whatever is left, including a last line without a newline
+    onReadyReadStandardOutput();
+    onReadyReadStandardError();
+    stdoutParser->finish();
+    stderrParser->finish();
+
+    graceTimer->stop();
+    finishLaunchTrace();
+    lastExitCode = exitCode;
+    uptimeAtExit = uptime.elapsed();
+
+    bool crashed = exitStatus == QProcess::CrashExit && currentState != Stopping;
+    if (currentState == Stopping) {
+        logModel->append("Scrcpy stopped", LogSeverity::Success);
+        setState(Finished);
+    } else if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        logModel->append("Scrcpy closed normally", LogSeverity::Success);
+        setState(Finished);
+    } else {
+        logModel->append(QString("Scrcpy exited with error code: %1").arg(exitCode), LogSeverity::Error);
+        setState(Failed);
+    }
+    Metrics::instance()->sessionExited(exitCode, currentState == Failed, crashed);
+}
+
+void ScrcpySession::onErrorOccurred(QProcess::ProcessError error)
+{
+    QString errorMsg;
+
+    switch (error) {
+        case QProcess::FailedToStart:
+            errorMsg = QString("Failed to start scrcpy (%1). Check the scrcpy program in Settings > Advanced, "
+                               "or that scrcpy is installed and in your PATH.").arg(scrcpyProgram);
+            break;
+        case QProcess::Crashed:
+            // A terminate/kill we asked for shows up as a crash
+            if (currentState == Stopping) {
+                return;
+            }
+            errorMsg = "Scrcpy crashed";
+            break;
+        case QProcess::Timedout:
+            errorMsg = "Scrcpy operation timed out";
+            break;
+        default:
+            errorMsg = "An error occurred with scrcpy: " + process->errorString();
+    }
+
+    qCDebug(lcScrcpy) << "Session" << sessionId << "error:" << errorMsg;
+    logModel->append("ERROR: " + errorMsg, LogSeverity::Error);
+
+    if (error == QProcess::FailedToStart) {
+        uptimeAtExit = uptime.elapsed();
+        finishLaunchTrace();
+        setState(Failed);
+        Metrics::instance()->sessionExited(-1, true, false);
+    }
+    emit processError(error);
+}
+
+void ScrcpySession::onReadyReadStandardOutput()
+{
+    QByteArray data = process->readAllStandardOutput();
+    bytesRead += data.size();
+    stdoutParser->feed(data);
+}
+
+void ScrcpySession::onReadyReadStandardError()
+{
+    // stderr dari scrcpy biasanya info, bukan error
+    QByteArray data = process->readAllStandardError();
+    bytesRead += data.size();
+    stderrParser->feed(data);
+}
+
+void ScrcpySession::onEvent(const ScrcpyEvent &event)
+{
+    ++events;
+    logModel->append(event.text, event.severity);
+
+    switch (event.type) {
+    case ScrcpyEvent::ServerPushed:
+        trace.mark(LaunchTrace::ServerPushed);
+        break;
+    case ScrcpyEvent::DeviceName:
+        trace.mark(LaunchTrace::DeviceConnected);
+        scrcpyDeviceName = event.value;
+        emit statusChanged();
+        break;
+    case ScrcpyEvent::Fps:
+        scrcpyFps = event.fps;
+        if (!trace.has(LaunchTrace::FirstFps)) {
+            trace.mark(LaunchTrace::FirstFps);
+            finishLaunchTrace();
+        }
+        emit statusChanged();
+        break;
+    case ScrcpyEvent::Error:
+        lastScrcpyError = event.value;
+        break;
+    case ScrcpyEvent::Renderer:
+    case ScrcpyEvent::TextureSize:
+        // The window exists once the renderer or first frame is reported
+        if (!trace.has(LaunchTrace::FirstFrame)) {
+            trace.mark(LaunchTrace::FirstFrame);
+            qCInfo(lcScrcpy) << "Session" << sessionId << "window up" << windowLatencyMs() << "ms after launch request";
+            emit windowShown(windowLatencyMs());
+            // FPS is only reported with --print-fps; don't wait forever for it
+            QTimer::singleShot(FPS_WAIT_MS, this, &ScrcpySession::finishLaunchTrace);
+        }
+        break;
+    default:
+        break;
+    }
+
+    emit eventParsed(event);
+}
+
+void ScrcpySession::finishLaunchTrace()
+{
+    if (traceReported) {
+        return;
+    }
+    traceReported = true;
+    emit launchTraced(trace);
+}
+
+void ScrcpySession::setState(State newState)
+{
+    if (currentState == newState) {
+        return;
+    }
+    currentState = newState;
+    emit stateChanged();
+    emit statusChanged();
+}
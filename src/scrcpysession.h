@@ -0,0 +1,130 @@
+#ifndef SCRCPYSESSION_H
+#define SCRCPYSESSION_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QProcess>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "logmodel.h"
+#include "scrcpyoutputparser.h"
+#include "launchmetrics.h"
+
+// One scrcpy process: its output parsers, its own log buffer, status parsed
+// from the output, and what it has cost so far.
+//
+// stop() never blocks: it asks the process to terminate and only kills it
+// if it is still around after a grace period.
+class ScrcpySession : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int STOP_GRACE_MS = 3000;
+    // How long after the first frame to wait for an FPS report (--print-fps)
+    static constexpr int FPS_WAIT_MS = 3000;
+
+    enum State {
+        Starting,
+        Running,
+        Stopping,
+        Finished,
+        Failed
+    };
+
+    ScrcpySession(int id, const QString &serial, const QString &packageName,
+                  const QString &appName, QObject *parent = nullptr);
+    ~ScrcpySession();
+
+    int id() const;
+    QString serial() const;
+    QString packageName() const;
+    QString appName() const;
+    QStringList arguments() const;
+
+    State state() const;
+    bool isActive() const;
+    QString statusText() const;
+
+    LogModel *log() const;
+    QString deviceName() const;
+    int fps() const;
+    QString lastError() const;
+    int exitCode() const;
+
+    // Resource accounting
+    qint64 processId() const;
+    QDateTime startedAt() const;
+    qint64 uptimeMs() const;
+    qint64 outputBytes() const;
+    int eventCount() const;
+    // From the launch request to scrcpy's window, or -1 if not shown yet
+    qint64 windowLatencyMs() const;
+    LaunchTrace launchTrace() const;
+
+    // Exported to scrcpy as ADB, so it talks to the same adb server as the
+    // GUI; empty keeps scrcpy's own lookup on PATH
+    void setAdbProgram(const QString &program);
+    // trace was started when the user asked for the session; a fresh one
+    // is started here otherwise
+    void start(const QString &program, const QStringList &arguments,
+               const LaunchTrace &trace = LaunchTrace());
+    void stop();
+    // Blocking variant for application exit
+    void stopAndWait(int timeoutMs);
+
+signals:
+    void stateChanged();
+    void statusChanged();
+    void eventParsed(const ScrcpyEvent &event);
+    void processError(QProcess::ProcessError error);
+    void windowShown(qint64 latencyMs);
+    // Once per session, when the launch phases are done or the process ended
+    void launchTraced(const LaunchTrace &trace);
+
+private slots:
+    void onStarted();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onReadyReadStandardOutput();
+    void onReadyReadStandardError();
+    void onEvent(const ScrcpyEvent &event);
+    void onGraceExpired();
+    void finishLaunchTrace();
+
+private:
+    void setState(State newState);
+
+    int sessionId;
+    QString deviceSerial;
+    QString package;
+    QString name;
+    QStringList args;
+    QString scrcpyProgram;
+    QString adbProgram;
+
+    QProcess *process;
+    QTimer *graceTimer;
+    ScrcpyOutputParser *stdoutParser;
+    ScrcpyOutputParser *stderrParser;
+    LogModel *logModel;
+
+    State currentState;
+    QString scrcpyDeviceName;
+    int scrcpyFps;
+    QString lastScrcpyError;
+    int lastExitCode;
+
+    qint64 pid;
+    QDateTime startTime;
+    QElapsedTimer uptime;
+    qint64 uptimeAtExit;
+    qint64 bytesRead;
+    int events;
+    LaunchTrace trace;
+    bool traceReported;
+};
+
+#endif // SCRCPYSESSION_H
@@ -0,0 +1,100 @@
+#include "sessionlistmodel.h"
+#include "sessionmanager.h"
+#include <QBrush>
+#include <QColor>
+
+SessionListModel::SessionListModel(SessionManager *manager, QObject *parent)
+    : QAbstractListModel(parent)
+    , rows(manager->sessions())
+{
+    connect(manager, &SessionManager::sessionAdded, this, &SessionListModel::onSessionAdded);
+    connect(manager, &SessionManager::sessionChanged, this, &SessionListModel::onSessionChanged);
+    connect(manager, &SessionManager::sessionAboutToBeRemoved, this, &SessionListModel::onSessionAboutToBeRemoved);
+}
+
+int SessionListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant SessionListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+
+    const ScrcpySession *session = rows.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("#%1  %2").arg(session->id()).arg(session->statusText());
+    case Qt::ToolTipRole: {
+        QStringList lines;
+        if (!session->packageName().isEmpty()) {
+            lines << "Package: " + session->packageName();
+        }
+        if (!session->serial().isEmpty()) {
+            lines << "Device: " + session->serial();
+        }
+        if (session->processId() > 0) {
+            lines << QString("PID: %1").arg(session->processId());
+        }
+        lines << QString("Uptime: %1 s").arg(session->uptimeMs() / 1000);
+        if (session->windowLatencyMs() >= 0) {
+            lines << QString("Window shown after: %1 ms").arg(session->windowLatencyMs());
+        }
+        lines << QString("Output: %1 KB, %2 lines").arg(session->outputBytes() / 1024).arg(session->eventCount());
+        return lines.join('\n');
+    }
+    case Qt::ForegroundRole:
+        switch (session->state()) {
+        case ScrcpySession::Running:
+            return QBrush(QColor("#4caf50"));
+        case ScrcpySession::Failed:
+            return QBrush(QColor("#f44336"));
+        case ScrcpySession::Finished:
+            return QBrush(Qt::gray);
+        default:
+            return QVariant();
+        }
+    case SessionIdRole:
+        return session->id();
+    default:
+        return QVariant();
+    }
+}
+
+ScrcpySession *SessionListModel::sessionAt(int row) const
+{
+    return rows.value(row);
+}
+
+int SessionListModel::rowOf(ScrcpySession *session) const
+{
+    return rows.indexOf(session);
+}
+
+void SessionListModel::onSessionAdded(ScrcpySession *session)
+{
+    int row = rows.size();
+    beginInsertRows(QModelIndex(), row, row);
+    rows.append(session);
+    endInsertRows();
+}
+
+void SessionListModel::onSessionChanged(ScrcpySession *session)
+{
+    int row = rows.indexOf(session);
+    if (row >= 0) {
+        emit dataChanged(index(row), index(row));
+    }
+}
+
+void SessionListModel::onSessionAboutToBeRemoved(ScrcpySession *session)
+{
+    int row = rows.indexOf(session);
+    if (row < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    rows.removeAt(row);
+    endRemoveRows();
+}
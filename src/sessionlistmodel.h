@@ -0,0 +1,37 @@
+#ifndef SESSIONLISTMODEL_H
+#define SESSIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+
+class SessionManager;
+class ScrcpySession;
+
+// Rows for the session list, one per ScrcpySession, in start order.
+class SessionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        SessionIdRole = Qt::UserRole
+    };
+
+    explicit SessionListModel(SessionManager *manager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    ScrcpySession *sessionAt(int row) const;
+    int rowOf(ScrcpySession *session) const;
+
+private slots:
+    void onSessionAdded(ScrcpySession *session);
+    void onSessionChanged(ScrcpySession *session);
+    void onSessionAboutToBeRemoved(ScrcpySession *session);
+
+private:
+    QList<ScrcpySession *> rows;
+};
+
+#endif // SESSIONLISTMODEL_H
@@ -0,0 +1,171 @@
+#include "sessionmanager.h"
+#include "logger.h"
+#include "metrics.h"
+#include "toolpaths.h"
+
+SessionManager::SessionManager(QObject *parent)
+    : QObject(parent)
+    , scrcpyProgram(ToolPaths::scrcpy())
+    , adbPath(ToolPaths::adb())
+    , logLineCap(LogModel::DEFAULT_LINE_CAP)
+    , nextId(1)
+{
+}
+
+SessionManager::~SessionManager()
+{
+    shutdown();
+}
+
+QString SessionManager::program() const
+{
+    return scrcpyProgram;
+}
+
+void SessionManager::setProgram(const QString &program)
+{
+    scrcpyProgram = program;
+}
+
+QString SessionManager::adbProgram() const
+{
+    return adbPath;
+}
+
+void SessionManager::setAdbProgram(const QString &program)
+{
+    adbPath = program;
+}
+
+void SessionManager::setLogLineCap(int lines)
+{
+    logLineCap = lines;
+    for (ScrcpySession *session : std::as_const(sessionList)) {
+        session->log()->setLineCap(lines);
+    }
+}
+
+ScrcpySession *SessionManager::startSession(const QString &serial, const QString &packageName,
+                                            const QString &appName, const QStringList &arguments,
+                                            const LaunchTrace &trace)
+{
+    // Starting an app that already had a session (now ended) is a restart
+    bool restart = false;
+    for (ScrcpySession *previous : std::as_const(sessionList)) {
+        if (!previous->isActive() && previous->serial() == serial && previous->packageName() == packageName) {
+            restart = true;
+            break;
+        }
+    }
+    Metrics::instance()->sessionStarted(restart);
+
+    ScrcpySession *session = new ScrcpySession(nextId++, serial, packageName, appName, this);
+    session->log()->setLineCap(logLineCap);
+
+    connect(session, &ScrcpySession::statusChanged, this, [this, session]() {
+        emit sessionChanged(session);
+    });
+    connect(session, &ScrcpySession::processError, this, [this, session](QProcess::ProcessError error) {
+        emit sessionError(session, error);
+    });
+
+    sessionList.append(session);
+    emit sessionAdded(session);
+
+    session->setAdbProgram(adbPath);
+    session->start(scrcpyProgram, arguments, trace);
+    qCDebug(lcScrcpy) << "Started session" << session->id() << "-" << activeCount() << "active";
+    return session;
+}
+
+bool SessionManager::stopSession(int id)
+{
+    ScrcpySession *target = session(id);
+    if (!target || !target->isActive()) {
+        return false;
+    }
+    target->stop();
+    return true;
+}
+
+void SessionManager::stopAll()
+{
+    for (ScrcpySession *session : std::as_const(sessionList)) {
+        if (session->isActive()) {
+            session->stop();
+        }
+    }
+}
+
+void SessionManager::shutdown(int timeoutMs)
+{
+    // Ask everyone first so the grace periods run in parallel
+    stopAll();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (ScrcpySession *session : std::as_const(sessionList)) {
+        if (session->isActive()) {
+            session->stopAndWait(qMax<qint64>(0, timeoutMs - timer.elapsed()));
+        }
+    }
+}
+
+bool SessionManager::removeSession(int id)
+{
+    ScrcpySession *target = session(id);
+    if (!target || target->isActive()) {
+        return false;
+    }
+
+    emit sessionAboutToBeRemoved(target);
+    sessionList.removeOne(target);
+    target->deleteLater();
+    return true;
+}
+
+void SessionManager::removeFinished()
+{
+    const QList<ScrcpySession *> snapshot = sessionList;
+    for (ScrcpySession *session : snapshot) {
+        if (!session->isActive()) {
+            removeSession(session->id());
+        }
+    }
+}
+
+ScrcpySession *SessionManager::session(int id) const
+{
+    for (ScrcpySession *session : sessionList) {
+        if (session->id() == id) {
+            return session;
+        }
+    }
+    return nullptr;
+}
+
+ScrcpySession *SessionManager::findActive(const QString &serial, const QString &packageName) const
+{
+    for (ScrcpySession *session : sessionList) {
+        if (session->isActive() && session->serial() == serial && session->packageName() == packageName) {
+            return session;
+        }
+    }
+    return nullptr;
+}
+
+QList<ScrcpySession *> SessionManager::sessions() const
+{
+    return sessionList;
+}
+
+int SessionManager::activeCount() const
+{
+    int count = 0;
+    for (ScrcpySession *session : sessionList) {
+        if (session->isActive()) {
+            ++count;
+        }
+    }
+    return count;
+}
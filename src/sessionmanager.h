@@ -0,0 +1,58 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "scrcpysession.h"
+
+// Owns every scrcpy session the GUI has started.
+//
+// Sessions run side by side (each app gets its own virtual display) and stay
+// listed after they exit so their logs can still be read, until they are
+// removed.
+class SessionManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionManager(QObject *parent = nullptr);
+    ~SessionManager();
+
+    QString program() const;
+    void setProgram(const QString &program);
+    QString adbProgram() const;
+    void setAdbProgram(const QString &program);
+    void setLogLineCap(int lines);
+
+    ScrcpySession *startSession(const QString &serial, const QString &packageName,
+                                const QString &appName, const QStringList &arguments,
+                                const LaunchTrace &trace = LaunchTrace());
+    bool stopSession(int id);
+    void stopAll();
+    // Stops every session and waits for them; only for application exit
+    void shutdown(int timeoutMs = ScrcpySession::STOP_GRACE_MS);
+    bool removeSession(int id);
+    void removeFinished();
+
+    ScrcpySession *session(int id) const;
+    ScrcpySession *findActive(const QString &serial, const QString &packageName) const;
+    QList<ScrcpySession *> sessions() const;
+    int activeCount() const;
+
+signals:
+    void sessionAdded(ScrcpySession *session);
+    void sessionChanged(ScrcpySession *session);
+    void sessionAboutToBeRemoved(ScrcpySession *session);
+    void sessionError(ScrcpySession *session, QProcess::ProcessError error);
+
+private:
+    QString scrcpyProgram;
+    QString adbPath;
+    int logLineCap;
+    int nextId;
+    QList<ScrcpySession *> sessionList;
+};
+
+#endif // SESSIONMANAGER_H
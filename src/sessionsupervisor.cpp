@@ -0,0 +1,360 @@
+#include "sessionsupervisor.h"
+#include "scrcpysession.h"
+#include "sessionmanager.h"
+#include "devicemanager.h"
+#include "logger.h"
+#include <QRandomGenerator>
+#include <QRegularExpression>
+
+namespace {
+
+// scrcpy's exit status when the device went away mid-session
+constexpr int SCRCPY_EXIT_DISCONNECTED = 2;
+
+// scrcpy and adb wording for a device that is gone or not usable
+const char *const deviceLossMessages[] = {
+    "device disconnected",
+    "could not find any adb device",
+    "could not find adb device",
+    "no devices/emulators found",
+    "device offline",
+    "device unauthorized"
+};
+
+bool looksLikeDeviceLoss(const QString &message)
+{
+    QString lower = message.toLower();
+    for (const char *text : deviceLossMessages) {
+        if (lower.contains(QLatin1String(text))) {
+            return true;
+        }
+    }
+    // adb's "error: device 'SERIAL' not found"
+    static const QRegularExpression missingDevice("device '[^']*' not found");
+    return missingDevice.match(lower).hasMatch();
+}
+
+const char *reasonText(Metrics::SessionExitReason reason)
+{
+    switch (reason) {
+    case Metrics::UserClosed: return "closed by the user";
+    case Metrics::DeviceGone: return "device lost";
+    default: return "crash";
+    }
+}
+
+} // namespace
+
+SessionSupervisor::SessionSupervisor(SessionManager *sessions, DeviceManager *devices, QObject *parent)
+    : QObject(parent)
+    , sessions(sessions)
+    , devices(devices)
+    , devicePoll(new QTimer(this))
+{
+    devicePoll->setInterval(DEVICE_POLL_MS);
+    connect(devicePoll, &QTimer::timeout, devices, &DeviceManager::refreshDevices);
+    connect(devices, &DeviceManager::devicesChanged, this, &SessionSupervisor::checkWaiting);
+
+    // Replacements started elsewhere (adaptive quality) stay supervised
+    connect(sessions, &SessionManager::sessionAdded, this, [this](ScrcpySession *session) {
+        auto it = apps.find(keyFor(session->serial(), session->packageName()));
+        if (it != apps.end() && it->session != session) {
+            track(session);
+        }
+    });
+}
+
+QString SessionSupervisor::keyFor(const QString &serial, const QString &packageName)
+{
+    return serial + '/' + packageName;
+}
+
+void SessionSupervisor::supervise(ScrcpySession *session, const Launcher &launcher)
+{
+    QString key = keyFor(session->serial(), session->packageName());
+    if (!apps.contains(key)) {
+        App app;
+        app.serial = session->serial();
+        app.packageName = session->packageName();
+        app.launch = launcher;
+        if (!app.launch) {
+            SessionManager *manager = sessions;
+            QString serial = session->serial();
+            QString packageName = session->packageName();
+            QString appName = session->appName();
+            QStringList arguments = session->arguments();
+            app.launch = [manager, serial, packageName, appName, arguments]() {
+                return manager->startSession(serial, packageName, appName, arguments);
+            };
+        }
+        app.supervisedSince.start();
+        app.retryTimer = new QTimer(this);
+        app.retryTimer->setSingleShot(true);
+        connect(app.retryTimer, &QTimer::timeout, this, [this, key]() { onRetryTimeout(key); });
+        apps.insert(key, app);
+        qCInfo(lcScrcpy) << "Supervising" << app.packageName << "on" << app.serial;
+    }
+    track(session);
+}
+
+bool SessionSupervisor::isSupervised(const QString &serial, const QString &packageName) const
+{
+    return apps.contains(keyFor(serial, packageName));
+}
+
+SessionSupervisor::Stats SessionSupervisor::stats(const QString &serial, const QString &packageName) const
+{
+    auto it = apps.constFind(keyFor(serial, packageName));
+    if (it == apps.constEnd()) {
+        return Stats();
+    }
+    Stats result = it->stats;
+    result.supervisedMs = it->supervisedSince.elapsed();
+    if (it->downSince.isValid()) {
+        result.downtimeMs += it->downSince.elapsed();
+    }
+    return result;
+}
+
+SessionSupervisor::App *SessionSupervisor::appFor(ScrcpySession *session)
+{
+    auto it = apps.find(keyFor(session->serial(), session->packageName()));
+    return (it != apps.end() && it->session == session) ? &it.value() : nullptr;
+}
+
+void SessionSupervisor::track(ScrcpySession *session)
+{
+    App &app = apps[keyFor(session->serial(), session->packageName())];
+    // Both sessionAdded and supervise() see a session the user starts
+    if (app.session == session) {
+        return;
+    }
+    app.session = session;
+    app.appName = session->appName();
+    app.stopRequested = false;
+    app.deviceLost = false;
+    app.upSince.start();
+
+    // Whoever started it, a pending restart is no longer needed
+    if (session->isActive()) {
+        app.retryTimer->stop();
+        app.waitingForDevice = false;
+        updateDevicePoll();
+    }
+
+    connect(session, &ScrcpySession::eventParsed, this, [this, session](const ScrcpyEvent &event) {
+        onSessionEvent(session, event);
+    });
+    connect(session, &ScrcpySession::stateChanged, this, [this, session]() {
+        onSessionStateChanged(session);
+    });
+    connect(session, &ScrcpySession::windowShown, this, [this, session]() {
+        onWindowShown(session);
+    });
+    connect(session, &QObject::destroyed, this, [this, session]() {
+        if (App *app = appFor(session)) {
+            app->session = nullptr;
+        }
+    });
+}
+
+Metrics::SessionExitReason SessionSupervisor::classify(ScrcpySession *session, bool stopRequested, bool deviceLost)
+{
+    if (stopRequested || (session->state() == ScrcpySession::Finished && session->exitCode() == 0)) {
+        return Metrics::UserClosed;
+    }
+    if (deviceLost || session->exitCode() == SCRCPY_EXIT_DISCONNECTED || looksLikeDeviceLoss(session->lastError())) {
+        return Metrics::DeviceGone;
+    }
+    return Metrics::Crashed;
+}
+
+int SessionSupervisor::backoffDelay(int attempt)
+{
+    int base = qMin(MAX_BACKOFF_MS, INITIAL_BACKOFF_MS << qBound(0, attempt, 16));
+    // Jitter keeps several apps on one device from relaunching in lockstep
+    int jitter = base * JITTER_PERCENT / 100;
+    int delay = base - jitter + int(QRandomGenerator::global()->bounded(2 * jitter + 1));
+    return qBound(0, delay, MAX_BACKOFF_MS);
+}
+
+void SessionSupervisor::onSessionEvent(ScrcpySession *session, const ScrcpyEvent &event)
+{
+    if (event.type != ScrcpyEvent::Warning && event.type != ScrcpyEvent::Error) {
+        return;
+    }
+    App *app = appFor(session);
+    if (app && looksLikeDeviceLoss(event.text)) {
+        app->deviceLost = true;
+    }
+}
+
+void SessionSupervisor::onSessionStateChanged(ScrcpySession *session)
+{
+    App *app = appFor(session);
+    if (!app) {
+        return;
+    }
+    if (session->state() == ScrcpySession::Stopping) {
+        app->stopRequested = true;
+        return;
+    }
+    if (session->isActive()) {
+        return;
+    }
+
+    Metrics::SessionExitReason reason = classify(session, app->stopRequested, app->deviceLost);
+    QString key = keyFor(app->serial, app->packageName);
+
+    if (reason == Metrics::UserClosed) {
+        // A stop followed at once by a new session for the app is a relaunch,
+        // not the user closing it
+        QTimer::singleShot(0, this, [this, key]() {
+            auto it = apps.find(key);
+            if (it != apps.end() && !(it->session && it->session->isActive())) {
+                qCInfo(lcScrcpy) << "Stopped supervising" << it->packageName << "on" << it->serial;
+                Metrics::instance()->supervisedExit(Metrics::UserClosed);
+                release(key);
+            }
+        });
+        return;
+    }
+
+    Metrics::instance()->supervisedExit(reason);
+    if (app->upSince.elapsed() >= STABLE_MS) {
+        app->attempt = 0;
+    }
+    if (!app->downSince.isValid()) {
+        app->downSince.start();
+    }
+    app->lastExit = reason;
+
+    int delay = backoffDelay(app->attempt++);
+    qCInfo(lcScrcpy) << "Supervised session" << session->id() << "ended (" << reasonText(reason) << ", exit code"
+                     << session->exitCode() << "), restarting in" << delay << "ms";
+    session->log()->append(QString("Auto-restart: %1, restarting in %2 s")
+                               .arg(QLatin1String(reasonText(reason)))
+                               .arg(delay / 1000.0, 0, 'f', 1),
+                           LogSeverity::Notice);
+
+    // adb may not have noticed yet; ask again rather than trust the last list
+    if (reason == Metrics::DeviceGone) {
+        app->waitingForDevice = true;
+        devices->refreshDevices();
+    }
+    app->retryTimer->start(delay);
+    updateDevicePoll();
+}
+
+void SessionSupervisor::onRetryTimeout(const QString &key)
+{
+    auto it = apps.find(key);
+    if (it == apps.end() || hasActiveSession(it.value())) {
+        return;
+    }
+    if (!it->waitingForDevice && !isDeviceReady(it->serial)) {
+        it->waitingForDevice = true;
+    }
+    if (it->waitingForDevice) {
+        qCInfo(lcScrcpy) << "Waiting for" << (it->serial.isEmpty() ? QString("a device") : it->serial)
+                         << "before restarting" << it->packageName;
+        updateDevicePoll();
+        return;
+    }
+    relaunch(key);
+}
+
+void SessionSupervisor::checkWaiting()
+{
+    for (auto it = apps.begin(); it != apps.end(); ++it) {
+        if (it->waitingForDevice && isDeviceReady(it->serial)) {
+            it->waitingForDevice = false;
+            if (!it->retryTimer->isActive()) {
+                relaunch(it.key());
+            }
+        }
+    }
+    updateDevicePoll();
+}
+
+void SessionSupervisor::updateDevicePoll()
+{
+    bool waiting = false;
+    for (const App &app : std::as_const(apps)) {
+        waiting = waiting || app.waitingForDevice;
+    }
+    if (waiting && !devicePoll->isActive()) {
+        devicePoll->start();
+    } else if (!waiting) {
+        devicePoll->stop();
+    }
+}
+
+bool SessionSupervisor::isDeviceReady(const QString &serial) const
+{
+    if (!serial.isEmpty()) {
+        return devices->device(serial).isReady();
+    }
+    for (const DeviceInfo &device : devices->devices()) {
+        if (device.isReady()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SessionSupervisor::hasActiveSession(const App &app) const
+{
+    return sessions->findActive(app.serial, app.packageName) != nullptr;
+}
+
+void SessionSupervisor::relaunch(const QString &key)
+{
+    auto it = apps.find(key);
+    if (it == apps.end() || hasActiveSession(it.value())) {
+        return;
+    }
+    ScrcpySession *previous = it->session;
+    Launcher launch = it->launch;
+    int restarts = ++it->stats.restarts;
+    Metrics::SessionExitReason lastExit = it->lastExit;
+    Metrics::instance()->supervisorRestarted();
+
+    // Tracked through sessionAdded; apps may rehash, so no references past here
+    ScrcpySession *replacement = launch();
+    replacement->log()->append(QString("Auto-restart #%1 after %2").arg(restarts).arg(QLatin1String(reasonText(lastExit))),
+                               LogSeverity::Notice);
+    emit sessionRestarted(previous, replacement);
+
+    // The replacement takes the finished session's place in the list
+    if (previous) {
+        sessions->removeSession(previous->id());
+    }
+}
+
+void SessionSupervisor::onWindowShown(ScrcpySession *session)
+{
+    App *app = appFor(session);
+    if (!app || !app->downSince.isValid()) {
+        return;
+    }
+
+    qint64 recoveryMs = app->downSince.elapsed();
+    app->downSince.invalidate();
+    app->stats.downtimeMs += recoveryMs;
+    app->stats.lastRecoveryMs = recoveryMs;
+    Metrics::instance()->sessionRecovered(recoveryMs);
+
+    qint64 supervisedMs = qMax<qint64>(1, app->supervisedSince.elapsed());
+    double uptime = 100.0 * double(supervisedMs - app->stats.downtimeMs) / double(supervisedMs);
+    qCInfo(lcScrcpy) << "Recovered" << app->packageName << "on" << app->serial << "in" << recoveryMs << "ms"
+                     << "(restart" << app->stats.restarts << ", up" << QString::number(uptime, 'f', 2) + "%"
+                     << "of the time supervised )";
+}
+
+void SessionSupervisor::release(const QString &key)
+{
+    App app = apps.take(key);
+    delete app.retryTimer;
+    updateDevicePoll();
+}
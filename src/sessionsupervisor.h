@@ -0,0 +1,106 @@
+#ifndef SESSIONSUPERVISOR_H
+#define SESSIONSUPERVISOR_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include "metrics.h"
+
+class ScrcpySession;
+class SessionManager;
+class DeviceManager;
+struct ScrcpyEvent;
+
+// Keeps supervised apps on screen, for kiosk setups (profile option
+// "auto-restart").
+//
+// Every exit of a supervised session is classified from its exit code and
+// stderr. A stop from the GUI or the control socket, or a window the user
+// closed (exit 0), ends supervision. A lost device (exit 2 or an adb/device
+// message) and anything else (a crash) relaunch the same arguments after
+// an exponential backoff with jitter, once the device is listed as ready
+// again. The backoff resets after a session stays up for STABLE_MS.
+//
+// Supervision belongs to the device and app rather than one session, so a
+// relaunch by QualityController stays supervised, and restarts go through
+// the launcher the first session was started with. A session the user
+// starts for the app while a restart is pending replaces that restart.
+class SessionSupervisor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int INITIAL_BACKOFF_MS = 1000;
+    static constexpr int MAX_BACKOFF_MS = 60000;
+    static constexpr int JITTER_PERCENT = 20;
+    static constexpr int STABLE_MS = 60000;
+    static constexpr int DEVICE_POLL_MS = 2000;
+
+    struct Stats {
+        int restarts = 0;
+        qint64 downtimeMs = 0;
+        qint64 lastRecoveryMs = -1;
+        qint64 supervisedMs = 0;
+    };
+
+    // Starts a replacement; returns the new session
+    using Launcher = std::function<ScrcpySession *()>;
+
+    SessionSupervisor(SessionManager *sessions, DeviceManager *devices, QObject *parent = nullptr);
+
+    // Without a launcher, restarts reuse the session's arguments
+    void supervise(ScrcpySession *session, const Launcher &launcher = Launcher());
+    bool isSupervised(const QString &serial, const QString &packageName) const;
+    Stats stats(const QString &serial, const QString &packageName) const;
+
+    static Metrics::SessionExitReason classify(ScrcpySession *session, bool stopRequested, bool deviceLost);
+    static int backoffDelay(int attempt);
+
+signals:
+    void sessionRestarted(ScrcpySession *previous, ScrcpySession *replacement);
+
+private:
+    struct App {
+        QString serial;
+        QString packageName;
+        QString appName;
+        Launcher launch;
+
+        ScrcpySession *session = nullptr;
+        bool stopRequested = false;
+        bool deviceLost = false;
+        int attempt = 0;
+        QElapsedTimer upSince;        // current session started
+        QElapsedTimer downSince;      // invalid while the app is up
+        bool waitingForDevice = false;
+        Metrics::SessionExitReason lastExit = Metrics::Crashed;
+        QTimer *retryTimer = nullptr;
+
+        Stats stats;
+        QElapsedTimer supervisedSince;
+    };
+
+    static QString keyFor(const QString &serial, const QString &packageName);
+    void track(ScrcpySession *session);
+    void onSessionEvent(ScrcpySession *session, const ScrcpyEvent &event);
+    void onSessionStateChanged(ScrcpySession *session);
+    void onWindowShown(ScrcpySession *session);
+    App *appFor(ScrcpySession *session);
+    void onRetryTimeout(const QString &key);
+    bool hasActiveSession(const App &app) const;
+    void relaunch(const QString &key);
+    void checkWaiting();
+    void updateDevicePoll();
+    bool isDeviceReady(const QString &serial) const;
+    void release(const QString &key);
+
+    SessionManager *sessions;
+    DeviceManager *devices;
+    QHash<QString, App> apps;
+    QTimer *devicePoll;
+};
+
+#endif // SESSIONSUPERVISOR_H
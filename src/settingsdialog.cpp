@@ -1,8 +1,34 @@
 #include "settingsdialog.h"
+#include "logmodel.h"
+#include "devicemanager.h"
+#include "metricsserver.h"
+#include "profilestore.h"
 #include <QLabel>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QSignalBlocker>
 #include <QFormLayout>
 #include <QGroupBox>
 
+namespace {
+
+// Index 0 of the option combos is "Default (...)", stored as empty
+void setComboValue(QComboBox *combo, const QString &value)
+{
+    if (value.isEmpty()) {
+        combo->setCurrentIndex(0);
+    } else {
+        combo->setCurrentText(value);
+    }
+}
+
+QString comboValue(const QComboBox *combo)
+{
+    return combo->currentIndex() == 0 ? QString() : combo->currentText();
+}
+
+} // namespace
+
 SettingsDialog::SettingsDialog(QWidget *parent)
     : QDialog(parent)
 {
@@ -16,6 +42,21 @@ void SettingsDialog::setupUI()
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     tabWidget = new QTabWidget(this);
 
+    // Launch options below belong to the selected profile
+    QHBoxLayout *profileLayout = new QHBoxLayout();
+    profileLayout->addWidget(new QLabel("Profile:"));
+    profileCombo = new QComboBox();
+    profileCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    profileLayout->addWidget(profileCombo);
+    QPushButton *saveProfileAsButton = new QPushButton("Save As...");
+    profileLayout->addWidget(saveProfileAsButton);
+    deleteProfileButton = new QPushButton("Delete");
+    profileLayout->addWidget(deleteProfileButton);
+    profileLayout->addStretch();
+    connect(profileCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsDialog::onProfileChanged);
+    connect(saveProfileAsButton, &QPushButton::clicked, this, &SettingsDialog::onSaveProfileAs);
+    connect(deleteProfileButton, &QPushButton::clicked, this, &SettingsDialog::onDeleteProfile);
+
     // --- General Tab ---
     QWidget *generalTab = new QWidget();
     QVBoxLayout *generalLayout = new QVBoxLayout(generalTab);
@@ -27,6 +68,7 @@ void SettingsDialog::setupUI()
     noVdDestroyContentCheck = new QCheckBox("No virtual display content destruction (--no-vd-destroy-content)");
     showTouchesCheck = new QCheckBox("Show touches (--show-touches)");
     disableScreensaverCheck = new QCheckBox("Disable screensaver (--disable-screensaver)");
+    autoRestartCheck = new QCheckBox("Restart automatically after a crash or disconnect (kiosk)");
 
     generalLayout->addWidget(alwaysOnTopCheck);
     generalLayout->addWidget(noControlCheck);
@@ -35,6 +77,7 @@ void SettingsDialog::setupUI()
     generalLayout->addWidget(noVdDestroyContentCheck);
     generalLayout->addWidget(showTouchesCheck);
     generalLayout->addWidget(disableScreensaverCheck);
+    generalLayout->addWidget(autoRestartCheck);
     generalLayout->addStretch();
     tabWidget->addTab(generalTab, "General");
 
@@ -62,6 +105,10 @@ void SettingsDialog::setupUI()
     rotationCombo->addItems({"0", "1 (-90)", "2 (180)", "3 (90)"});
 
     noMipmapsCheck = new QCheckBox("Disable mipmaps (--no-mipmaps)");
+    adaptiveQualityCheck = new QCheckBox("Lower bit rate, FPS and size when frames are dropped");
+    adaptiveQualityCheck->setToolTip("Runs scrcpy with --print-fps and relaunches it at a lower "
+                                     "quality when frames are skipped; the level that works is "
+                                     "remembered per device and app");
 
     videoLayout->addRow("Max Size:", maxSizeSpin);
     videoLayout->addRow("Bit Rate:", bitRateCombo);
@@ -69,6 +116,7 @@ void SettingsDialog::setupUI()
     videoLayout->addRow("Video Codec:", videoCodecCombo);
     videoLayout->addRow("Rotation:", rotationCombo);
     videoLayout->addRow("", noMipmapsCheck);
+    videoLayout->addRow("", adaptiveQualityCheck);
     tabWidget->addTab(videoTab, "Video");
 
     // --- Audio Tab ---
@@ -111,11 +159,53 @@ void SettingsDialog::setupUI()
     QWidget *advancedTab = new QWidget();
     QVBoxLayout *advancedLayout = new QVBoxLayout(advancedTab);
 
-    advancedLayout->addWidget(new QLabel("Custom Arguments (space separated):"));
+    advancedLayout->addWidget(new QLabel("Custom Arguments (shell quoting supported):"));
     customArgsEdit = new QLineEdit();
     customArgsEdit->setPlaceholderText("e.g. --render-driver=opengl");
     advancedLayout->addWidget(customArgsEdit);
+
+    QHBoxLayout *logLayout = new QHBoxLayout();
+    logLayout->addWidget(new QLabel("Log pane line limit:"));
+    logLineCapSpin = new QSpinBox();
+    logLineCapSpin->setRange(100, 1000000);
+    logLineCapSpin->setSingleStep(1000);
+    logLineCapSpin->setSuffix(" lines");
+    logLayout->addWidget(logLineCapSpin);
+    advancedLayout->addLayout(logLayout);
+
+    // Read at startup; SCRCPY_GUI_ADB / SCRCPY_GUI_SCRCPY override them
+    QFormLayout *toolsLayout = new QFormLayout();
+    adbPathEdit = new QLineEdit();
+    adbPathEdit->setPlaceholderText("adb on PATH");
+    toolsLayout->addRow("adb program (restart to apply):", adbPathEdit);
+    scrcpyPathEdit = new QLineEdit();
+    scrcpyPathEdit->setPlaceholderText("scrcpy on PATH");
+    toolsLayout->addRow("scrcpy program (restart to apply):", scrcpyPathEdit);
+    advancedLayout->addLayout(toolsLayout);
+
+    adbUseServerCheck = new QCheckBox("Talk to the adb server directly instead of running adb");
+    advancedLayout->addWidget(adbUseServerCheck);
+
+    QHBoxLayout *parallelLayout = new QHBoxLayout();
+    parallelLayout->addWidget(new QLabel("Devices refreshed in parallel:"));
+    adbMaxParallelSpin = new QSpinBox();
+    adbMaxParallelSpin->setRange(1, 64);
+    parallelLayout->addWidget(adbMaxParallelSpin);
+    advancedLayout->addLayout(parallelLayout);
+
+    replaceSessionCheck = new QCheckBox("Close the previous app's window when launching another");
+    advancedLayout->addWidget(replaceSessionCheck);
+
+    QHBoxLayout *metricsLayout = new QHBoxLayout();
+    metricsEnabledCheck = new QCheckBox("Serve Prometheus metrics on 127.0.0.1, port");
+    metricsLayout->addWidget(metricsEnabledCheck);
+    metricsPortSpin = new QSpinBox();
+    metricsPortSpin->setRange(1024, 65535);
+    metricsLayout->addWidget(metricsPortSpin);
+    metricsLayout->addStretch();
+    advancedLayout->addLayout(metricsLayout);
     advancedLayout->addStretch();
+
     tabWidget->addTab(advancedTab, "Advanced");
 
     // Buttons
@@ -124,6 +214,7 @@ void SettingsDialog::setupUI()
     connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
     connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
 
+    mainLayout->addLayout(profileLayout);
     mainLayout->addWidget(tabWidget);
     mainLayout->addWidget(buttonBox);
 }
@@ -132,68 +223,186 @@ void SettingsDialog::loadSettings()
 {
     QSettings settings("ScrcpyGUI", "Settings");
 
-    // General
-    alwaysOnTopCheck->setChecked(settings.value("always-on-top", false).toBool());
-    noControlCheck->setChecked(settings.value("no-control", false).toBool());
-    stayAwakeCheck->setChecked(settings.value("stay-awake", false).toBool());
-    turnScreenOffCheck->setChecked(settings.value("turn-screen-off", false).toBool());
-    noVdDestroyContentCheck->setChecked(settings.value("no-vd-destroy-content", false).toBool());
-    showTouchesCheck->setChecked(settings.value("show-touches", false).toBool());
-    disableScreensaverCheck->setChecked(settings.value("disable-screensaver", false).toBool());
-
-    // Video
-    maxSizeSpin->setValue(settings.value("max-size", 0).toInt());
-    bitRateCombo->setCurrentText(settings.value("bit-rate", "Default (8M)").toString());
-    maxFpsSpin->setValue(settings.value("max-fps", 0).toInt());
-    videoCodecCombo->setCurrentText(settings.value("video-codec", "Default (h264)").toString());
-    rotationCombo->setCurrentIndex(settings.value("rotation", 0).toInt());
-    noMipmapsCheck->setChecked(settings.value("no-mipmaps", false).toBool());
-
-    // Audio
-    noAudioCheck->setChecked(settings.value("no-audio", false).toBool());
-    audioCodecCombo->setCurrentText(settings.value("audio-codec", "Default (opus)").toString());
-    audioBitRateCombo->setCurrentText(settings.value("audio-bit-rate", "Default (128K)").toString());
-
-    // Window
-    fullscreenCheck->setChecked(settings.value("fullscreen", false).toBool());
-    borderlessCheck->setChecked(settings.value("window-borderless", false).toBool());
-    windowTitleEdit->setText(settings.value("window-title", "").toString());
+    // Launch profiles
+    ProfileStore *store = ProfileStore::instance();
+    editedProfiles.insert(QString(), store->profile(QString()));
+    {
+        QSignalBlocker blocker(profileCombo);
+        profileCombo->addItem("Default", QString());
+        for (const QString &name : store->profileNames()) {
+            editedProfiles.insert(name, store->profile(name));
+            profileCombo->addItem(name, name);
+        }
+    }
+    showProfile(editedProfiles.value(QString()));
+    deleteProfileButton->setEnabled(false);
+
+    adaptiveQualityCheck->setChecked(settings.value("adaptive-quality", false).toBool());
 
     // Advanced
-    customArgsEdit->setText(settings.value("custom-args", "").toString());
+    logLineCapSpin->setValue(settings.value("log-line-cap", LogModel::DEFAULT_LINE_CAP).toInt());
+    adbPathEdit->setText(settings.value("adb-path").toString());
+    scrcpyPathEdit->setText(settings.value("scrcpy-path").toString());
+    adbUseServerCheck->setChecked(settings.value("adb-use-server", true).toBool());
+    adbMaxParallelSpin->setValue(settings.value("adb-max-parallel", DeviceManager::DEFAULT_MAX_PARALLEL).toInt());
+    replaceSessionCheck->setChecked(settings.value("replace-session", false).toBool());
+    metricsEnabledCheck->setChecked(settings.value("metrics-enabled", false).toBool());
+    metricsPortSpin->setValue(settings.value("metrics-port", MetricsServer::DEFAULT_PORT).toInt());
 }
 
 void SettingsDialog::saveSettings()
 {
     QSettings settings("ScrcpyGUI", "Settings");
 
+    // Launch profiles; the store recompiles them on next use
+    ProfileStore *store = ProfileStore::instance();
+    editedProfiles.insert(currentProfile, profileFromWidgets());
+    for (const QString &name : std::as_const(removedProfiles)) {
+        store->removeProfile(name);
+    }
+    for (const ScrcpyProfile &profile : std::as_const(editedProfiles)) {
+        store->saveProfile(profile);
+    }
+    store->invalidate();
+
+    settings.setValue("adaptive-quality", adaptiveQualityCheck->isChecked());
+
+    // Advanced
+    settings.setValue("log-line-cap", logLineCapSpin->value());
+    settings.setValue("adb-path", adbPathEdit->text().trimmed());
+    settings.setValue("scrcpy-path", scrcpyPathEdit->text().trimmed());
+    settings.setValue("adb-use-server", adbUseServerCheck->isChecked());
+    settings.setValue("adb-max-parallel", adbMaxParallelSpin->value());
+    settings.setValue("replace-session", replaceSessionCheck->isChecked());
+    settings.setValue("metrics-enabled", metricsEnabledCheck->isChecked());
+    settings.setValue("metrics-port", metricsPortSpin->value());
+}
+
+void SettingsDialog::showProfile(const ScrcpyProfile &profile)
+{
     // General
-    settings.setValue("always-on-top", alwaysOnTopCheck->isChecked());
-    settings.setValue("no-control", noControlCheck->isChecked());
-    settings.setValue("stay-awake", stayAwakeCheck->isChecked());
-    settings.setValue("turn-screen-off", turnScreenOffCheck->isChecked());
-    settings.setValue("no-vd-destroy-content", noVdDestroyContentCheck->isChecked());
-    settings.setValue("show-touches", showTouchesCheck->isChecked());
-    settings.setValue("disable-screensaver", disableScreensaverCheck->isChecked());
+    alwaysOnTopCheck->setChecked(profile.alwaysOnTop);
+    noControlCheck->setChecked(profile.noControl);
+    stayAwakeCheck->setChecked(profile.stayAwake);
+    turnScreenOffCheck->setChecked(profile.turnScreenOff);
+    noVdDestroyContentCheck->setChecked(profile.noVdDestroyContent);
+    showTouchesCheck->setChecked(profile.showTouches);
+    disableScreensaverCheck->setChecked(profile.disableScreensaver);
+    autoRestartCheck->setChecked(profile.autoRestart);
 
     // Video
-    settings.setValue("max-size", maxSizeSpin->value());
-    settings.setValue("bit-rate", bitRateCombo->currentText());
-    settings.setValue("max-fps", maxFpsSpin->value());
-    settings.setValue("video-codec", videoCodecCombo->currentText());
-    settings.setValue("rotation", rotationCombo->currentIndex());
-    settings.setValue("no-mipmaps", noMipmapsCheck->isChecked());
+    maxSizeSpin->setValue(profile.maxSize);
+    setComboValue(bitRateCombo, profile.bitRate);
+    maxFpsSpin->setValue(profile.maxFps);
+    setComboValue(videoCodecCombo, profile.videoCodec);
+    rotationCombo->setCurrentIndex(profile.rotation);
+    noMipmapsCheck->setChecked(profile.noMipmaps);
 
     // Audio
-    settings.setValue("no-audio", noAudioCheck->isChecked());
-    settings.setValue("audio-codec", audioCodecCombo->currentText());
-    settings.setValue("audio-bit-rate", audioBitRateCombo->currentText());
+    noAudioCheck->setChecked(profile.noAudio);
+    setComboValue(audioCodecCombo, profile.audioCodec);
+    setComboValue(audioBitRateCombo, profile.audioBitRate);
 
     // Window
-    settings.setValue("fullscreen", fullscreenCheck->isChecked());
-    settings.setValue("window-borderless", borderlessCheck->isChecked());
-    settings.setValue("window-title", windowTitleEdit->text());
+    fullscreenCheck->setChecked(profile.fullscreen);
+    borderlessCheck->setChecked(profile.borderless);
+    windowTitleEdit->setText(profile.windowTitle);
 
-    // Advanced
-    settings.setValue("custom-args", customArgsEdit->text());
+    customArgsEdit->setText(profile.customArgs);
+}
+
+ScrcpyProfile SettingsDialog::profileFromWidgets() const
+{
+    ScrcpyProfile profile;
+    profile.name = currentProfile;
+
+    profile.alwaysOnTop = alwaysOnTopCheck->isChecked();
+    profile.noControl = noControlCheck->isChecked();
+    profile.stayAwake = stayAwakeCheck->isChecked();
+    profile.turnScreenOff = turnScreenOffCheck->isChecked();
+    profile.noVdDestroyContent = noVdDestroyContentCheck->isChecked();
+    profile.showTouches = showTouchesCheck->isChecked();
+    profile.disableScreensaver = disableScreensaverCheck->isChecked();
+    profile.autoRestart = autoRestartCheck->isChecked();
+
+    profile.maxSize = maxSizeSpin->value();
+    profile.bitRate = comboValue(bitRateCombo);
+    profile.maxFps = maxFpsSpin->value();
+    profile.videoCodec = comboValue(videoCodecCombo);
+    profile.rotation = rotationCombo->currentIndex();
+    profile.noMipmaps = noMipmapsCheck->isChecked();
+
+    profile.noAudio = noAudioCheck->isChecked();
+    profile.audioCodec = comboValue(audioCodecCombo);
+    profile.audioBitRate = comboValue(audioBitRateCombo);
+
+    profile.fullscreen = fullscreenCheck->isChecked();
+    profile.borderless = borderlessCheck->isChecked();
+    profile.windowTitle = windowTitleEdit->text();
+
+    profile.customArgs = customArgsEdit->text();
+    return profile;
+}
+
+void SettingsDialog::onProfileChanged(int index)
+{
+    // Keep the edits of the profile being left
+    editedProfiles.insert(currentProfile, profileFromWidgets());
+
+    currentProfile = profileCombo->itemData(index).toString();
+    showProfile(editedProfiles.value(currentProfile));
+    deleteProfileButton->setEnabled(!currentProfile.isEmpty());
+}
+
+void SettingsDialog::onSaveProfileAs()
+{
+    bool ok = false;
+    QString name = QInputDialog::getText(this, "Save Profile", "Profile name:",
+                                         QLineEdit::Normal, currentProfile, &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+    if (name.contains('/') || name.contains('\\') || name.compare("Default", Qt::CaseInsensitive) == 0) {
+        QMessageBox::warning(this, "Save Profile", "Profile names can't contain slashes or be \"Default\".");
+        return;
+    }
+
+    ScrcpyProfile profile = profileFromWidgets();
+    profile.name = name;
+    editedProfiles.insert(name, profile);
+    removedProfiles.removeAll(name);
+
+    int index = profileCombo->findData(name);
+    if (index < 0) {
+        profileCombo->addItem(name, name);
+        index = profileCombo->count() - 1;
+    }
+    // The profile being left keeps its own stored values
+    {
+        QSignalBlocker blocker(profileCombo);
+        profileCombo->setCurrentIndex(index);
+    }
+    currentProfile = name;
+    deleteProfileButton->setEnabled(true);
+}
+
+void SettingsDialog::onDeleteProfile()
+{
+    if (currentProfile.isEmpty()) {
+        return;
+    }
+
+    QString name = currentProfile;
+    editedProfiles.remove(name);
+    removedProfiles.append(name);
+
+    int index = profileCombo->findData(name);
+    {
+        QSignalBlocker blocker(profileCombo);
+        profileCombo->removeItem(index);
+        profileCombo->setCurrentIndex(0);
+    }
+    currentProfile.clear();
+    showProfile(editedProfiles.value(QString()));
+    deleteProfileButton->setEnabled(false);
 }
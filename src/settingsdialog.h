@@ -10,6 +10,9 @@
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
 #include <QSettings>
+#include <QPushButton>
+#include <QHash>
+#include "scrcpyprofile.h"
 
 class SettingsDialog : public QDialog
 {
@@ -19,11 +22,25 @@ public:
     explicit SettingsDialog(QWidget *parent = nullptr);
     void saveSettings();
 
+private slots:
+    void onProfileChanged(int index);
+    void onSaveProfileAs();
+    void onDeleteProfile();
+
 private:
     void setupUI();
     void loadSettings();
+    void showProfile(const ScrcpyProfile &profile);
+    ScrcpyProfile profileFromWidgets() const;
 
     QTabWidget *tabWidget;
+
+    // Launch profiles; edits are kept per profile until OK
+    QComboBox *profileCombo;
+    QPushButton *deleteProfileButton;
+    QString currentProfile;
+    QHash<QString, ScrcpyProfile> editedProfiles;
+    QStringList removedProfiles;
     
     // General
     QCheckBox *alwaysOnTopCheck;
@@ -33,6 +50,7 @@ private:
     QCheckBox *noVdDestroyContentCheck;
     QCheckBox *showTouchesCheck;
     QCheckBox *disableScreensaverCheck;
+    QCheckBox *autoRestartCheck;
 
     // Video
     QSpinBox *maxSizeSpin;
@@ -41,6 +59,7 @@ private:
     QComboBox *videoCodecCombo;
     QComboBox *rotationCombo;
     QCheckBox *noMipmapsCheck;
+    QCheckBox *adaptiveQualityCheck;
 
     // Audio
     QCheckBox *noAudioCheck;
@@ -54,6 +73,14 @@ private:
 
     // Advanced
     QLineEdit *customArgsEdit;
+    QSpinBox *logLineCapSpin;
+    QLineEdit *adbPathEdit;
+    QLineEdit *scrcpyPathEdit;
+    QCheckBox *adbUseServerCheck;
+    QSpinBox *adbMaxParallelSpin;
+    QCheckBox *replaceSessionCheck;
+    QCheckBox *metricsEnabledCheck;
+    QSpinBox *metricsPortSpin;
 };
 
 #endif // SETTINGSDIALOG_H
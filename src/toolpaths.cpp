@@ -0,0 +1,43 @@
+#include "toolpaths.h"
+#include <QSettings>
+#include "adbclient.h"
+
+namespace {
+
+QString toolPath(const char *variable, const char *key, const char *fallback)
+{
+    QString path = qEnvironmentVariable(variable);
+    if (!path.isEmpty()) {
+        return path;
+    }
+    QSettings settings("ScrcpyGUI", "Settings");
+    path = settings.value(key).toString().trimmed();
+    return path.isEmpty() ? QString(fallback) : path;
+}
+
+} // namespace
+
+QString ToolPaths::adb()
+{
+    return toolPath("SCRCPY_GUI_ADB", "adb-path", "adb");
+}
+
+QString ToolPaths::scrcpy()
+{
+    return toolPath("SCRCPY_GUI_SCRCPY", "scrcpy-path", "scrcpy");
+}
+
+quint16 ToolPaths::adbServerPort()
+{
+    int port = qEnvironmentVariableIntValue("ANDROID_ADB_SERVER_PORT");
+    return port > 0 && port <= 65535 ? quint16(port) : AdbClient::DEFAULT_PORT;
+}
+
+bool ToolPaths::adbServerEnabled()
+{
+    if (qEnvironmentVariableIsSet("SCRCPY_GUI_ADB") && !qEnvironmentVariableIsSet("ANDROID_ADB_SERVER_PORT")) {
+        return false;
+    }
+    QSettings settings("ScrcpyGUI", "Settings");
+    return settings.value("adb-use-server", true).toBool();
+}
@@ -0,0 +1,25 @@
+#ifndef TOOLPATHS_H
+#define TOOLPATHS_H
+
+#include <QString>
+
+// Where adb and scrcpy are taken from.
+//
+// SCRCPY_GUI_ADB / SCRCPY_GUI_SCRCPY in the environment win, then the
+// "adb-path" / "scrcpy-path" settings, then the bare names looked up on
+// PATH. The environment variables are how CI points the app at the
+// fake-adb / fake-scrcpy stand-ins in tools/fakedevice.
+class ToolPaths
+{
+public:
+    static QString adb();
+    static QString scrcpy();
+
+    // ANDROID_ADB_SERVER_PORT, as adb itself reads it, else 5037
+    static quint16 adbServerPort();
+    // An adb from the environment is run as a process unless
+    // ANDROID_ADB_SERVER_PORT names a server for it (fake-adb nodaemon server)
+    static bool adbServerEnabled();
+};
+
+#endif // TOOLPATHS_H
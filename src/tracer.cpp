@@ -0,0 +1,157 @@
+#include "tracer.h"
+#include "logger.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// Written by its own thread only; the mutex is uncontended except while
+// the trace is being dumped
+struct ThreadBuffer {
+    int tid = 0;
+    QString name;
+    QMutex mutex;
+    QList<TraceEvent> events;
+    qint64 dropped = 0;
+};
+
+QMutex registryMutex;
+QList<ThreadBuffer *> registry;
+QThread *mainThread = nullptr;
+
+ThreadBuffer *currentBuffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer) {
+        return buffer;
+    }
+
+    buffer = new ThreadBuffer;
+    QThread *thread = QThread::currentThread();
+    QMutexLocker locker(&registryMutex);
+    buffer->tid = registry.size() + 1;
+    if (thread == mainThread) {
+        buffer->name = "main";
+    } else if (!thread->objectName().isEmpty()) {
+        buffer->name = thread->objectName();
+    } else {
+        buffer->name = QString("thread %1").arg(buffer->tid);
+    }
+    buffer->events.reserve(4096);
+    registry.append(buffer);
+    return buffer;
+}
+
+void appendNumber(QByteArray &out, qint64 ns)
+{
+    // Chrome wants microseconds; keep sub-microsecond spans visible
+    out += QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled { false };
+
+Tracer *Tracer::instance()
+{
+    static Tracer tracer;
+    return &tracer;
+}
+
+void Tracer::enable()
+{
+    mainThread = QThread::currentThread();
+    clock.start();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+qint64 Tracer::nowNs()
+{
+    return instance()->clock.nsecsElapsed();
+}
+
+void Tracer::record(const char *name, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= MAX_EVENTS_PER_THREAD) {
+        buffer->dropped++;
+        return;
+    }
+    buffer->events.append({ name, startNs, endNs - startNs });
+}
+
+bool Tracer::writeChromeTrace(const QString &path)
+{
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1024 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    qint64 total = 0;
+    qint64 dropped = 0;
+    bool first = true;
+    QMutexLocker registryLocker(&registryMutex);
+    for (ThreadBuffer *buffer : std::as_const(registry)) {
+        QMutexLocker locker(&buffer->mutex);
+        QByteArray tid = QByteArray::number(buffer->tid);
+
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":\"" + buffer->name.toUtf8() + "\"}}";
+
+        for (const TraceEvent &event : std::as_const(buffer->events)) {
+            out += ",\n{\"name\":\"";
+            out += event.name;
+            out += "\",\"cat\":\"scrcpygui\",\"ph\":\"X\",\"ts\":";
+            appendNumber(out, event.startNs);
+            out += ",\"dur\":";
+            appendNumber(out, event.durationNs);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid + "}";
+        }
+        total += buffer->events.size();
+        dropped += buffer->dropped;
+    }
+    out += "\n]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcApp) << "Failed to write trace to" << path << ":" << file.errorString();
+        return false;
+    }
+    file.write(out);
+    if (!file.commit()) {
+        qCWarning(lcApp) << "Failed to write trace to" << path << ":" << file.errorString();
+        return false;
+    }
+
+    qCInfo(lcApp) << "Wrote" << total << "trace events from" << registry.size() << "threads to" << path
+                  << (dropped > 0 ? QString("(%1 dropped)").arg(dropped) : QString());
+    return true;
+}
+
+QString Tracer::pathFromArguments(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--trace=", 8) == 0) {
+            return QString::fromLocal8Bit(argv[i] + 8);
+        }
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            return QString::fromLocal8Bit(argv[i + 1]);
+        }
+    }
+    return QString();
+}
@@ -0,0 +1,73 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QElapsedTimer>
+#include <atomic>
+
+// Scoped spans in Chrome trace-event format, enabled with --trace=FILE.
+//
+//   void AppManager::onAdbFinished(...)
+//   {
+//       TRACE_SPAN("AppManager::onAdbFinished");
+//
+// Disabled, a span costs one relaxed atomic load. Enabled, each thread
+// appends complete ("X") events to its own buffer; buffers live until exit,
+// when writeChromeTrace() dumps all of them for chrome://tracing or Perfetto.
+// Names must be string literals.
+class Tracer
+{
+public:
+    // Events kept per thread; later ones are counted and dropped
+    static constexpr int MAX_EVENTS_PER_THREAD = 500000;
+
+    static Tracer *instance();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Call from the main thread, before the spans of interest
+    void enable();
+    static qint64 nowNs();
+    void record(const char *name, qint64 startNs, qint64 endNs);
+
+    bool writeChromeTrace(const QString &path);
+
+    // "--trace=FILE" or "--trace FILE"; empty if not given
+    static QString pathFromArguments(int argc, char *argv[]);
+
+private:
+    Tracer() = default;
+
+    static std::atomic<bool> enabled;
+    QElapsedTimer clock;
+};
+
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name)
+        : spanName(Tracer::isEnabled() ? name : nullptr)
+        , startNs(spanName ? Tracer::nowNs() : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (spanName) {
+            Tracer::instance()->record(spanName, startNs, Tracer::nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *spanName;
+    qint64 startNs;
+};
+
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT_(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_SPAN_CONCAT(traceSpan_, __LINE__)(name)
+
+#endif // TRACER_H
@@ -0,0 +1,296 @@
+// fake-adb: answers the adb command lines scrcpy-gui runs in its process
+// fallback from a Scenario, or records them from the real adb. As a server
+// it answers AdbClient's smart-socket requests instead (FakeAdbServer).
+//
+//   fake-adb [-s SERIAL] devices [-l]
+//   fake-adb [-s SERIAL] shell sh          (AdbShellSession)
+//   fake-adb [-s SERIAL] shell|exec-out CMD
+//   fake-adb [-P PORT] nodaemon server     (until killed)
+
+#include "scenario.h"
+#include "fakeadbserver.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QProcess>
+#include <QThread>
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace {
+
+struct Recording {
+    QList<Scenario::Reply> replies;
+    QList<QByteArray> commands;
+    QByteArray devices;
+};
+
+QString realAdb()
+{
+    QString program = qEnvironmentVariable("SCRCPY_GUI_REAL_ADB");
+    return program.isEmpty() ? QString("adb") : program;
+}
+
+void writeOut(const QByteArray &data)
+{
+    std::fwrite(data.constData(), 1, size_t(data.size()), stdout);
+    std::fflush(stdout);
+}
+
+void writeErr(const QByteArray &data)
+{
+    std::fwrite(data.constData(), 1, size_t(data.size()), stderr);
+}
+
+// Other stand-ins may have recorded into the same file since we started
+void saveRecording(const Recording &recording)
+{
+    bool saved = Scenario::updateRecording([&recording](Scenario &scenario) {
+        if (!recording.devices.isEmpty()) {
+            scenario.recordDevices(recording.devices);
+        }
+        for (int i = 0; i < recording.commands.size(); ++i) {
+            const Scenario::Reply &reply = recording.replies.at(i);
+            scenario.recordResponse(recording.commands.at(i), reply.output, reply.exitCode, reply.delayMs);
+        }
+    });
+    if (!saved) {
+        writeErr("fake-adb: cannot write " + Scenario::recordPath().toLocal8Bit() + "\n");
+    }
+}
+
+QStringList realArguments(const QString &serial, const QStringList &arguments)
+{
+    QStringList result;
+    if (!serial.isEmpty()) {
+        result << "-s" << serial;
+    }
+    return result + arguments;
+}
+
+int runReal(const QString &serial, const QStringList &arguments, QByteArray *output, int *elapsedMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(realAdb(), realArguments(serial, arguments));
+    if (!process.waitForFinished(-1)) {
+        writeErr("fake-adb: cannot run " + realAdb().toLocal8Bit() + "\n");
+        return 1;
+    }
+    *output = process.readAll();
+    *elapsedMs = int(timer.elapsed());
+    return process.exitCode();
+}
+
+// Reads stdin until AdbShellSession has written one whole command
+bool readShellCommand(QFile &in, QByteArray &buffer, Scenario::ShellCommand *result)
+{
+    while (!Scenario::takeShellCommand(buffer, result)) {
+        QByteArray line = in.readLine();
+        if (line.isEmpty()) {
+            return false;
+        }
+        buffer += line;
+    }
+    return true;
+}
+
+int replayShell(Scenario &scenario, const QString &serial)
+{
+    QFile in;
+    in.open(stdin, QIODevice::ReadOnly);
+    QByteArray input;
+    Scenario::ShellCommand shell;
+    while (readShellCommand(in, input, &shell)) {
+        Scenario::Reply reply = scenario.reply(serial, shell.command);
+        QThread::msleep(ulong(reply.delayMs));
+        if (reply.disconnect) {
+            writeErr("error: closed\n");
+            return 1;
+        }
+        writeOut(reply.output + "\n" + shell.marker + " " + shell.id + " "
+                 + QByteArray::number(reply.exitCode) + "\n");
+    }
+    return 0;
+}
+
+int recordShell(const QString &serial, Recording &recording)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(realAdb(), realArguments(serial, QStringList() << "shell" << "sh"));
+    if (!process.waitForStarted(-1)) {
+        writeErr("fake-adb: cannot run " + realAdb().toLocal8Bit() + "\n");
+        return 1;
+    }
+
+    QFile in;
+    in.open(stdin, QIODevice::ReadOnly);
+    QByteArray input;
+    Scenario::ShellCommand shell;
+    QByteArray buffer;
+    // Commands are passed on one at a time so each can be timed
+    while (readShellCommand(in, input, &shell)) {
+        QElapsedTimer timer;
+        timer.start();
+        process.write("{ " + shell.command + "\n} </dev/null 2>&1; printf '\\n" + shell.marker
+                      + " %d %d\\n' " + shell.id + " $?\n");
+
+        const QByteArray needle = "\n" + shell.marker + " " + shell.id + " ";
+        int pos;
+        while ((pos = buffer.indexOf(needle)) < 0 || buffer.indexOf('\n', pos + needle.size()) < 0) {
+            if (!process.waitForReadyRead(-1)) {
+                writeOut(buffer);
+                saveRecording(recording);
+                return 1;
+            }
+            buffer += process.readAll();
+        }
+        int lineEnd = buffer.indexOf('\n', pos + needle.size());
+
+        Scenario::Reply reply;
+        reply.output = buffer.left(pos);
+        reply.exitCode = buffer.mid(pos + needle.size(), lineEnd - pos - needle.size()).trimmed().toInt();
+        reply.delayMs = int(timer.elapsed());
+        recording.commands.append(shell.command);
+        recording.replies.append(reply);
+
+        writeOut(buffer.left(lineEnd + 1));
+        buffer.remove(0, lineEnd + 1);
+    }
+
+    process.closeWriteChannel();
+    process.waitForFinished();
+    saveRecording(recording);
+    return 0;
+}
+
+int runServer(QCoreApplication &app, quint16 port)
+{
+    Scenario scenario;
+    QString error;
+    if (!scenario.load(Scenario::scenarioPath(), &error)) {
+        writeErr("fake-adb: " + Scenario::scenarioPath().toLocal8Bit() + ": " + error.toLocal8Bit() + "\n");
+        return 1;
+    }
+
+    FakeAdbServer server(scenario);
+    if (!server.listen(port)) {
+        writeErr("fake-adb: cannot listen on port " + QByteArray::number(port) + ": "
+                 + server.errorString().toLocal8Bit() + "\n");
+        return 1;
+    }
+    writeOut("fake-adb: listening on 127.0.0.1:" + QByteArray::number(server.port()) + "\n");
+    return app.exec();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList arguments = app.arguments().mid(1);
+    QString serial;
+    // Same default as adb: ANDROID_ADB_SERVER_PORT, else 5037
+    quint16 port = quint16(qEnvironmentVariableIntValue("ANDROID_ADB_SERVER_PORT"));
+    if (port == 0) {
+        port = 5037;
+    }
+    while (arguments.size() >= 2 && (arguments.first() == "-s" || arguments.first() == "-P")) {
+        if (arguments.first() == "-s") {
+            serial = arguments.at(1);
+        } else {
+            port = arguments.at(1).toUShort();
+        }
+        arguments = arguments.mid(2);
+    }
+    if (arguments.isEmpty()) {
+        writeErr("usage: fake-adb [-s SERIAL] devices [-l] | shell [CMD] | exec-out CMD\n"
+                 "       fake-adb [-P PORT] nodaemon server\n");
+        return 1;
+    }
+
+    const QString command = arguments.first();
+    bool recording = !Scenario::recordPath().isEmpty();
+
+    if (command == "version") {
+        writeOut("Android Debug Bridge version 1.0.41\nVersion fake-adb (scrcpy-gui)\n");
+        return 0;
+    }
+    if (command == "start-server" || command == "kill-server") {
+        return 0;
+    }
+
+    if (command == "nodaemon" && arguments.value(1) == "server") {
+        if (recording) {
+            writeErr("fake-adb: recording goes through the adb command line, not the server\n");
+            return 1;
+        }
+        return runServer(app, port);
+    }
+
+    if (recording) {
+        Recording result;
+        if (command == "shell" && arguments.value(1) == "sh" && arguments.size() == 2) {
+            return recordShell(serial, result);
+        }
+
+        QByteArray output;
+        int elapsedMs = 0;
+        int exitCode = runReal(serial, arguments, &output, &elapsedMs);
+        if (command == "devices") {
+            result.devices = output;
+        } else if (command == "shell" || command == "exec-out") {
+            Scenario::Reply reply;
+            reply.output = output;
+            reply.exitCode = exitCode;
+            reply.delayMs = elapsedMs;
+            result.commands.append(arguments.mid(1).join(' ').toUtf8());
+            result.replies.append(reply);
+        }
+        saveRecording(result);
+        writeOut(output);
+        return exitCode;
+    }
+
+    Scenario scenario;
+    QString error;
+    if (!scenario.load(Scenario::scenarioPath(), &error)) {
+        writeErr("fake-adb: " + Scenario::scenarioPath().toLocal8Bit() + ": " + error.toLocal8Bit() + "\n");
+        return 1;
+    }
+
+    if (command == "devices") {
+        writeOut(scenario.devicesOutput(arguments.contains("-l")));
+        return 0;
+    }
+
+    if (command != "shell" && command != "exec-out") {
+        writeErr("adb: unknown command " + command.toLocal8Bit() + "\n");
+        return 1;
+    }
+
+    QString device = scenario.resolveSerial(serial);
+    if (device.isEmpty()) {
+        writeErr("adb: " + scenario.transportError(serial) + "\n");
+        return 1;
+    }
+    // Each command line counts its own runs, so commands running side by
+    // side don't shift each other's rolls
+    scenario.seed(device + ' ' + arguments.join(' '));
+
+    if (command == "shell" && arguments.value(1) == "sh" && arguments.size() == 2) {
+        return replayShell(scenario, device);
+    }
+
+    Scenario::Reply reply = scenario.reply(device, arguments.mid(1).join(' ').toUtf8());
+    QThread::msleep(ulong(reply.delayMs));
+    if (reply.disconnect) {
+        writeErr("error: closed\n");
+        return 1;
+    }
+    writeOut(reply.output);
+    return reply.exitCode;
+}
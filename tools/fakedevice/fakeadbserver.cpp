@@ -0,0 +1,183 @@
+#include "fakeadbserver.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QList>
+
+namespace {
+
+QByteArray framed(const QByteArray &payload)
+{
+    return QByteArray::number(payload.size(), 16).rightJustified(4, '0') + payload;
+}
+
+// One client connection, owned by its socket
+class Connection : public QObject
+{
+public:
+    Connection(QTcpSocket *socket, Scenario *scenario)
+        : QObject(socket)
+        , socket(socket)
+        , scenario(scenario)
+        , phase(Requests)
+        , busy(false)
+    {
+        connect(socket, &QTcpSocket::readyRead, this, [this]() { onReadyRead(); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+private:
+    enum Phase {
+        Requests,       // reading 4-hex-digit framed requests
+        Service,        // one-shot shell:/exec: answered, closing
+        Shell           // interactive shell, marker protocol
+    };
+
+    void onReadyRead()
+    {
+        buffer += socket->readAll();
+        while (phase == Requests && buffer.size() >= 4) {
+            bool ok;
+            int length = buffer.left(4).toInt(&ok, 16);
+            if (!ok) {
+                fail("invalid request length");
+                return;
+            }
+            if (buffer.size() < 4 + length) {
+                return;
+            }
+            QByteArray request = buffer.mid(4, length);
+            buffer.remove(0, 4 + length);
+            handle(request);
+        }
+        if (phase == Shell) {
+            Scenario::ShellCommand command;
+            while (Scenario::takeShellCommand(buffer, &command)) {
+                queue.append(command);
+            }
+            if (!busy) {
+                runNext();
+            }
+        }
+    }
+
+    void handle(const QByteArray &request)
+    {
+        if (request == "host:version") {
+            // adb 1.0.41
+            socket->write("OKAY" + framed("0029"));
+            socket->disconnectFromHost();
+            phase = Service;
+        } else if (request == "host:devices" || request == "host:devices-l") {
+            socket->write("OKAY" + framed(scenario->devicesOutput(request.endsWith("-l"))));
+            socket->disconnectFromHost();
+            phase = Service;
+        } else if (request == "host:transport-any" || request.startsWith("host:transport:")) {
+            QString wanted = request.startsWith("host:transport:") ? QString::fromUtf8(request.mid(15)) : QString();
+            QString device = scenario->resolveSerial(wanted);
+            if (device.isEmpty()) {
+                fail(scenario->transportError(wanted));
+                return;
+            }
+            serial = device;
+            socket->write("OKAY");
+        } else if (!serial.isEmpty() && (request.startsWith("shell:") || request.startsWith("exec:"))) {
+            QByteArray command = request.mid(request.indexOf(':') + 1);
+            socket->write("OKAY");
+            if (command.isEmpty() || command == "sh") {
+                phase = Shell;
+                return;
+            }
+            phase = Service;
+            // The plain shell: protocol has no exit status, only output
+            Scenario::Reply reply = scenario->reply(serial, command);
+            QTimer::singleShot(reply.delayMs, this, [this, reply]() {
+                if (reply.disconnect) {
+                    socket->abort();
+                    socket->deleteLater();
+                    return;
+                }
+                socket->write(reply.output);
+                socket->disconnectFromHost();
+            });
+        } else {
+            fail("unknown host service");
+        }
+    }
+
+    void runNext()
+    {
+        if (queue.isEmpty()) {
+            busy = false;
+            return;
+        }
+        busy = true;
+        Scenario::ShellCommand command = queue.takeFirst();
+        Scenario::Reply reply = scenario->reply(serial, command.command);
+        QTimer::singleShot(reply.delayMs, this, [this, command, reply]() {
+            if (reply.disconnect) {
+                socket->abort();
+                socket->deleteLater();
+                return;
+            }
+            socket->write(reply.output + "\n" + command.marker + " " + command.id + " "
+                          + QByteArray::number(reply.exitCode) + "\n");
+            runNext();
+        });
+    }
+
+    void fail(const QByteArray &message)
+    {
+        socket->write("FAIL" + framed(message));
+        socket->disconnectFromHost();
+        phase = Service;
+    }
+
+    QTcpSocket *socket;
+    Scenario *scenario;
+    Phase phase;
+    QString serial;
+    QByteArray buffer;
+    QList<Scenario::ShellCommand> queue;
+    bool busy;
+};
+
+} // namespace
+
+FakeAdbServer::FakeAdbServer(const Scenario &scenario, QObject *parent)
+    : QObject(parent)
+    , server(new QTcpServer(this))
+    , scenario(scenario)
+    , connections(0)
+{
+    connect(server, &QTcpServer::newConnection, this, &FakeAdbServer::onNewConnection);
+}
+
+bool FakeAdbServer::listen(quint16 port)
+{
+    return server->listen(QHostAddress::LocalHost, port);
+}
+
+quint16 FakeAdbServer::port() const
+{
+    return server->serverPort();
+}
+
+QString FakeAdbServer::errorString() const
+{
+    return server->errorString();
+}
+
+int FakeAdbServer::connectionCount() const
+{
+    return connections;
+}
+
+void FakeAdbServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        ++connections;
+        new Connection(socket, &scenario);
+    }
+}
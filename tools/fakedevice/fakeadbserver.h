@@ -0,0 +1,42 @@
+#ifndef FAKEADBSERVER_H
+#define FAKEADBSERVER_H
+
+#include <QObject>
+#include <QString>
+#include "scenario.h"
+
+class QTcpServer;
+
+// Answers the adb server's smart-socket protocol from a Scenario, so
+// AdbClient's socket path runs without a device or a real adb.
+//
+// Host services: host:version, host:devices, host:devices-l,
+// host:transport:<serial> and host:transport-any, each answered by OKAY or
+// FAIL<len><message>. After a transport, shell:<cmd> and exec:<cmd> answer
+// OKAY, then write the reply's output after its latency and close. "shell:"
+// and "shell:sh" stay open and answer AdbShellSession's marker protocol, one
+// command at a time. Anything else is FAIL.
+class FakeAdbServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeAdbServer(const Scenario &scenario, QObject *parent = nullptr);
+
+    // Port 0 picks a free one
+    bool listen(quint16 port = 0);
+    quint16 port() const;
+    QString errorString() const;
+
+    // Connections accepted so far
+    int connectionCount() const;
+
+private:
+    void onNewConnection();
+
+    QTcpServer *server;
+    Scenario scenario;
+    int connections;
+};
+
+#endif // FAKEADBSERVER_H
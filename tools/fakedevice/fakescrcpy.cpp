@@ -0,0 +1,181 @@
+// fake-scrcpy: prints what scrcpy prints for a Scenario without opening a
+// window, or records the output of the real scrcpy.
+//
+// Understands --serial/-s, --start-app, --print-fps and --max-fps; every
+// other option is accepted and ignored.
+
+#include "scenario.h"
+#include <QCoreApplication>
+#include <QProcess>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <cstdio>
+#ifdef Q_OS_UNIX
+#include <csignal>
+#endif
+
+namespace {
+
+volatile std::sig_atomic_t terminateRequested = 0;
+
+struct Options {
+    QString serial;
+    QString packageName;
+    bool printFps = false;
+    int maxFps = 0;
+};
+
+Options parseOptions(const QStringList &arguments)
+{
+    Options options;
+    for (int i = 0; i < arguments.size(); ++i) {
+        const QString &argument = arguments.at(i);
+        if ((argument == "--serial" || argument == "-s") && i + 1 < arguments.size()) {
+            options.serial = arguments.at(++i);
+        } else if (argument.startsWith("--serial=")) {
+            options.serial = argument.mid(9);
+        } else if (argument.startsWith("--start-app=")) {
+            options.packageName = argument.mid(12);
+        } else if (argument == "--print-fps") {
+            options.printFps = true;
+        } else if (argument == "--max-fps" && i + 1 < arguments.size()) {
+            options.maxFps = arguments.at(++i).toInt();
+        }
+    }
+    return options;
+}
+
+void writeLine(bool toStderr, const QByteArray &text)
+{
+    FILE *stream = toStderr ? stderr : stdout;
+    std::fwrite(text.constData(), 1, size_t(text.size()), stream);
+    std::fputc('\n', stream);
+    std::fflush(stream);
+}
+
+int replay(QCoreApplication &app, const Options &options)
+{
+    Scenario scenario;
+    QString error;
+    if (!scenario.load(Scenario::scenarioPath(), &error)) {
+        writeLine(true, "fake-scrcpy: " + Scenario::scenarioPath().toLocal8Bit() + ": " + error.toLocal8Bit());
+        return 1;
+    }
+
+    QString serial = scenario.resolveSerial(options.serial);
+    if (serial.isEmpty()) {
+        writeLine(true, options.serial.isEmpty() ? QByteArray("ERROR: Could not find any ADB device")
+                                                 : "ERROR: Could not find ADB device " + options.serial.toLocal8Bit());
+        return 1;
+    }
+    scenario.seed(serial + options.packageName);
+    if (scenario.scrcpyFails()) {
+        writeLine(true, "ERROR: Server connection failed");
+        return 1;
+    }
+
+    Scenario::ScrcpyRun run = scenario.scrcpyRun(serial, options.packageName, options.printFps);
+    qint64 lastLineMs = 0;
+    for (const Scenario::ScrcpyLine &line : std::as_const(run.lines)) {
+        QTimer::singleShot(int(line.atMs), &app, [line]() { writeLine(line.toStderr, line.text); });
+        lastLineMs = qMax(lastLineMs, line.atMs);
+    }
+
+    QTimer fpsTimer;
+    int fps = options.maxFps > 0 ? qMin(run.fps, options.maxFps) : run.fps;
+    if (run.printFps) {
+        QObject::connect(&fpsTimer, &QTimer::timeout, &app, [&run, fps]() {
+            int skipped = fps * run.skipPercent / 100;
+            QByteArray text = "INFO: " + QByteArray::number(fps - skipped) + " fps";
+            if (skipped > 0) {
+                text += " (+" + QByteArray::number(skipped) + " frames skipped)";
+            }
+            writeLine(true, text);
+        });
+        QTimer::singleShot(int(lastLineMs), &app, [&fpsTimer]() { fpsTimer.start(1000); });
+    }
+
+    if (run.exitAtMs > 0) {
+        int exitCode = run.exitCode;
+        QTimer::singleShot(int(run.exitAtMs), &app, [exitCode]() { QCoreApplication::exit(exitCode); });
+    }
+    return app.exec();
+}
+
+int record(QCoreApplication &app, const QStringList &arguments)
+{
+    QString program = qEnvironmentVariable("SCRCPY_GUI_REAL_SCRCPY");
+    if (program.isEmpty()) {
+        program = "scrcpy";
+    }
+
+    QElapsedTimer clock;
+    QList<Scenario::ScrcpyLine> lines;
+    QByteArray pending[2];
+
+    QProcess process;
+    auto forward = [&](bool toStderr) {
+        QByteArray &buffer = pending[toStderr ? 1 : 0];
+        buffer += toStderr ? process.readAllStandardError() : process.readAllStandardOutput();
+        int newline;
+        while ((newline = buffer.indexOf('\n')) >= 0) {
+            QByteArray text = buffer.left(newline);
+            if (text.endsWith('\r')) {
+                text.chop(1);
+            }
+            buffer.remove(0, newline + 1);
+            writeLine(toStderr, text);
+            lines.append({ clock.elapsed(), toStderr, text });
+        }
+    };
+    QObject::connect(&process, &QProcess::readyReadStandardOutput, &app, [&]() { forward(false); });
+    QObject::connect(&process, &QProcess::readyReadStandardError, &app, [&]() { forward(true); });
+    QObject::connect(&process, &QProcess::finished, &app, [&](int exitCode) {
+        forward(false);
+        forward(true);
+
+        qint64 exitAtMs = clock.elapsed();
+        bool saved = Scenario::updateRecording([&lines, exitCode, exitAtMs](Scenario &scenario) {
+            scenario.recordScrcpy(lines, exitCode, exitAtMs);
+        });
+        if (!saved) {
+            writeLine(true, "fake-scrcpy: cannot write " + Scenario::recordPath().toLocal8Bit());
+        }
+        QCoreApplication::exit(exitCode);
+    });
+
+    // Stopping a session terminates us; pass that on so the run is recorded
+    QTimer signalPoll;
+    QObject::connect(&signalPoll, &QTimer::timeout, &app, [&process]() {
+        if (terminateRequested) {
+            terminateRequested = 0;
+            process.terminate();
+        }
+    });
+#ifdef Q_OS_UNIX
+    std::signal(SIGTERM, [](int) { terminateRequested = 1; });
+    std::signal(SIGINT, [](int) { terminateRequested = 1; });
+#endif
+    signalPoll.start(100);
+
+    clock.start();
+    process.start(program, arguments);
+    if (!process.waitForStarted(-1)) {
+        writeLine(true, "fake-scrcpy: cannot run " + program.toLocal8Bit());
+        return 1;
+    }
+    return app.exec();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments().mid(1);
+
+    if (!Scenario::recordPath().isEmpty()) {
+        return record(app, arguments);
+    }
+    return replay(app, parseOptions(arguments));
+}
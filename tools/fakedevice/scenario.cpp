@@ -0,0 +1,450 @@
+#include "scenario.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QLockFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QHash>
+
+namespace {
+
+QJsonObject defaults()
+{
+    return QJsonObject {
+        { "seed", 1 },
+        { "devices", 1 },
+        { "packages", 200 },
+        { "running", 12 },
+        { "processes", 300 },
+        { "latencyMs", 20 },
+        { "jitterMs", 10 },
+        { "failureRate", 0.0 },
+        { "responses", QJsonArray {
+            QJsonObject { { "match", "pm list packages" }, { "generator", "packages" } },
+            QJsonObject { { "match", "ps -A" }, { "generator", "running" } },
+            // APKs without a launcher bitmap (IconLoader::NO_ICON_EXIT)
+            QJsonObject { { "match", "pm path" }, { "exitCode", 3 } }
+        } },
+        { "scrcpy", QJsonObject {
+            { "startupMs", 600 },
+            { "fps", 60 },
+            { "skipPercent", 0 },
+            { "failureRate", 0.0 },
+            { "exitCode", 0 },
+            { "runMs", 0 },
+            { "lines", QJsonArray() }
+        } }
+    };
+}
+
+QString packageName(int index)
+{
+    return QString("com.fake.app%1").arg(index, 5, 10, QChar('0'));
+}
+
+} // namespace
+
+Scenario::Scenario()
+    : root(defaults())
+    , random(1)
+{
+}
+
+QString Scenario::scenarioPath()
+{
+    return qEnvironmentVariable("SCRCPY_GUI_FAKE_SCENARIO");
+}
+
+QString Scenario::recordPath()
+{
+    return qEnvironmentVariable("SCRCPY_GUI_FAKE_RECORD");
+}
+
+bool Scenario::load(const QString &path, QString *error)
+{
+    if (path.isEmpty() || !QFile::exists(path)) {
+        return true;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) {
+            *error = parseError.errorString();
+        }
+        return false;
+    }
+
+    // Keys in the file replace the defaults one by one
+    const QJsonObject overrides = doc.object();
+    for (auto it = overrides.begin(); it != overrides.end(); ++it) {
+        if (it.key() == "scrcpy") {
+            QJsonObject scrcpy = root["scrcpy"].toObject();
+            const QJsonObject given = it.value().toObject();
+            for (auto field = given.begin(); field != given.end(); ++field) {
+                scrcpy[field.key()] = field.value();
+            }
+            root["scrcpy"] = scrcpy;
+        } else {
+            root[it.key()] = it.value();
+        }
+    }
+
+    // outputFile entries are relative to the scenario
+    QDir dir = QFileInfo(path).absoluteDir();
+    QJsonArray responses = root["responses"].toArray();
+    for (int i = 0; i < responses.size(); ++i) {
+        QJsonObject response = responses.at(i).toObject();
+        if (response.contains("outputFile")) {
+            QFile output(dir.filePath(response["outputFile"].toString()));
+            if (output.open(QIODevice::ReadOnly)) {
+                response["output"] = QString::fromUtf8(output.readAll());
+            }
+            response.remove("outputFile");
+            responses[i] = response;
+        }
+    }
+    root["responses"] = responses;
+    return true;
+}
+
+bool Scenario::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
+
+bool Scenario::updateRecording(const std::function<void(Scenario &)> &update)
+{
+    QLockFile lock(recordPath() + ".lock");
+    if (!lock.lock()) {
+        return false;
+    }
+    Scenario scenario;
+    scenario.load(recordPath());
+    update(scenario);
+    return scenario.save(recordPath());
+}
+
+void Scenario::seed(const QString &salt)
+{
+    size_t run = size_t(nextRun(salt));
+    random.seed(quint32(root["seed"].toInt()) ^ quint32(qHash(salt, run)));
+}
+
+QString Scenario::runsPath()
+{
+    QString name = scenarioPath().isEmpty() ? QString("default") : QFileInfo(scenarioPath()).completeBaseName();
+    return QDir::tempPath() + "/scrcpy-gui-fake-" + name + ".runs";
+}
+
+// Per-salt counters shared by every stand-in process of this scenario
+int Scenario::nextRun(const QString &salt)
+{
+    bool pinned = false;
+    int run = qEnvironmentVariableIntValue("SCRCPY_GUI_FAKE_RUN", &pinned);
+    if (pinned) {
+        return run;
+    }
+
+    QLockFile lock(runsPath() + ".lock");
+    if (!lock.lock()) {
+        return 0;
+    }
+    QJsonObject runs;
+    QFile in(runsPath());
+    if (in.open(QIODevice::ReadOnly)) {
+        runs = QJsonDocument::fromJson(in.readAll()).object();
+        in.close();
+    }
+    run = runs[salt].toInt();
+    runs[salt] = run + 1;
+
+    QSaveFile out(runsPath());
+    if (out.open(QIODevice::WriteOnly)) {
+        out.write(QJsonDocument(runs).toJson(QJsonDocument::Compact));
+        out.commit();
+    }
+    return run;
+}
+
+QStringList Scenario::serials() const
+{
+    QStringList result;
+    if (root.contains("devicesOutput")) {
+        const QStringList lines = root["devicesOutput"].toString().split('\n', Qt::SkipEmptyParts);
+        for (const QString &line : lines) {
+            if (!line.startsWith("List of devices") && !line.startsWith('*')) {
+                result << line.simplified().section(' ', 0, 0);
+            }
+        }
+        return result;
+    }
+
+    QJsonValue devices = root["devices"];
+    if (devices.isArray()) {
+        for (const QJsonValue &device : devices.toArray()) {
+            result << device.toObject()["serial"].toString();
+        }
+    } else {
+        for (int i = 1; i <= devices.toInt(); ++i) {
+            result << QString("fake-%1").arg(i, 4, 10, QChar('0'));
+        }
+    }
+    return result;
+}
+
+bool Scenario::hasDevice(const QString &serial) const
+{
+    return serials().contains(serial);
+}
+
+QString Scenario::resolveSerial(const QString &serial) const
+{
+    if (!serial.isEmpty()) {
+        return hasDevice(serial) ? serial : QString();
+    }
+    QStringList all = serials();
+    return all.size() == 1 ? all.first() : QString();
+}
+
+QByteArray Scenario::devicesOutput(bool longFormat) const
+{
+    if (root.contains("devicesOutput")) {
+        return root["devicesOutput"].toString().toUtf8();
+    }
+
+    QByteArray out = "List of devices attached\n";
+    const QStringList all = serials();
+    for (int i = 0; i < all.size(); ++i) {
+        out += all.at(i).toUtf8();
+        if (longFormat) {
+            out += "          device product:fake_p model:Fake_Pixel_" + QByteArray::number(i + 1)
+                   + " device:fake transport_id:" + QByteArray::number(i + 1) + "\n";
+        } else {
+            out += "\tdevice\n";
+        }
+    }
+    return out + "\n";
+}
+
+QByteArray Scenario::transportError(const QString &serial) const
+{
+    if (!serial.isEmpty()) {
+        return "device '" + serial.toUtf8() + "' not found";
+    }
+    return serials().isEmpty() ? QByteArray("no devices/emulators found")
+                               : QByteArray("more than one device/emulator");
+}
+
+bool Scenario::takeShellCommand(QByteArray &buffer, ShellCommand *result)
+{
+    static const QByteArray trailer = "} </dev/null 2>&1; printf '\\n";
+    int start = buffer.startsWith(trailer) ? 0 : buffer.indexOf("\n" + trailer);
+    if (start < 0) {
+        return false;
+    }
+    int restStart = start == 0 ? trailer.size() : start + 1 + trailer.size();
+    int lineEnd = buffer.indexOf('\n', restStart);
+    if (lineEnd < 0) {
+        return false;
+    }
+
+    QByteArray rest = buffer.mid(restStart, lineEnd - restStart).trimmed();
+    result->marker = rest.left(rest.indexOf(' '));
+    int idStart = rest.indexOf("' ") + 2;
+    result->id = rest.mid(idStart, rest.indexOf(' ', idStart) - idStart);
+    QByteArray command = buffer.left(start);
+    result->command = command.startsWith("{ ") ? command.mid(2) : command;
+    buffer.remove(0, lineEnd + 1);
+    return true;
+}
+
+int Scenario::delay(int latencyMs, int jitterMs)
+{
+    int jitter = jitterMs > 0 ? int(random.bounded(2 * jitterMs + 1)) - jitterMs : 0;
+    return qMax(0, latencyMs + jitter);
+}
+
+bool Scenario::roll(double rate)
+{
+    return rate > 0 && random.generateDouble() < rate;
+}
+
+Scenario::Reply Scenario::reply(const QString &serial, const QByteArray &command)
+{
+    Reply result;
+    const QJsonArray responses = root["responses"].toArray();
+    for (const QJsonValue &value : responses) {
+        QJsonObject response = value.toObject();
+        if (!command.contains(response["match"].toString().toUtf8())) {
+            continue;
+        }
+
+        result.delayMs = delay(response["latencyMs"].toInt(root["latencyMs"].toInt()),
+                               response["jitterMs"].toInt(root["jitterMs"].toInt()));
+        if (roll(response["failureRate"].toDouble(root["failureRate"].toDouble()))) {
+            if (response["failure"].toString() == "disconnect") {
+                result.disconnect = true;
+            } else {
+                result.output = "Error: injected failure\n";
+                result.exitCode = 1;
+            }
+            return result;
+        }
+
+        QByteArray output = response.contains("generator")
+            ? generate(response["generator"].toString(), serial, command)
+            : response["output"].toString().toUtf8();
+        result.output = output.repeated(qMax(1, response["repeat"].toInt(1)));
+        result.exitCode = response["exitCode"].toInt(0);
+        return result;
+    }
+
+    result.delayMs = delay(root["latencyMs"].toInt(), root["jitterMs"].toInt());
+    result.output = "/system/bin/sh: " + command.left(command.indexOf(' ')) + ": inaccessible or not found\n";
+    result.exitCode = 127;
+    return result;
+}
+
+QByteArray Scenario::generate(const QString &generator, const QString &serial, const QByteArray &command) const
+{
+    QByteArray out;
+    int packages = root["packages"].toInt();
+
+    if (generator == "packages") {
+        // AppManager asks for these in the same command
+        if (command.contains("echo serial:")) {
+            out += "serial:" + serial.toUtf8() + "\n";
+        }
+        if (command.contains("echo fingerprint:")) {
+            out += "fingerprint:fake/fake_p/fake:14/UP1A.231005.007/1:user/release-keys\n";
+        }
+        bool versions = command.contains("--show-versioncode");
+        out.reserve(out.size() + packages * 40);
+        for (int i = 0; i < packages; ++i) {
+            out += "package:" + packageName(i).toUtf8();
+            if (versions) {
+                out += " versionCode:" + QByteArray::number(1000 + i);
+            }
+            out += '\n';
+        }
+    } else if (generator == "running") {
+        int running = qMin(root["running"].toInt(), packages);
+        int processes = qMax(root["processes"].toInt(), running);
+        out += "NAME\n";
+        for (int i = 0; i < running; ++i) {
+            // Spread over the list so filters see scattered rows
+            out += packageName(packages > 0 ? (i * 7919) % packages : i).toUtf8() + "\n";
+        }
+        for (int i = running; i < processes; ++i) {
+            if (i % 2) {
+                out += "[kworker/" + QByteArray::number(i % 8) + ":" + QByteArray::number(i) + "]\n";
+            } else {
+                out += "/system/bin/fake_daemon" + QByteArray::number(i) + "\n";
+            }
+        }
+    }
+    return out;
+}
+
+bool Scenario::scrcpyFails()
+{
+    return roll(root["scrcpy"].toObject()["failureRate"].toDouble());
+}
+
+Scenario::ScrcpyRun Scenario::scrcpyRun(const QString &serial, const QString &packageName, bool printFps)
+{
+    QJsonObject scrcpy = root["scrcpy"].toObject();
+    ScrcpyRun run;
+    run.exitCode = scrcpy["exitCode"].toInt();
+    run.exitAtMs = scrcpy["runMs"].toInteger();
+    run.fps = scrcpy["fps"].toInt(60);
+    run.skipPercent = scrcpy["skipPercent"].toInt();
+    run.printFps = printFps;
+
+    const QJsonArray recorded = scrcpy["lines"].toArray();
+    if (!recorded.isEmpty()) {
+        for (const QJsonValue &value : recorded) {
+            QJsonObject line = value.toObject();
+            run.lines.append({ line["atMs"].toInteger(), line["stream"].toString() != "stdout",
+                               line["text"].toString().toUtf8() });
+        }
+        // Recorded output already has its FPS lines
+        run.printFps = false;
+        return run;
+    }
+
+    // What scrcpy 2.x prints on a good start, spread over startupMs
+    qint64 startup = delay(scrcpy["startupMs"].toInt(600), scrcpy["startupMs"].toInt(600) / 5);
+    QByteArray device = serial.toUtf8();
+    run.lines = {
+        { 0, false, "scrcpy 2.4 <https://github.com/Genymobile/scrcpy>" },
+        { startup * 3 / 10, true, "INFO: ADB device found:" },
+        { startup * 3 / 10, true, "INFO:     -->   (usb)  " + device + "  device  Fake_Pixel" },
+        { startup * 4 / 10, false, "/usr/share/scrcpy/scrcpy-server: 1 file pushed, 0 skipped. 48.7 MB/s (71200 bytes in 0.001s)" },
+        { startup * 6 / 10, true, "[server] INFO: Device: [Fake] Fake Pixel (Android 14)" }
+    };
+    if (!packageName.isEmpty()) {
+        run.lines.append({ startup * 7 / 10, true, "[server] INFO: New display: 1080x2400/420 (id=5)" });
+    }
+    run.lines.append({ startup * 8 / 10, true, "INFO: Renderer: opengl" });
+    run.lines.append({ startup, true, "INFO: Texture: 1080x2400" });
+    return run;
+}
+
+void Scenario::recordResponse(const QByteArray &command, const QByteArray &output, int exitCode, int latencyMs)
+{
+    // Recorded commands are matched in full and win over the defaults
+    QJsonArray responses = root["responses"].toArray();
+    QString match = QString::fromUtf8(command);
+    for (int i = responses.size() - 1; i >= 0; --i) {
+        if (responses.at(i).toObject()["match"].toString() == match) {
+            responses.removeAt(i);
+        }
+    }
+    responses.prepend(QJsonObject {
+        { "match", match },
+        { "output", QString::fromUtf8(output) },
+        { "exitCode", exitCode },
+        { "latencyMs", latencyMs },
+        { "jitterMs", 0 }
+    });
+    root["responses"] = responses;
+}
+
+void Scenario::recordDevices(const QByteArray &output)
+{
+    root["devicesOutput"] = QString::fromUtf8(output);
+}
+
+void Scenario::recordScrcpy(const QList<ScrcpyLine> &lines, int exitCode, qint64 exitAtMs)
+{
+    QJsonArray array;
+    for (const ScrcpyLine &line : lines) {
+        array.append(QJsonObject {
+            { "atMs", line.atMs },
+            { "stream", line.toStderr ? "stderr" : "stdout" },
+            { "text", QString::fromUtf8(line.text) }
+        });
+    }
+    QJsonObject scrcpy = root["scrcpy"].toObject();
+    scrcpy["lines"] = array;
+    scrcpy["exitCode"] = exitCode;
+    scrcpy["runMs"] = exitAtMs;
+    root["scrcpy"] = scrcpy;
+}
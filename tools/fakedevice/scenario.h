@@ -0,0 +1,107 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <functional>
+
+// What fake-adb and fake-scrcpy answer, loaded from the JSON file named by
+// SCRCPY_GUI_FAKE_SCENARIO (built-in defaults without one).
+//
+// Device-side commands are matched against "responses" in order by
+// substring. A response carries literal output or names a generator
+// ("packages", "running") that synthesizes output at the scenario's scale,
+// plus its own latency, jitter and failure rate. The "scrcpy" section is
+// either recorded lines replayed on their original schedule or, if empty, a
+// synthesized start-up sequence followed by FPS reports.
+//
+// With SCRCPY_GUI_FAKE_RECORD set, the stand-ins run the real tool instead
+// and add what they saw to the scenario file at that path.
+class Scenario
+{
+public:
+    struct Reply {
+        QByteArray output;
+        int exitCode = 0;
+        int delayMs = 0;
+        bool disconnect = false;  // drop the connection instead of answering
+    };
+
+    // One block written by AdbShellSession:
+    //   { CMD
+    //   } </dev/null 2>&1; printf '\nMARKER %d %d\n' ID $?
+    struct ShellCommand {
+        QByteArray command;
+        QByteArray marker;
+        QByteArray id;
+    };
+
+    struct ScrcpyLine {
+        qint64 atMs = 0;
+        bool toStderr = true;
+        QByteArray text;
+    };
+
+    struct ScrcpyRun {
+        QList<ScrcpyLine> lines;
+        int exitCode = 0;
+        qint64 exitAtMs = 0;      // 0 = run until terminated
+        int fps = 60;
+        int skipPercent = 0;      // frames reported as skipped
+        bool printFps = false;
+    };
+
+    Scenario();
+
+    static QString scenarioPath();
+    static QString recordPath();
+
+    // A missing file is not an error; the defaults stay in place
+    bool load(const QString &path, QString *error = nullptr);
+    bool save(const QString &path) const;
+
+    QStringList serials() const;
+    bool hasDevice(const QString &serial) const;
+    // An empty serial means the only device, as with real adb
+    QString resolveSerial(const QString &serial) const;
+    QByteArray devicesOutput(bool longFormat) const;
+    // adb's message when resolveSerial(serial) finds nothing
+    QByteArray transportError(const QString &serial) const;
+
+    Reply reply(const QString &serial, const QByteArray &command);
+
+    ScrcpyRun scrcpyRun(const QString &serial, const QString &packageName, bool printFps);
+    bool scrcpyFails();
+
+    // Record mode. update() runs on the scenario at recordPath() under a
+    // lock file, so stand-ins running side by side keep each other's results
+    static bool updateRecording(const std::function<void(Scenario &)> &update);
+    void recordResponse(const QByteArray &command, const QByteArray &output, int exitCode, int latencyMs);
+    void recordDevices(const QByteArray &output);
+    void recordScrcpy(const QList<ScrcpyLine> &lines, int exitCode, qint64 exitAtMs);
+
+    // Seeds from "seed", the salt and how often this salt was seeded before,
+    // so each run of the same command or launch rolls its own failures and
+    // the sequence repeats from a fresh runs file. SCRCPY_GUI_FAKE_RUN pins
+    // the run number instead.
+    void seed(const QString &salt);
+    static QString runsPath();
+
+    // Removes the first complete block from buffer; false if there is none yet
+    static bool takeShellCommand(QByteArray &buffer, ShellCommand *result);
+
+private:
+    static int nextRun(const QString &salt);
+    int delay(int latencyMs, int jitterMs);
+    bool roll(double rate);
+    QByteArray generate(const QString &generator, const QString &serial, const QByteArray &command) const;
+
+    QJsonObject root;
+    QRandomGenerator random;
+};
+
+#endif // SCENARIO_H